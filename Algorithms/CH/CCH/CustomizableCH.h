@@ -0,0 +1,449 @@
+#pragma once
+
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <string>
+
+#include "../CH.h"
+
+#include "../../../Helpers/Types.h"
+#include "../../../Helpers/MultiThreading.h"
+#include "../../../Helpers/Vector/Permutation.h"
+
+#include "../../../DataStructures/Container/ExternalKHeap.h"
+#include "../../../DataStructures/Graph/Graph.h"
+
+namespace CH {
+
+// Customizable CH (CCH). The topology only depends on the graph and a metric-independent vertex order, e.g., from
+// NestedDissection: Contracting the vertices in order without witness searches yields a chordal supergraph, whose
+// arcs lead from lower to higher ranks. A customization computes the weights of these arcs for an edge weight vector
+// of the original graph. Every arc (v, w) with v < w is processed by v, pulling all lower triangles (u, v, w); since
+// all lower neighbors of v have a smaller level, the vertices of one level are customized in parallel.
+// Afterwards, a perfect customization processes the vertices top-down and computes the distance between the endpoints
+// of every arc from its upper and intermediate triangles. Arcs whose distance is shorter than their weight are not
+// needed by any shortest path and are omitted from the resulting CH.
+// Only the first numberOfContractedVertices vertices of the order are contracted. The remaining ones form a core: The
+// arcs between core vertices are customized only with triangles through contracted vertices, so they represent the
+// shortest paths through contracted vertices, like the core of a core-CH. Since the core is a clique of the chordal
+// fill-in, its arcs are pruned by witness searches within the core before the perfect customization, which then also
+// uses the resulting core distances.
+class CustomizableCH {
+
+public:
+    using Arc = uint32_t;
+    inline static constexpr Arc noArc = -1;
+
+private:
+    // Paths of equal length are ordered by their kind: A witness has at least two arcs of positive weight, so it may
+    // replace an arc of the same length. Otherwise, every arc of a witness is shorter than the arc it replaces, which
+    // rules out cyclic replacements.
+    enum PathKind : uint8_t {
+        Witness,
+        DirectArc,
+        ZeroWeightArc,
+    };
+
+    struct CoreLabel : public ExternalKHeapElement {
+        CoreLabel() : ExternalKHeapElement(), distance(INFTY), kind(ZeroWeightArc), timeStamp(0) {}
+        inline bool hasSmallerKey(const CoreLabel* other) const noexcept {
+            return (distance < other->distance) || ((distance == other->distance) && (kind < other->kind));
+        }
+
+        int distance;
+        PathKind kind;
+        int timeStamp;
+    };
+
+    // Dijkstra state of the witness searches within the core, indexed by rank - numberOfContractedVertices.
+    struct CoreSearch {
+        CoreSearch(const size_t numberOfCoreVertices) :
+            Q(numberOfCoreVertices),
+            label(numberOfCoreVertices),
+            timeStamp(0) {
+        }
+        CoreSearch(const CoreSearch& other) :
+            CoreSearch(other.label.size()) {
+        }
+
+        inline void clear() noexcept {
+            Q.clear();
+            timeStamp++;
+        }
+
+        inline void update(const size_t vertex, const int distance, const PathKind kind) noexcept {
+            CoreLabel& vertexLabel = getLabel(vertex);
+            if ((vertexLabel.distance < distance) || ((vertexLabel.distance == distance) && (vertexLabel.kind <= kind))) return;
+            vertexLabel.distance = distance;
+            vertexLabel.kind = kind;
+            Q.update(&vertexLabel);
+        }
+
+        inline void relax(const CoreLabel* from, const size_t to, const int weight, const bool fromSource) noexcept {
+            const PathKind kind = (weight == 0 || from->kind == ZeroWeightArc) ? ZeroWeightArc : (fromSource ? DirectArc : Witness);
+            update(to, from->distance + weight, kind);
+        }
+
+        // Returns whether the arc to the vertex with the given weight is replaced by a witness.
+        inline bool hasWitness(const size_t vertex, const int weight) const noexcept {
+            if (label[vertex].timeStamp != timeStamp) return false;
+            return (label[vertex].distance < weight) || ((label[vertex].distance == weight) && (label[vertex].kind == Witness));
+        }
+
+        inline CoreLabel& getLabel(const size_t vertex) noexcept {
+            CoreLabel& vertexLabel = label[vertex];
+            if (vertexLabel.timeStamp != timeStamp) {
+                vertexLabel.distance = INFTY;
+                vertexLabel.kind = ZeroWeightArc;
+                vertexLabel.timeStamp = timeStamp;
+            }
+            return vertexLabel;
+        }
+
+        inline size_t getVertex(const CoreLabel* vertexLabel) const noexcept {
+            return vertexLabel - &(label[0]);
+        }
+
+        ExternalKHeap<2, CoreLabel> Q;
+        std::vector<CoreLabel> label;
+        int timeStamp;
+    };
+
+public:
+    template<typename GRAPH>
+    CustomizableCH(const GRAPH& graph, const Order& order, const size_t numberOfContractedVertices) :
+        numberOfContractedVertices(numberOfContractedVertices),
+        vertexOfRank(order),
+        rankOf(Construct::Invert, order),
+        firstArc(graph.numVertices() + 1, 0),
+        firstIncomingArc(graph.numVertices() + 1, 0),
+        arcOfEdge(graph.edgeLimit(), noArc),
+        edgeIsForward(graph.edgeLimit(), false) {
+        AssertMsg(order.size() == graph.numVertices(), "Order has " << order.size() << " entries, but the graph has " << graph.numVertices() << " vertices!");
+        AssertMsg(numberOfContractedVertices <= graph.numVertices(), "Cannot contract " << numberOfContractedVertices << " of " << graph.numVertices() << " vertices!");
+        buildTopology(graph);
+    }
+
+    inline void customize(const std::vector<int>& weight, const ThreadPinning& threadPinning) noexcept {
+        AssertMsg(weight.size() == arcOfEdge.size(), "Weight vector has " << weight.size() << " entries, but the graph has " << arcOfEdge.size() << " edges!");
+        const size_t numberOfThreads = std::max<size_t>(threadPinning.numberOfThreads, 1);
+        std::vector<int>(numberOfArcs(), INFTY).swap(forwardWeight);
+        std::vector<int>(numberOfArcs(), INFTY).swap(backwardWeight);
+        std::vector<Vertex>(numberOfArcs(), noVertex).swap(forwardVia);
+        std::vector<Vertex>(numberOfArcs(), noVertex).swap(backwardVia);
+        for (size_t edge = 0; edge < arcOfEdge.size(); edge++) {
+            const Arc arc = arcOfEdge[edge];
+            if (arc == noArc) continue;
+            int& arcWeight = edgeIsForward[edge] ? forwardWeight[arc] : backwardWeight[arc];
+            arcWeight = std::min(arcWeight, weight[edge]);
+        }
+
+        std::vector<std::vector<Arc>> arcOfHead(numberOfThreads, std::vector<Arc>(numberOfVertices(), noArc));
+        std::vector<CoreSearch> coreSearch(numberOfThreads, CoreSearch(numberOfVertices() - numberOfContractedVertices));
+        std::vector<uint8_t>(numberOfArcs(), false).swap(forwardWitnessed);
+        std::vector<uint8_t>(numberOfArcs(), false).swap(backwardWitnessed);
+        omp_set_num_threads(numberOfThreads);
+        #pragma omp parallel
+        {
+            threadPinning.pinThread();
+            std::vector<Arc>& threadArcOfHead = arcOfHead[omp_get_thread_num()];
+
+            for (size_t level = 0; level < numberOfLevels(); level++) {
+                #pragma omp for schedule(dynamic, 64)
+                for (size_t i = firstVertexOfLevel[level]; i < firstVertexOfLevel[level + 1]; i++) {
+                    customizeVertex(verticesByLevel[i], threadArcOfHead);
+                }
+            }
+
+            #pragma omp single
+            {
+                distanceForward = forwardWeight;
+                distanceBackward = backwardWeight;
+            }
+            #pragma omp for schedule(dynamic, 16)
+            for (size_t rank = numberOfContractedVertices; rank < numberOfVertices(); rank++) {
+                pruneCoreArcs(rank, coreSearch[omp_get_thread_num()]);
+            }
+            for (size_t level = numberOfLevels() - 1; level < numberOfLevels(); level--) {
+                #pragma omp for schedule(dynamic, 64)
+                for (size_t i = firstVertexOfLevel[level]; i < firstVertexOfLevel[level + 1]; i++) {
+                    perfectVertex(verticesByLevel[i], threadArcOfHead);
+                }
+            }
+        }
+    }
+
+    // Returns the customized hierarchy in the format of CHBuilder. Arcs with infinite weight, arcs that are not
+    // needed, and core arcs with a witness are omitted, and the arcs between core vertices are added in both
+    // directions, as by copyCoreToCH.
+    inline CH getCH() const noexcept {
+        CHConstructionGraph forward;
+        CHConstructionGraph backward;
+        forward.addVertices(numberOfVertices());
+        backward.addVertices(numberOfVertices());
+        for (size_t rank = 0; rank < numberOfVertices(); rank++) {
+            const Vertex from(vertexOfRank[rank]);
+            const bool isCore = rank >= numberOfContractedVertices;
+            for (Arc arc = firstArc[rank]; arc < firstArc[rank + 1]; arc++) {
+                const Vertex to(vertexOfRank[arcHead[arc]]);
+                if (isNeeded(forwardWeight[arc], distanceForward[arc]) && !forwardWitnessed[arc]) {
+                    forward.addEdge(from, to).set(ViaVertex, forwardVia[arc]).set(Weight, forwardWeight[arc]);
+                    if (isCore) backward.addEdge(to, from).set(ViaVertex, forwardVia[arc]).set(Weight, forwardWeight[arc]);
+                }
+                if (isNeeded(backwardWeight[arc], distanceBackward[arc]) && !backwardWitnessed[arc]) {
+                    backward.addEdge(from, to).set(ViaVertex, backwardVia[arc]).set(Weight, backwardWeight[arc]);
+                    if (isCore) forward.addEdge(to, from).set(ViaVertex, backwardVia[arc]).set(Weight, backwardWeight[arc]);
+                }
+            }
+        }
+        return CH(std::move(forward), std::move(backward));
+    }
+
+    inline size_t numberOfVertices() const noexcept {
+        return vertexOfRank.size();
+    }
+
+    inline size_t numberOfArcs() const noexcept {
+        return arcHead.size();
+    }
+
+    inline size_t numberOfLevels() const noexcept {
+        return firstVertexOfLevel.size() - 1;
+    }
+
+    inline size_t getNumberOfContractedVertices() const noexcept {
+        return numberOfContractedVertices;
+    }
+
+private:
+    template<typename GRAPH>
+    inline void buildTopology(const GRAPH& graph) noexcept {
+        const size_t n = graph.numVertices();
+        std::vector<std::vector<size_t>> upwardNeighbors(n);
+        for (const auto [edge, from] : graph.edgesWithFromVertex()) {
+            const size_t fromRank = rankOf[from];
+            const size_t toRank = rankOf[graph.get(ToVertex, edge)];
+            if (fromRank == toRank) continue;
+            upwardNeighbors[std::min(fromRank, toRank)].emplace_back(std::max(fromRank, toRank));
+        }
+        for (std::vector<size_t>& neighbors : upwardNeighbors) {
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        }
+        // Contracting a vertex makes its upper neighbors a clique. It suffices to add them to the lowest one, which
+        // passes them on when it is contracted itself. A core vertex is never contracted, so there the clique is
+        // added explicitly.
+        std::vector<size_t> merged;
+        for (size_t rank = 0; rank < numberOfContractedVertices; rank++) {
+            const std::vector<size_t>& neighbors = upwardNeighbors[rank];
+            if (neighbors.size() < 2) continue;
+            if (neighbors[0] < numberOfContractedVertices) {
+                addNeighbors(upwardNeighbors[neighbors[0]], neighbors.begin() + 1, neighbors.end(), merged);
+            } else {
+                for (size_t i = 0; i + 1 < neighbors.size(); i++) {
+                    addNeighbors(upwardNeighbors[neighbors[i]], neighbors.begin() + i + 1, neighbors.end(), merged);
+                }
+            }
+        }
+
+        for (size_t rank = 0; rank < n; rank++) {
+            firstArc[rank + 1] = firstArc[rank] + upwardNeighbors[rank].size();
+            for (const size_t neighbor : upwardNeighbors[rank]) {
+                arcHead.emplace_back(neighbor);
+                firstIncomingArc[neighbor + 1]++;
+            }
+            std::vector<size_t>().swap(upwardNeighbors[rank]);
+        }
+        for (size_t rank = 0; rank < n; rank++) {
+            firstIncomingArc[rank + 1] += firstIncomingArc[rank];
+        }
+        incomingArcs.resize(numberOfArcs());
+        std::vector<Arc> nextIncomingArc(firstIncomingArc.begin(), firstIncomingArc.end() - 1);
+        for (size_t rank = 0; rank < n; rank++) {
+            for (Arc arc = firstArc[rank]; arc < firstArc[rank + 1]; arc++) {
+                incomingArcs[nextIncomingArc[arcHead[arc]]++] = arc;
+            }
+        }
+        arcTail.resize(numberOfArcs());
+        for (size_t rank = 0; rank < n; rank++) {
+            for (Arc arc = firstArc[rank]; arc < firstArc[rank + 1]; arc++) {
+                arcTail[arc] = rank;
+            }
+        }
+
+        for (const auto [edge, from] : graph.edgesWithFromVertex()) {
+            const size_t fromRank = rankOf[from];
+            const size_t toRank = rankOf[graph.get(ToVertex, edge)];
+            if (fromRank == toRank) continue;
+            arcOfEdge[edge] = findArc(std::min(fromRank, toRank), std::max(fromRank, toRank));
+            edgeIsForward[edge] = fromRank < toRank;
+        }
+
+        std::vector<size_t> level(n, 0);
+        size_t maxLevel = 0;
+        for (size_t rank = 0; rank < n; rank++) {
+            for (Arc arc = firstIncomingArc[rank]; arc < firstIncomingArc[rank + 1]; arc++) {
+                const size_t tail = arcTail[incomingArcs[arc]];
+                if (tail >= numberOfContractedVertices) continue;
+                level[rank] = std::max(level[rank], level[tail] + 1);
+            }
+            maxLevel = std::max(maxLevel, level[rank]);
+        }
+        firstVertexOfLevel.assign(maxLevel + 2, 0);
+        for (size_t rank = 0; rank < n; rank++) {
+            firstVertexOfLevel[level[rank] + 1]++;
+        }
+        for (size_t i = 0; i <= maxLevel; i++) {
+            firstVertexOfLevel[i + 1] += firstVertexOfLevel[i];
+        }
+        verticesByLevel.resize(n);
+        std::vector<size_t> nextVertexOfLevel(firstVertexOfLevel.begin(), firstVertexOfLevel.end() - 1);
+        for (size_t rank = 0; rank < n; rank++) {
+            verticesByLevel[nextVertexOfLevel[level[rank]]++] = rank;
+        }
+    }
+
+    template<typename ITERATOR>
+    inline static void addNeighbors(std::vector<size_t>& neighbors, const ITERATOR begin, const ITERATOR end, std::vector<size_t>& merged) noexcept {
+        merged.clear();
+        std::set_union(neighbors.begin(), neighbors.end(), begin, end, std::back_inserter(merged));
+        neighbors.swap(merged);
+    }
+
+    inline Arc findArc(const size_t tail, const size_t head) const noexcept {
+        const auto begin = arcHead.begin() + firstArc[tail];
+        const auto end = arcHead.begin() + firstArc[tail + 1];
+        const auto position = std::lower_bound(begin, end, head);
+        AssertMsg(position != end && *position == head, "There is no arc from " << tail << " to " << head << "!");
+        return position - arcHead.begin();
+    }
+
+    inline void customizeVertex(const size_t rank, std::vector<Arc>& arcOfHead) noexcept {
+        if (firstArc[rank] == firstArc[rank + 1]) return;
+        for (Arc arc = firstArc[rank]; arc < firstArc[rank + 1]; arc++) {
+            arcOfHead[arcHead[arc]] = arc;
+        }
+        for (Arc i = firstIncomingArc[rank]; i < firstIncomingArc[rank + 1]; i++) {
+            const Arc lowerArc = incomingArcs[i];
+            const size_t lower = arcTail[lowerArc];
+            if (lower >= numberOfContractedVertices) continue;
+            const Vertex via(vertexOfRank[lower]);
+            for (Arc otherArc = lowerArc + 1; otherArc < firstArc[lower + 1]; otherArc++) {
+                const Arc arc = arcOfHead[arcHead[otherArc]];
+                AssertMsg(arcTail[arc] == rank && arcHead[arc] == arcHead[otherArc], "Triangle (" << lower << ", " << rank << ", " << arcHead[otherArc] << ") is not closed!");
+                const int forwardDistance = backwardWeight[lowerArc] + forwardWeight[otherArc];
+                if (forwardWeight[arc] > forwardDistance) {
+                    forwardWeight[arc] = forwardDistance;
+                    forwardVia[arc] = via;
+                }
+                const int backwardDistance = backwardWeight[otherArc] + forwardWeight[lowerArc];
+                if (backwardWeight[arc] > backwardDistance) {
+                    backwardWeight[arc] = backwardDistance;
+                    backwardVia[arc] = via;
+                }
+            }
+        }
+    }
+
+    // Relaxes the upper and intermediate triangles (vertex, x, y) with vertex < x < y, which yield a path from vertex
+    // to y via x and a path from vertex to x via y. The arcs (x, y) are already final, since x has a higher level.
+    inline void perfectVertex(const size_t rank, std::vector<Arc>& arcOfHead) noexcept {
+        if (rank >= numberOfContractedVertices) return;
+        for (Arc arc = firstArc[rank]; arc < firstArc[rank + 1]; arc++) {
+            arcOfHead[arcHead[arc]] = arc;
+        }
+        for (Arc lowerArc = firstArc[rank]; lowerArc < firstArc[rank + 1]; lowerArc++) {
+            const size_t x = arcHead[lowerArc];
+            for (Arc middleArc = firstArc[x]; middleArc < firstArc[x + 1]; middleArc++) {
+                const Arc upperArc = arcOfHead[arcHead[middleArc]];
+                if (upperArc == noArc || arcTail[upperArc] != rank || arcHead[upperArc] != arcHead[middleArc]) continue;
+                distanceForward[upperArc] = std::min(distanceForward[upperArc], distanceForward[lowerArc] + distanceForward[middleArc]);
+                distanceBackward[upperArc] = std::min(distanceBackward[upperArc], distanceBackward[middleArc] + distanceBackward[lowerArc]);
+                distanceForward[lowerArc] = std::min(distanceForward[lowerArc], distanceForward[upperArc] + distanceBackward[middleArc]);
+                distanceBackward[lowerArc] = std::min(distanceBackward[lowerArc], distanceForward[middleArc] + distanceBackward[upperArc]);
+            }
+        }
+    }
+
+    // Searches the core from a core vertex for witnesses of the arcs to its core neighbors. The vertex owns the
+    // forward direction of its upward arcs and the backward direction of its downward arcs, so no other thread writes
+    // them. The distances of the core arcs are exact afterwards, which the perfect customization relies on.
+    inline void pruneCoreArcs(const size_t rank, CoreSearch& search) noexcept {
+        int maxWeight = -1;
+        for (Arc arc = firstArc[rank]; arc < firstArc[rank + 1]; arc++) {
+            if (forwardWeight[arc] < INFTY) maxWeight = std::max(maxWeight, forwardWeight[arc]);
+        }
+        for (Arc i = firstIncomingArc[rank]; i < firstIncomingArc[rank + 1]; i++) {
+            const Arc arc = incomingArcs[i];
+            if (arcTail[arc] >= numberOfContractedVertices && backwardWeight[arc] < INFTY) maxWeight = std::max(maxWeight, backwardWeight[arc]);
+        }
+        if (maxWeight < 0) return;
+
+        const size_t source = rank - numberOfContractedVertices;
+        search.clear();
+        search.update(source, 0, Witness);
+        while (!search.Q.empty() && search.Q.front()->distance <= maxWeight) {
+            const CoreLabel* label = search.Q.extractFront();
+            const size_t vertex = search.getVertex(label) + numberOfContractedVertices;
+            const bool fromSource = (vertex == rank);
+            for (Arc arc = firstArc[vertex]; arc < firstArc[vertex + 1]; arc++) {
+                if (forwardWeight[arc] == INFTY) continue;
+                search.relax(label, arcHead[arc] - numberOfContractedVertices, forwardWeight[arc], fromSource);
+            }
+            for (Arc i = firstIncomingArc[vertex]; i < firstIncomingArc[vertex + 1]; i++) {
+                const Arc arc = incomingArcs[i];
+                if (arcTail[arc] < numberOfContractedVertices || backwardWeight[arc] == INFTY) continue;
+                search.relax(label, arcTail[arc] - numberOfContractedVertices, backwardWeight[arc], fromSource);
+            }
+        }
+
+        for (Arc arc = firstArc[rank]; arc < firstArc[rank + 1]; arc++) {
+            if (forwardWeight[arc] == INFTY) continue;
+            const size_t head = arcHead[arc] - numberOfContractedVertices;
+            distanceForward[arc] = search.getLabel(head).distance;
+            forwardWitnessed[arc] = search.hasWitness(head, forwardWeight[arc]);
+        }
+        for (Arc i = firstIncomingArc[rank]; i < firstIncomingArc[rank + 1]; i++) {
+            const Arc arc = incomingArcs[i];
+            if (arcTail[arc] < numberOfContractedVertices || backwardWeight[arc] == INFTY) continue;
+            const size_t tail = arcTail[arc] - numberOfContractedVertices;
+            distanceBackward[arc] = search.getLabel(tail).distance;
+            backwardWitnessed[arc] = search.hasWitness(tail, backwardWeight[arc]);
+        }
+    }
+
+    inline static bool isNeeded(const int weight, const int distance) noexcept {
+        return (weight < INFTY) && (weight == distance);
+    }
+
+private:
+    size_t numberOfContractedVertices;
+    Order vertexOfRank;
+    Permutation rankOf;
+
+    std::vector<Arc> firstArc;
+    std::vector<size_t> arcHead;
+    std::vector<size_t> arcTail;
+    std::vector<Arc> firstIncomingArc;
+    std::vector<Arc> incomingArcs;
+
+    std::vector<Arc> arcOfEdge;
+    std::vector<bool> edgeIsForward;
+
+    std::vector<size_t> firstVertexOfLevel;
+    std::vector<size_t> verticesByLevel;
+
+    std::vector<int> forwardWeight;
+    std::vector<int> backwardWeight;
+    std::vector<Vertex> forwardVia;
+    std::vector<Vertex> backwardVia;
+    std::vector<int> distanceForward;
+    std::vector<int> distanceBackward;
+    std::vector<uint8_t> forwardWitnessed;
+    std::vector<uint8_t> backwardWitnessed;
+
+};
+
+}
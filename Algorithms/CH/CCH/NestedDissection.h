@@ -0,0 +1,344 @@
+#pragma once
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <string>
+
+#include "../../../Helpers/Types.h"
+#include "../../../Helpers/MultiThreading.h"
+#include "../../../Helpers/Vector/Permutation.h"
+
+#include "../../../DataStructures/Geometry/Point.h"
+#include "../../../DataStructures/Graph/Graph.h"
+
+namespace CH {
+
+// Computes a metric-independent vertex order for a customizable CH by recursive nested dissection with inertial
+// flow. A connected cell is split as follows: Its vertices are projected onto one of four directions, the first and
+// the last Balance fraction are chosen as sources and sinks, and a minimum vertex cut between them is computed with
+// unit-capacity augmenting paths. The direction with the smallest separator wins. The separator is placed after
+// both sides in the order, and the sides are dissected recursively as parallel tasks.
+class NestedDissection {
+
+public:
+    inline static constexpr double Balance = 0.2;
+    // Cells of at most this size are not dissected further.
+    inline static constexpr size_t MinCellSize = 2;
+    // Sides of at most this size are dissected by the same task.
+    inline static constexpr size_t MinTaskSize = 1000;
+
+private:
+    struct Separation {
+        std::vector<Vertex> firstSide;
+        std::vector<Vertex> secondSide;
+        std::vector<Vertex> separator;
+    };
+
+    // Local copy of one cell together with the state of the flow computation. Every thread owns one workspace.
+    class Workspace {
+
+    public:
+        Workspace(const size_t numberOfVertices = 0) :
+            localId(numberOfVertices, -1) {
+        }
+
+        inline void load(const NestedDissection& dissection, const std::vector<Vertex>& cell) noexcept {
+            vertices = cell;
+            for (size_t i = 0; i < vertices.size(); i++) {
+                localId[vertices[i]] = i;
+            }
+            firstEdge.assign(vertices.size() + 1, 0);
+            for (size_t i = 0; i < vertices.size(); i++) {
+                for (size_t j = dissection.firstNeighbor[vertices[i]]; j < dissection.firstNeighbor[vertices[i] + 1]; j++) {
+                    if (localId[dissection.neighbors[j]] != -1) firstEdge[i + 1]++;
+                }
+            }
+            for (size_t i = 0; i < vertices.size(); i++) {
+                firstEdge[i + 1] += firstEdge[i];
+            }
+            head.resize(firstEdge.back());
+            reverseEdge.resize(firstEdge.back());
+            std::vector<size_t> nextEdge(firstEdge.begin(), firstEdge.end() - 1);
+            for (size_t i = 0; i < vertices.size(); i++) {
+                for (size_t j = dissection.firstNeighbor[vertices[i]]; j < dissection.firstNeighbor[vertices[i] + 1]; j++) {
+                    const int neighbor = localId[dissection.neighbors[j]];
+                    if (neighbor <= int(i)) continue;
+                    const size_t forward = nextEdge[i]++;
+                    const size_t backward = nextEdge[neighbor]++;
+                    head[forward] = neighbor;
+                    head[backward] = i;
+                    reverseEdge[forward] = backward;
+                    reverseEdge[backward] = forward;
+                }
+            }
+            coordinates.resize(vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++) {
+                coordinates[i] = dissection.coordinates[vertices[i]];
+            }
+        }
+
+        inline void unload() noexcept {
+            for (const Vertex vertex : vertices) {
+                localId[vertex] = -1;
+            }
+        }
+
+        inline std::vector<std::vector<Vertex>> getComponents() noexcept {
+            std::vector<std::vector<Vertex>> components;
+            component.assign(vertices.size(), -1);
+            for (size_t root = 0; root < vertices.size(); root++) {
+                if (component[root] != -1) continue;
+                queue.assign(1, root);
+                component[root] = components.size();
+                for (size_t i = 0; i < queue.size(); i++) {
+                    for (size_t edge = firstEdge[queue[i]]; edge < firstEdge[queue[i] + 1]; edge++) {
+                        if (component[head[edge]] != -1) continue;
+                        component[head[edge]] = components.size();
+                        queue.emplace_back(head[edge]);
+                    }
+                }
+                components.emplace_back();
+                for (const size_t vertex : queue) {
+                    components.back().emplace_back(vertices[vertex]);
+                }
+            }
+            return components;
+        }
+
+        inline Separation separate() noexcept {
+            const size_t terminals = std::max<size_t>(1, size_t(vertices.size() * Balance));
+            std::vector<int> bestSide;
+            size_t bestSeparatorSize = vertices.size() + 1;
+            size_t bestBalance = 0;
+            for (const Geometry::Point direction : {Geometry::Point(Construct::XY, 1, 0), Geometry::Point(Construct::XY, 0, 1), Geometry::Point(Construct::XY, 1, 1), Geometry::Point(Construct::XY, 1, -1)}) {
+                computeMinimumCut(direction, terminals);
+                size_t separatorSize = 0;
+                size_t firstSideSize = 0;
+                for (const int vertexSide : side) {
+                    if (vertexSide == 0) firstSideSize++;
+                    if (vertexSide == 1) separatorSize++;
+                }
+                const size_t balance = std::min(firstSideSize, vertices.size() - firstSideSize - separatorSize);
+                if (separatorSize < bestSeparatorSize || (separatorSize == bestSeparatorSize && balance > bestBalance)) {
+                    bestSeparatorSize = separatorSize;
+                    bestBalance = balance;
+                    bestSide.swap(side);
+                }
+            }
+            Separation separation;
+            for (size_t i = 0; i < vertices.size(); i++) {
+                if (bestSide[i] == 0) {
+                    separation.firstSide.emplace_back(vertices[i]);
+                } else if (bestSide[i] == 1) {
+                    separation.separator.emplace_back(vertices[i]);
+                } else {
+                    separation.secondSide.emplace_back(vertices[i]);
+                }
+            }
+            return separation;
+        }
+
+    private:
+        // The flow network contains an in-node 2v and an out-node 2v + 1 for every vertex v, connected by an arc with
+        // capacity 1. Every edge {u, v} yields arcs from the out-node of u to the in-node of v and vice versa, with
+        // unbounded capacity. The flow starts at the in-nodes of the sources and ends at the out-nodes of the sinks.
+        // Afterwards, side[v] is 0 if v is on the source side of the cut, 1 if v is in the separator and 2 otherwise.
+        inline void computeMinimumCut(const Geometry::Point& direction, const size_t terminals) noexcept {
+            const size_t n = vertices.size();
+            std::vector<size_t> byProjection(n);
+            for (size_t i = 0; i < n; i++) {
+                byProjection[i] = i;
+            }
+            std::vector<double> projection(n);
+            for (size_t i = 0; i < n; i++) {
+                projection[i] = direction.x * coordinates[i].x + direction.y * coordinates[i].y;
+            }
+            const auto compare = [&](const size_t a, const size_t b) {
+                return (projection[a] < projection[b]) || ((projection[a] == projection[b]) && (a < b));
+            };
+            std::nth_element(byProjection.begin(), byProjection.begin() + terminals, byProjection.end(), compare);
+            std::nth_element(byProjection.begin() + terminals, byProjection.end() - terminals, byProjection.end(), compare);
+            std::vector<bool> isSink(n, false);
+            for (size_t i = n - terminals; i < n; i++) {
+                isSink[byProjection[i]] = true;
+            }
+
+            vertexFlow.assign(n, false);
+            edgeFlow.assign(head.size(), 0);
+            while (findAugmentingPath(byProjection, terminals, isSink)) {
+                augment();
+            }
+            side.assign(n, 2);
+            for (size_t i = 0; i < n; i++) {
+                if (parent[2 * i + 1] != NotVisited) {
+                    side[i] = 0;
+                } else if (parent[2 * i] != NotVisited) {
+                    side[i] = 1;
+                }
+            }
+        }
+
+        inline bool findAugmentingPath(const std::vector<size_t>& byProjection, const size_t terminals, const std::vector<bool>& isSink) noexcept {
+            parent.assign(2 * vertices.size(), NotVisited);
+            parentEdge.assign(2 * vertices.size(), NoEdge);
+            queue.clear();
+            for (size_t i = 0; i < terminals; i++) {
+                parent[2 * byProjection[i]] = Root;
+                queue.emplace_back(2 * byProjection[i]);
+            }
+            for (size_t i = 0; i < queue.size(); i++) {
+                const size_t node = queue[i];
+                const size_t vertex = node / 2;
+                if (node % 2 == 0) {
+                    if (!vertexFlow[vertex] && visit(node, node + 1, NoEdge, isSink)) return true;
+                    for (size_t edge = firstEdge[vertex]; edge < firstEdge[vertex + 1]; edge++) {
+                        if (edgeFlow[reverseEdge[edge]] > 0 && visit(node, 2 * head[edge] + 1, edge, isSink)) return true;
+                    }
+                } else {
+                    if (vertexFlow[vertex]) visit(node, node - 1, NoEdge, isSink);
+                    for (size_t edge = firstEdge[vertex]; edge < firstEdge[vertex + 1]; edge++) {
+                        visit(node, 2 * head[edge], edge, isSink);
+                    }
+                }
+            }
+            return false;
+        }
+
+        // Returns true if the visited node is the out-node of a sink, i.e., an augmenting path was found.
+        inline bool visit(const size_t from, const size_t to, const size_t edge, const std::vector<bool>& isSink) noexcept {
+            if (parent[to] != NotVisited) return false;
+            parent[to] = from;
+            parentEdge[to] = edge;
+            queue.emplace_back(to);
+            if (to % 2 == 0 || !isSink[to / 2]) return false;
+            pathEnd = to;
+            return true;
+        }
+
+        inline void augment() noexcept {
+            for (size_t node = pathEnd; parent[node] != Root; node = parent[node]) {
+                const size_t from = parent[node];
+                if (parentEdge[node] == NoEdge) {
+                    vertexFlow[node / 2] = (from < node);
+                } else if (from % 2 == 1) {
+                    edgeFlow[parentEdge[node]]++;
+                    edgeFlow[reverseEdge[parentEdge[node]]]--;
+                } else {
+                    edgeFlow[reverseEdge[parentEdge[node]]]--;
+                    edgeFlow[parentEdge[node]]++;
+                }
+            }
+        }
+
+    private:
+        inline static constexpr size_t NotVisited = -1;
+        inline static constexpr size_t Root = -2;
+        inline static constexpr size_t NoEdge = -1;
+
+        std::vector<int> localId;
+        std::vector<Vertex> vertices;
+        std::vector<size_t> firstEdge;
+        std::vector<size_t> head;
+        std::vector<size_t> reverseEdge;
+        std::vector<Geometry::Point> coordinates;
+
+        std::vector<int> component;
+        std::vector<size_t> queue;
+        std::vector<bool> vertexFlow;
+        std::vector<int> edgeFlow;
+        std::vector<size_t> parent;
+        std::vector<size_t> parentEdge;
+        size_t pathEnd;
+        std::vector<int> side;
+
+    };
+
+public:
+    template<typename GRAPH>
+    NestedDissection(const GRAPH& graph) :
+        firstNeighbor(graph.numVertices() + 1, 0),
+        coordinates(graph[Coordinates]) {
+        std::vector<std::vector<Vertex>> adjacency(graph.numVertices());
+        for (const auto [edge, from] : graph.edgesWithFromVertex()) {
+            const Vertex to = graph.get(ToVertex, edge);
+            if (from == to) continue;
+            adjacency[from].emplace_back(to);
+            adjacency[to].emplace_back(from);
+        }
+        for (const Vertex vertex : graph.vertices()) {
+            std::sort(adjacency[vertex].begin(), adjacency[vertex].end());
+            adjacency[vertex].erase(std::unique(adjacency[vertex].begin(), adjacency[vertex].end()), adjacency[vertex].end());
+            firstNeighbor[vertex + 1] = firstNeighbor[vertex] + adjacency[vertex].size();
+            neighbors.insert(neighbors.end(), adjacency[vertex].begin(), adjacency[vertex].end());
+        }
+    }
+
+    inline Order run(const ThreadPinning& threadPinning) noexcept {
+        const size_t numberOfThreads = std::max<size_t>(threadPinning.numberOfThreads, 1);
+        workspaces.assign(numberOfThreads, Workspace(coordinates.size()));
+        std::vector<Vertex> cell(coordinates.size());
+        for (size_t i = 0; i < cell.size(); i++) {
+            cell[i] = Vertex(i);
+        }
+        std::vector<Vertex> result;
+        omp_set_num_threads(numberOfThreads);
+        #pragma omp parallel
+        {
+            threadPinning.pinThread();
+
+            #pragma omp single
+            result = dissect(cell);
+        }
+        workspaces.clear();
+        return Order(result);
+    }
+
+private:
+    // Returns the vertices of the cell from the least to the most important one.
+    inline std::vector<Vertex> dissect(const std::vector<Vertex>& cell) noexcept {
+        if (cell.size() <= MinCellSize) return cell;
+        Workspace& workspace = workspaces[omp_get_thread_num()];
+        workspace.load(*this, cell);
+        std::vector<std::vector<Vertex>> components = workspace.getComponents();
+        if (components.size() > 1) {
+            workspace.unload();
+            std::vector<std::vector<Vertex>> orders(components.size());
+            for (size_t i = 0; i < components.size(); i++) {
+                #pragma omp task shared(orders, components) if (components[i].size() > MinTaskSize)
+                orders[i] = dissect(components[i]);
+            }
+            #pragma omp taskwait
+            std::vector<Vertex> result;
+            result.reserve(cell.size());
+            for (const std::vector<Vertex>& order : orders) {
+                result.insert(result.end(), order.begin(), order.end());
+            }
+            return result;
+        }
+        const Separation separation = workspace.separate();
+        workspace.unload();
+        std::vector<Vertex> firstOrder;
+        std::vector<Vertex> secondOrder;
+        #pragma omp task shared(firstOrder, separation) if (separation.firstSide.size() > MinTaskSize)
+        firstOrder = dissect(separation.firstSide);
+        #pragma omp task shared(secondOrder, separation) if (separation.secondSide.size() > MinTaskSize)
+        secondOrder = dissect(separation.secondSide);
+        #pragma omp taskwait
+        std::vector<Vertex> result(std::move(firstOrder));
+        result.reserve(cell.size());
+        result.insert(result.end(), secondOrder.begin(), secondOrder.end());
+        result.insert(result.end(), separation.separator.begin(), separation.separator.end());
+        return result;
+    }
+
+private:
+    std::vector<size_t> firstNeighbor;
+    std::vector<Vertex> neighbors;
+    std::vector<Geometry::Point> coordinates;
+
+    std::vector<Workspace> workspaces;
+
+};
+
+}
@@ -48,6 +48,12 @@ public:
         Q[1].reserve(graph->numVertices());
         std::vector<Distance>(graph->numVertices()).swap(distance[0]);
         std::vector<Distance>(graph->numVertices()).swap(distance[1]);
+        reset();
+    }
+
+    inline void reset() noexcept {
+        currentFrom = noVertex;
+        currentVia = noVertex;
     }
 
     inline bool shortcutIsNecessary(const Vertex from, const Vertex to, const Vertex via, const int shortcutDistance) noexcept {
@@ -15,6 +15,7 @@
 #include "../../../DataStructures/Container/ExternalKHeap.h"
 
 #include "../../../Helpers/Timer.h"
+#include "../../../Helpers/MultiThreading.h"
 #include "Profiler.h"
 
 namespace CH {
@@ -32,9 +33,19 @@ public:
     constexpr static bool SortShortcuts = SORT_SHORTCUTS;
     using Type = Builder<Profiler, WitnessSearch, KeyFunction, StopCriterion, BuildQLinear, BreakKeyTiesById, SortShortcuts>;
 
+    // Number of vertices that are considered for the independent set of one round of the parallel contraction: at
+    // least CandidatesPerThread per thread, or 1/CandidateFraction of the remaining vertices.
+    inline static constexpr size_t CandidatesPerThread = 64;
+    inline static constexpr size_t CandidateFraction = 100;
+
 private:
     using KeyType = typename KEY_FUNCTION::KeyType;
 
+    // Target for the update of the thread-local key functions, whose keys are recomputed by the builder itself.
+    struct NoReKey {
+        inline void reKey(const Vertex) noexcept {}
+    };
+
 private:
     struct VertexLabel : public ExternalKHeapElement {
         VertexLabel() : key(0) {}
@@ -64,7 +75,8 @@ public:
         stopCriterion(stopCriterion),
         profiler(profiler),
         Q(data.numVertices),
-        label(data.numVertices) {
+        label(data.numVertices),
+        numberOfRounds(0) {
     }
 
     Builder(CHCoreGraph&& graph, const KeyFunction& keyFunction = KeyFunction(), const StopCriterion& stopCriterion = StopCriterion(), const WitnessSearch& witnessSearch = WitnessSearch(), const Profiler& profiler = Profiler()) :
@@ -74,7 +86,8 @@ public:
         stopCriterion(stopCriterion),
         profiler(profiler),
         Q(data.numVertices),
-        label(data.numVertices) {
+        label(data.numVertices),
+        numberOfRounds(0) {
     }
 
     Builder(Data&& originalData, const KeyFunction& keyFunction = KeyFunction(), const StopCriterion& stopCriterion = StopCriterion(), const WitnessSearch& witnessSearch = WitnessSearch(), const Profiler& profiler = Profiler()) :
@@ -84,7 +97,8 @@ public:
         stopCriterion(stopCriterion),
         profiler(profiler),
         Q(data.numVertices),
-        label(data.numVertices) {
+        label(data.numVertices),
+        numberOfRounds(0) {
     }
 
     inline void run() {
@@ -95,6 +109,25 @@ public:
         profiler.done();
     }
 
+    // Contracts the vertices in rounds. In every round, the vertices with the lowest keys are candidates, and a
+    // candidate is selected if its key is smaller than the keys of all its neighbors in the core (ties are broken by
+    // id). The selected vertices form an independent set, so their witness searches run concurrently on the core of
+    // the previous round, each thread with its own witness search and key function. Afterwards, the shortcuts are
+    // inserted in a single batch and the keys of the affected neighbors are recomputed in parallel. The stop criterion
+    // is checked before every contraction of the batch, so a round does not contract past it.
+    // A witness of one selected vertex may pass through another one, so a shortcut is only discarded if its witness
+    // is strictly shorter. Otherwise, two vertices could discard the shortcuts that witness each other.
+    inline void run(const ThreadPinning& threadPinning) {
+        const size_t numberOfThreads = std::max<size_t>(threadPinning.numberOfThreads, 1);
+        initialize<true>();
+        initializeThreads(numberOfThreads);
+        profiler.start();
+        omp_set_num_threads(numberOfThreads);
+        buildQParallel(threadPinning);
+        contractQVerticesParallel(threadPinning, numberOfThreads);
+        profiler.done();
+    }
+
     inline void resume() {
         initialize<false>();
         profiler.start();
@@ -145,6 +178,10 @@ public:
         return Q.size();
     }
 
+    inline size_t getNumberOfRounds() const noexcept {
+        return numberOfRounds;
+    }
+
     inline const CHCoreGraph& getCore() const noexcept {
         return data.core;
     }
@@ -275,6 +312,211 @@ private:
         }
     }
 
+    inline void initializeThreads(const size_t numberOfThreads) noexcept {
+        numberOfRounds = 0;
+        threadProfilers.assign(numberOfThreads, Profiler());
+        threadWitnessSearches.assign(numberOfThreads, witnessSearch);
+        threadKeyFunctions.clear();
+        threadKeyFunctions.reserve(numberOfThreads);
+        for (size_t i = 0; i < numberOfThreads; i++) {
+            threadWitnessSearches[i].initialize(&(data.core), &(data.core[Weight]), &(threadProfilers[i]));
+            threadKeyFunctions.emplace_back(keyFunction);
+            threadKeyFunctions[i].initialize(&data, &(threadWitnessSearches[i]));
+        }
+    }
+
+    inline KeyType getKey(const size_t thread, const Vertex vertex) noexcept {
+        threadWitnessSearches[thread].reset();
+        return threadKeyFunctions[thread](vertex);
+    }
+
+    inline void mergeThreadProfilers() noexcept {
+        for (Profiler& threadProfiler : threadProfilers) {
+            profiler.addWitnessSearches(threadProfiler);
+            threadProfiler = Profiler();
+        }
+    }
+
+    inline void buildQParallel(const ThreadPinning& threadPinning) noexcept {
+        profiler.startBuildingQ();
+        Q.clear();
+        for (const Vertex vertex : data.core.vertices()) {
+            data.level[vertex] = 0;
+        }
+        #pragma omp parallel
+        {
+            threadPinning.pinThread();
+            const size_t thread = omp_get_thread_num();
+
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t i = 0; i < data.numVertices; i++) {
+                label[i].key = getKey(thread, Vertex(i));
+            }
+        }
+        mergeThreadProfilers();
+        for (const Vertex vertex : data.core.vertices()) {
+            if constexpr (!BuildQLinear) {
+                Q.update(&(label[vertex]));
+            }
+            profiler.enQ(vertex, label[vertex].key);
+        }
+        if constexpr (BuildQLinear) {
+            Q.build(label);
+        }
+        profiler.doneBuildingQ();
+    }
+
+    inline void contractQVerticesParallel(const ThreadPinning& threadPinning, const size_t numberOfThreads) noexcept {
+        profiler.startContracting();
+        std::vector<Vertex> candidates;
+        std::vector<Vertex> independentSet;
+        std::vector<std::vector<Shortcut>> shortcuts;
+        std::vector<size_t> numberOfTestedShortcuts;
+        std::vector<Vertex> neighbors;
+        std::vector<bool> isNeighbor(data.numVertices, false);
+        NoReKey noReKey;
+        while (!Q.empty()) {
+            keyFunction.update(*this);
+            for (KeyFunction& threadKeyFunction : threadKeyFunctions) {
+                threadKeyFunction.update(noReKey);
+            }
+            if (stopCriterion(Q)) {break;}
+            numberOfRounds++;
+
+            const size_t numberOfCandidates = std::max(numberOfThreads * CandidatesPerThread, Q.size() / CandidateFraction);
+            candidates.clear();
+            while (!Q.empty() && candidates.size() < numberOfCandidates) {
+                if (!candidates.empty() && Q.front()->key == intMax) break;
+                candidates.emplace_back(Vertex(Q.extractFront() - &(label[0])));
+            }
+            independentSet.clear();
+            for (const Vertex candidate : candidates) {
+                if (isLocalMinimum(candidate)) {
+                    independentSet.emplace_back(candidate);
+                }
+                Q.update(&(label[candidate]));
+            }
+            if (independentSet.empty()) {
+                independentSet.emplace_back(candidates[0]);
+            }
+
+            if (shortcuts.size() < independentSet.size()) {
+                shortcuts.resize(independentSet.size());
+                numberOfTestedShortcuts.resize(independentSet.size());
+            }
+            #pragma omp parallel
+            {
+                threadPinning.pinThread();
+                const size_t thread = omp_get_thread_num();
+
+                #pragma omp for schedule(dynamic, 1)
+                for (size_t i = 0; i < independentSet.size(); i++) {
+                    numberOfTestedShortcuts[i] = collectShortcuts(thread, independentSet[i], shortcuts[i]);
+                }
+            }
+            mergeThreadProfilers();
+
+            // The selected vertices stay in Q until they are contracted, so the stop criterion sees the current core.
+            neighbors.clear();
+            for (size_t i = 0; i < independentSet.size(); i++) {
+                if (i > 0 && stopCriterion(Q)) break;
+                const Vertex vertex = independentSet[i];
+                Q.remove(&(label[vertex]));
+                profiler.startContraction(vertex);
+                data.order.push_back(vertex);
+                for (size_t j = 0; j < numberOfTestedShortcuts[i]; j++) {
+                    profiler.testShortcut();
+                }
+                for (const Shortcut& shortcut : shortcuts[i]) {
+                    addShortcut(shortcut.from, shortcut.to, vertex, shortcut.weight);
+                }
+                const uint16_t level = data.level[vertex] + 1;
+                for (Edge edge : data.core.edgesFrom(vertex)) {
+                    Vertex to = data.core.get(ToVertex, edge);
+                    if (vertex == to) continue;
+                    data.forwardCH.addEdge(vertex, to).set(ViaVertex, data.core.get(ViaVertex, edge)).set(Weight, data.core.get(Weight, edge));
+                    profiler.updateOutgoingNeighbor(to, label[to].key);
+                    data.level[to] = std::max(data.level[to], level);
+                    if (!isNeighbor[to]) {
+                        isNeighbor[to] = true;
+                        neighbors.emplace_back(to);
+                    }
+                }
+                for (Edge edge : data.core.edgesTo(vertex)) {
+                    Vertex from = data.core.get(FromVertex, edge);
+                    if (vertex == from) continue;
+                    data.backwardCH.addEdge(vertex, from).set(ViaVertex, data.core.get(ViaVertex, edge)).set(Weight, data.core.get(Weight, edge));
+                    profiler.updateIncomingNeighbor(from, label[from].key);
+                    data.level[from] = std::max(data.level[from], level);
+                    if (!isNeighbor[from]) {
+                        isNeighbor[from] = true;
+                        neighbors.emplace_back(from);
+                    }
+                }
+                data.core.isolateVertex(vertex);
+                profiler.doneContraction(vertex);
+            }
+
+            #pragma omp parallel
+            {
+                threadPinning.pinThread();
+                const size_t thread = omp_get_thread_num();
+
+                #pragma omp for schedule(dynamic, 16)
+                for (size_t i = 0; i < neighbors.size(); i++) {
+                    label[neighbors[i]].key = getKey(thread, neighbors[i]);
+                }
+            }
+            mergeThreadProfilers();
+            for (const Vertex neighbor : neighbors) {
+                isNeighbor[neighbor] = false;
+                Q.update(&(label[neighbor]));
+            }
+        }
+        profiler.doneContracting();
+    }
+
+    inline bool isLocalMinimum(const Vertex vertex) const noexcept {
+        for (const Edge edge : data.core.edgesFrom(vertex)) {
+            if (hasSmallerKey(data.core.get(ToVertex, edge), vertex)) return false;
+        }
+        for (const Edge edge : data.core.edgesTo(vertex)) {
+            if (hasSmallerKey(data.core.get(FromVertex, edge), vertex)) return false;
+        }
+        return true;
+    }
+
+    inline bool hasSmallerKey(const Vertex a, const Vertex b) const noexcept {
+        return (label[a].key < label[b].key) || ((label[a].key == label[b].key) && (a < b));
+    }
+
+    // Collects the shortcuts that are necessary for contracting the vertex and returns the number of tested shortcuts.
+    inline size_t collectShortcuts(const size_t thread, const Vertex vertex, std::vector<Shortcut>& shortcuts) noexcept {
+        shortcuts.clear();
+        for (Edge first : data.core.edgesTo(vertex)) {
+            Vertex from = data.core.get(FromVertex, first);
+            for (Edge second : data.core.edgesFrom(vertex)) {
+                Vertex to = data.core.get(ToVertex, second);
+                if (from == to) continue;
+                shortcuts.push_back(Shortcut({from, to, data.core.get(Weight, first) + data.core.get(Weight, second)}));
+            }
+        }
+        if constexpr (SortShortcuts) {
+            std::sort(shortcuts.begin(), shortcuts.end());
+        }
+        const size_t numberOfTestedShortcuts = shortcuts.size();
+        WitnessSearch& threadWitnessSearch = threadWitnessSearches[thread];
+        threadWitnessSearch.reset();
+        size_t numberOfNecessaryShortcuts = 0;
+        for (const Shortcut& shortcut : shortcuts) {
+            if (threadWitnessSearch.shortcutIsNecessary(shortcut.from, shortcut.to, vertex, shortcut.weight - 1)) {
+                shortcuts[numberOfNecessaryShortcuts++] = shortcut;
+            }
+        }
+        shortcuts.resize(numberOfNecessaryShortcuts);
+        return numberOfTestedShortcuts;
+    }
+
     inline void addShortcut(const Vertex from, const Vertex to, const Vertex via, const int shortcutWeight) noexcept {
         profiler.addShortcut();
         Edge shortcut = data.core.findEdge(from, to);
@@ -298,6 +540,11 @@ private:
     ExternalKHeap<2, VertexLabel> Q;
     std::vector<VertexLabel> label;
 
+    std::vector<Profiler> threadProfilers;
+    std::vector<WitnessSearch> threadWitnessSearches;
+    std::vector<KeyFunction> threadKeyFunctions;
+    size_t numberOfRounds;
+
 };
 
 }
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "../../../DataStructures/Graph/Graph.h"
+#include "../../../DataStructures/Container/ExternalKHeap.h"
+
+#include "../../../Helpers/Types.h"
+#include "../../../Helpers/MultiThreading.h"
+#include "../../../Helpers/Console/Progress.h"
+#include "../../../Helpers/String/String.h"
+#include "../../../Helpers/Vector/Permutation.h"
+
+namespace CH {
+
+// Computes hub labels with pruned landmark labeling (PLL). The vertices are processed in reverse contraction order of
+// a CH, i.e., the most important vertex first. For every vertex v, a forward and a backward Dijkstra search add v as
+// a hub to the in-labels and out-labels of the vertices they settle. A vertex u is pruned if the labels computed so
+// far already cover the distance between v and u.
+// The vertices are processed in batches, and the searches of one batch run in parallel. They only see the labels of
+// earlier batches, so larger batches produce slightly larger labels. The first batches, which prune the most, are
+// small: The batch size doubles up to BatchSizePerThread times the number of threads. With a single thread, every
+// batch consists of one vertex, which yields the labels of sequential PLL.
+// The resulting labels are stored in the format expected by HLRAPTOR and HLCSA: The out-hub graph has an edge
+// (v, h) with length dist(v, h) for every out-hub h of v, and the in-hub graph has an edge (v, h) with length
+// dist(h, v) for every in-hub h of v. Every vertex is a hub of itself.
+class HubLabelBuilder {
+
+public:
+    inline static constexpr size_t BatchSizePerThread = 8;
+
+private:
+    struct HubEntry {
+        HubEntry(const Vertex hub = noVertex, const int distance = INFTY) :
+            hub(hub),
+            distance(distance) {
+        }
+        Vertex hub;
+        int distance;
+    };
+
+    struct VertexLabel : public ExternalKHeapElement {
+        VertexLabel() : ExternalKHeapElement(), distance(INFTY), timestamp(0) {}
+        inline bool hasSmallerKey(const VertexLabel* const other) const noexcept {
+            return distance < other->distance;
+        }
+        int distance;
+        int timestamp;
+    };
+
+    // Search state of one thread. The hubs are identified by their rank, i.e., their position in the processing order.
+    class PrunedSearch {
+
+    public:
+        PrunedSearch(const size_t numberOfVertices) :
+            Q(numberOfVertices),
+            label(numberOfVertices),
+            rootDistance(numberOfVertices, INFTY),
+            timestamp(0) {
+        }
+
+        // Settles the vertices reached from root in the given graph and returns the entries (u, dist) that are not
+        // covered by rootLabels and the labels of u.
+        inline void run(const TransferGraph& graph, const Vertex root, const std::vector<HubEntry>& rootLabels, const std::vector<std::vector<HubEntry>>& labels, std::vector<HubEntry>& result) noexcept {
+            for (const HubEntry& entry : rootLabels) {
+                rootDistance[entry.hub] = entry.distance;
+            }
+            timestamp++;
+            VertexLabel& rootLabel = getLabel(root);
+            rootLabel.distance = 0;
+            Q.update(&rootLabel);
+            while (!Q.empty()) {
+                const VertexLabel* uLabel = Q.extractFront();
+                const Vertex u = Vertex(uLabel - &(label[0]));
+                if (u != root && isCovered(labels[u], uLabel->distance)) continue;
+                result.emplace_back(u, uLabel->distance);
+                for (const Edge edge : graph.edgesFrom(u)) {
+                    const Vertex v = graph.get(ToVertex, edge);
+                    VertexLabel& vLabel = getLabel(v);
+                    const int distance = uLabel->distance + graph.get(TravelTime, edge);
+                    if (vLabel.distance > distance) {
+                        vLabel.distance = distance;
+                        Q.update(&vLabel);
+                    }
+                }
+            }
+            for (const HubEntry& entry : rootLabels) {
+                rootDistance[entry.hub] = INFTY;
+            }
+        }
+
+    private:
+        inline VertexLabel& getLabel(const Vertex vertex) noexcept {
+            VertexLabel& result = label[vertex];
+            if (result.timestamp != timestamp) {
+                result.distance = INFTY;
+                result.timestamp = timestamp;
+            }
+            return result;
+        }
+
+        inline bool isCovered(const std::vector<HubEntry>& vertexLabels, const int distance) const noexcept {
+            for (const HubEntry& entry : vertexLabels) {
+                if (rootDistance[entry.hub] == INFTY) continue;
+                if (rootDistance[entry.hub] + entry.distance <= distance) return true;
+            }
+            return false;
+        }
+
+    private:
+        ExternalKHeap<2, VertexLabel> Q;
+        std::vector<VertexLabel> label;
+        std::vector<int> rootDistance;
+        int timestamp;
+
+    };
+
+public:
+    // The order is the contraction order of the CH, as written by buildCH.
+    HubLabelBuilder(const TransferGraph& graph, const Order& order) :
+        graph(graph),
+        reverseGraph(graph),
+        vertexOfRank(order.rbegin(), order.rend()),
+        outLabels(graph.numVertices()),
+        inLabels(graph.numVertices()),
+        numberOfBatches(0) {
+        AssertMsg(order.size() == graph.numVertices(), "Order has " << order.size() << " entries, but the graph has " << graph.numVertices() << " vertices!");
+        reverseGraph.revert();
+    }
+
+    inline void run(const ThreadPinning& threadPinning) noexcept {
+        const size_t numberOfThreads = std::max<size_t>(threadPinning.numberOfThreads, 1);
+        const size_t maxBatchSize = (numberOfThreads == 1) ? 1 : numberOfThreads * BatchSizePerThread;
+        std::vector<std::vector<HubEntry>> forwardResults(maxBatchSize);
+        std::vector<std::vector<HubEntry>> backwardResults(maxBatchSize);
+        std::vector<PrunedSearch> searches(numberOfThreads, PrunedSearch(graph.numVertices()));
+        Progress progress(vertexOfRank.size());
+
+        omp_set_num_threads(numberOfThreads);
+        size_t batchSize = 1;
+        for (size_t begin = 0; begin < vertexOfRank.size(); begin += batchSize) {
+            batchSize = std::min(begin == 0 ? 1 : std::min(begin, maxBatchSize), vertexOfRank.size() - begin);
+            numberOfBatches++;
+            #pragma omp parallel if (batchSize > 1)
+            {
+                if (batchSize > 1) threadPinning.pinThread();
+                PrunedSearch& search = searches[omp_get_thread_num()];
+
+                #pragma omp for schedule(dynamic, 1)
+                for (size_t i = 0; i < batchSize; i++) {
+                    const Vertex root = vertexOfRank[begin + i];
+                    forwardResults[i].clear();
+                    backwardResults[i].clear();
+                    search.run(graph, root, outLabels[root], inLabels, forwardResults[i]);
+                    search.run(reverseGraph, root, inLabels[root], outLabels, backwardResults[i]);
+                }
+            }
+            for (size_t i = 0; i < batchSize; i++) {
+                const Vertex rank(begin + i);
+                for (const HubEntry& entry : forwardResults[i]) {
+                    inLabels[entry.hub].emplace_back(rank, entry.distance);
+                }
+                for (const HubEntry& entry : backwardResults[i]) {
+                    outLabels[entry.hub].emplace_back(rank, entry.distance);
+                }
+            }
+            progress += batchSize;
+        }
+        progress.finished();
+    }
+
+    inline TransferGraph getOutHubs() const noexcept {
+        return buildHubGraph(outLabels);
+    }
+
+    inline TransferGraph getInHubs() const noexcept {
+        return buildHubGraph(inLabels);
+    }
+
+    inline size_t getNumberOfBatches() const noexcept {
+        return numberOfBatches;
+    }
+
+    inline void printStatistics() const noexcept {
+        printStatistics("Out-labels", outLabels);
+        printStatistics("In-labels", inLabels);
+    }
+
+private:
+    inline TransferGraph buildHubGraph(const std::vector<std::vector<HubEntry>>& labels) const noexcept {
+        size_t numberOfEntries = 0;
+        for (const std::vector<HubEntry>& vertexLabels : labels) {
+            numberOfEntries += vertexLabels.size();
+        }
+        TransferGraph result;
+        result.reserve(graph.numVertices(), numberOfEntries);
+        for (const Vertex vertex : graph.vertices()) {
+            result.addVertex();
+            result.set(Coordinates, vertex, graph.get(Coordinates, vertex));
+            for (const HubEntry& entry : labels[vertex]) {
+                result.addEdge(vertex, vertexOfRank[entry.hub]).set(TravelTime, entry.distance);
+            }
+        }
+        return result;
+    }
+
+    inline static void printStatistics(const std::string& name, const std::vector<std::vector<HubEntry>>& labels) noexcept {
+        size_t numberOfEntries = 0;
+        size_t maxLabelSize = 0;
+        for (const std::vector<HubEntry>& vertexLabels : labels) {
+            numberOfEntries += vertexLabels.size();
+            maxLabelSize = std::max(maxLabelSize, vertexLabels.size());
+        }
+        std::cout << name << ": " << String::prettyInt(numberOfEntries) << " entries, "
+                  << String::prettyDouble(numberOfEntries / static_cast<double>(std::max<size_t>(labels.size(), 1))) << " on average, "
+                  << String::prettyInt(maxLabelSize) << " at most, "
+                  << String::bytesToString(numberOfEntries * sizeof(HubEntry)) << std::endl;
+    }
+
+private:
+    const TransferGraph& graph;
+    TransferGraph reverseGraph;
+    std::vector<Vertex> vertexOfRank;
+
+    std::vector<std::vector<HubEntry>> outLabels;
+    std::vector<std::vector<HubEntry>> inLabels;
+
+    size_t numberOfBatches;
+
+};
+
+}
@@ -38,6 +38,9 @@ public:
     inline void doneWitnessSearch() noexcept {}
     inline void settledVertex() noexcept {}
 
+    // Adds the witness searches that were counted by a thread-local profiler of the parallel contraction.
+    inline void addWitnessSearches(const NoProfiler&) noexcept {}
+
 };
 
 class TimeProfiler : public NoProfiler {
@@ -223,6 +226,12 @@ public:
         settledVertices++;
     }
 
+    inline void addWitnessSearches(const FullProfiler& other) noexcept {
+        witnessSearchTime += other.witnessSearchTime;
+        witnessSearchCount += other.witnessSearchCount;
+        settledVertices += other.settledVertices;
+    }
+
 private:
     inline void printHeader() noexcept {
         std::cout << std::endl
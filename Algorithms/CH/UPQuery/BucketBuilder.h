@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <algorithm>
 #include <vector>
 #include <string>
 
@@ -8,6 +9,7 @@
 #include "../CHUtils.h"
 
 #include "../../../Helpers/Types.h"
+#include "../../../Helpers/MultiThreading.h"
 #include "../../../Helpers/Timer.h"
 #include "../../../Helpers/Console/Progress.h"
 #include "../../../Helpers/String/String.h"
@@ -33,6 +35,21 @@ private:
         int distance;
     };
 
+    struct BucketEdge {
+        BucketEdge(const Vertex bucket = noVertex, const Vertex target = noVertex, const int distance = INFTY) :
+            bucket(bucket),
+            target(target),
+            distance(distance) {
+        }
+        // Same edge order as CHGraph::sortEdges(Weight), with ties broken by target.
+        inline bool operator<(const BucketEdge& other) const noexcept {
+            return (bucket < other.bucket) || ((bucket == other.bucket) && ((distance < other.distance) || ((distance == other.distance) && (target < other.target))));
+        }
+        Vertex bucket;
+        Vertex target;
+        int distance;
+    };
+
 public:
     BucketBuilder(const CHGraph& forward, const CHGraph& backward) :
         graph {&forward, &backward},
@@ -53,13 +70,7 @@ public:
         temp.addVertices(graph[FORWARD]->numVertices());
         Progress progress(targets.size(), Debug);
         for (const Vertex vertex : targets) {
-            clear();
-            cleanLabel(vertex);
-            distance[vertex].distance = 0;
-            Q.update(&distance[vertex]);
-            while (!Q.empty()) {
-                settle();
-            }
+            run(vertex);
             for (const Vertex bucket : reachedVertices) {
                 AssertMsg(!temp.hasEdge(bucket, vertex), "Bucket graph contains already an edge from " << bucket << " to " << vertex << "!");
                 temp.addEdge(bucket, vertex).set(Weight, distance[bucket].distance);
@@ -77,7 +88,91 @@ public:
         return result;
     }
 
+    // Runs the searches of the individual threads independently and collects their bucket entries in thread-local
+    // vectors. The entries are then split into one range of bucket vertices per thread, and every thread sorts its
+    // range. Only appending the sorted entries to the final graph is sequential.
+    inline CHGraph build(const IndexedSet<false, Vertex>& targets, const ThreadPinning& threadPinning) noexcept {
+        if (threadPinning.numberOfThreads <= 1) return build(targets);
+        if constexpr (Debug) std::cout << "Building bucket graph with " << threadPinning.numberOfThreads << " threads" << std::endl;
+        const size_t numberOfShards = threadPinning.numberOfThreads;
+        const size_t numberOfVertices = graph[FORWARD]->numVertices();
+        std::vector<std::vector<BucketEdge>> threadEdges(numberOfShards);
+        std::vector<std::vector<BucketEdge>> shards(numberOfShards);
+        Progress progress(targets.size(), Debug);
+
+        omp_set_num_threads(threadPinning.numberOfThreads);
+        #pragma omp parallel
+        {
+            threadPinning.pinThread();
+            const size_t threadId = omp_get_thread_num();
+            Type search(*graph[FORWARD], *graph[BACKWARD]);
+            std::vector<BucketEdge>& edges = threadEdges[threadId];
+
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t i = 0; i < targets.size(); i++) {
+                const Vertex target = targets[i];
+                search.run(target);
+                for (const Vertex bucket : search.reachedVertices) {
+                    edges.emplace_back(bucket, target, search.distance[bucket].distance);
+                }
+                progress++;
+            }
+            std::sort(edges.begin(), edges.end());
+
+            #pragma omp barrier
+
+            const Vertex firstBucket(numberOfVertices * threadId / numberOfShards);
+            const Vertex endBucket(numberOfVertices * (threadId + 1) / numberOfShards);
+            std::vector<BucketEdge>& shard = shards[threadId];
+            for (const std::vector<BucketEdge>& otherEdges : threadEdges) {
+                const auto begin = std::lower_bound(otherEdges.begin(), otherEdges.end(), BucketEdge(firstBucket, Vertex(0), -INFTY));
+                const auto end = std::lower_bound(begin, otherEdges.end(), BucketEdge(endBucket, Vertex(0), -INFTY));
+                shard.insert(shard.end(), begin, end);
+            }
+            std::sort(shard.begin(), shard.end());
+
+            #pragma omp barrier
+
+            std::vector<BucketEdge>().swap(edges);
+        }
+
+        size_t numberOfEdges = 0;
+        for (const std::vector<BucketEdge>& shard : shards) {
+            numberOfEdges += shard.size();
+        }
+        CHGraph result;
+        result.reserve(numberOfVertices, numberOfEdges);
+        for (const std::vector<BucketEdge>& shard : shards) {
+            for (const BucketEdge& edge : shard) {
+                while (result.numVertices() <= edge.bucket) {
+                    result.addVertex();
+                }
+                AssertMsg(!result.hasEdge(edge.bucket, edge.target), "Bucket graph contains already an edge from " << edge.bucket << " to " << edge.target << "!");
+                result.addEdge(edge.bucket, edge.target).set(Weight, edge.distance);
+            }
+        }
+        while (result.numVertices() < numberOfVertices) {
+            result.addVertex();
+        }
+        if constexpr (Debug) {
+            std::cout << std::endl;
+            ::Graph::printInfo(result);
+            result.printAnalysis();
+        }
+        return result;
+    }
+
 private:
+    inline void run(const Vertex target) noexcept {
+        clear();
+        cleanLabel(target);
+        distance[target].distance = 0;
+        Q.update(&distance[target]);
+        while (!Q.empty()) {
+            settle();
+        }
+    }
+
     inline void settle() noexcept {
         Distance* distanceU = Q.extractFront();
         const Vertex u = Vertex(distanceU - &(distance[0]));
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <algorithm>
 #include <vector>
 #include <string>
 
@@ -10,6 +11,7 @@
 
 #include "../../../Helpers/Helpers.h"
 #include "../../../Helpers/Types.h"
+#include "../../../Helpers/MultiThreading.h"
 #include "../../../Helpers/Timer.h"
 #include "../../../Helpers/Console/Progress.h"
 #include "../../../Helpers/String/String.h"
@@ -34,7 +36,26 @@ public:
     using Type = UPQuery<UseStopBuckets, UseTargetBuckets, StallOnDemand, Debug>;
     using BucketBuilderType = BucketBuilder<StallOnDemand, Debug>;
 
+    // Number of sources that are processed together by the batched sweeps. The distances of all sources are stored
+    // next to each other for every vertex, such that relaxing an edge for all of them compiles to a few vector
+    // instructions (one AVX-512 or two AVX2 registers, plain scalar code on other targets).
+    constexpr static size_t BatchSize = 16;
+
 private:
+    struct alignas(BatchSize * sizeof(int)) BatchLabel {
+        BatchLabel() {
+            std::fill(distance, distance + BatchSize, never);
+        }
+
+        inline void relax(const BatchLabel& other, const int weight) noexcept {
+            for (size_t i = 0; i < BatchSize; i++) {
+                distance[i] = std::min(distance[i], other.distance[i] + weight);
+            }
+        }
+
+        int distance[BatchSize];
+    };
+
     struct DijkstraLabel : public ExternalKHeapElement {
         DijkstraLabel(int* const distance) :
             ExternalKHeapElement(),
@@ -55,7 +76,7 @@ private:
     };
 
 public:
-    UPQuery(const CHGraph& forward, const CHGraph& backward, const Order& order, const Vertex::ValueType numberOfStops, const IndexedSet<false, Vertex>& originalTargets) :
+    UPQuery(const CHGraph& forward, const CHGraph& backward, const Order& order, const Vertex::ValueType numberOfStops, const IndexedSet<false, Vertex>& originalTargets, const ThreadPinning& threadPinning = ThreadPinning(1, 1)) :
         graph {forward, backward},
         contractionOrder(order),
         positionInOrder(Construct::Invert, contractionOrder),
@@ -67,7 +88,9 @@ public:
         parent(graph[FORWARD].numVertices(), noVertex),
         timestamp(graph[FORWARD].numVertices(), 0),
         currentTimestamp(0),
-        bucketSources(graph[FORWARD].numVertices()) {
+        bucketSources(graph[FORWARD].numVertices()),
+        batchSweepStart(noVertex),
+        sweepThreadPinning(1, 1) {
 
         std::cout << "Reordering vertices... " << std::endl;
         timer.restart();
@@ -87,7 +110,7 @@ public:
         std::cout << "Building stop graph... " << std::endl;
         timer.restart();
         if constexpr (UseStopBuckets) {
-            stopGraph.initialize(bucketBuilder.build(stops));
+            stopGraph.initialize(bucketBuilder.build(stops, threadPinning));
         } else {
             stopGraph.build(graph[BACKWARD], stops, false, false);
         }
@@ -96,7 +119,7 @@ public:
         std::cout << "Building target graph... " << std::endl;
         timer.restart();
         if constexpr (UseTargetBuckets) {
-            targetGraph.initialize(bucketBuilder.build(targets));
+            targetGraph.initialize(bucketBuilder.build(targets, threadPinning));
         } else {
             targetGraph.build(graph[BACKWARD], targets, false, false);
         }
@@ -107,18 +130,30 @@ public:
         }
     }
 
-    UPQuery(const CH& ch, const Order& order, const Vertex::ValueType numberOfStops, const IndexedSet<false, Vertex>& targets, const int direction = FORWARD) :
-        UPQuery(ch.getGraph(direction), ch.getGraph(!direction), order, numberOfStops, targets) {
+    UPQuery(const CH& ch, const Order& order, const Vertex::ValueType numberOfStops, const IndexedSet<false, Vertex>& targets, const int direction = FORWARD, const ThreadPinning& threadPinning = ThreadPinning(1, 1)) :
+        UPQuery(ch.getGraph(direction), ch.getGraph(!direction), order, numberOfStops, targets, threadPinning) {
     }
 
     inline void initialize() noexcept {
         clear();
     }
 
+    // With more than one thread, the downward sweeps process the vertices of each level of the sweep graphs in
+    // parallel. The threads are pinned once here and reused by all following sweeps.
+    inline void useParallelSweeps(const ThreadPinning& threadPinning) noexcept {
+        sweepThreadPinning = threadPinning;
+        if (sweepThreadPinning.numberOfThreads <= 1) return;
+        #pragma omp parallel num_threads(sweepThreadPinning.numberOfThreads)
+        {
+            sweepThreadPinning.pinThread();
+        }
+    }
+
     inline void clear() noexcept {
         Q.clear();
         currentTimestamp++;
         bucketSources.clear();
+        upwardSearchSpace.clear();
         sweepStart = noVertex;
     }
 
@@ -127,6 +162,8 @@ public:
         addSourceInternal<FOR_SWEEP>(originalToInternal(vertex), initialDistance, parentVertex);
     }
 
+    // With RECORD_SEARCH_SPACE, the settled vertices are kept for addUpwardSearchToBatch.
+    template<bool RECORD_SEARCH_SPACE = false>
     inline void upwardSearch() noexcept {
         if constexpr (Debug) {
             std::cout << "Running upward search with " << Q.size() << " queue elements" << std::endl;
@@ -134,7 +171,7 @@ public:
         }
 
         while (!Q.empty()) {
-            settle();
+            settle<RECORD_SEARCH_SPACE>();
         }
 
         if constexpr (Debug) {
@@ -189,6 +226,84 @@ public:
         }
     }
 
+    // Batched queries: up to BatchSize independent sources, each with its own lane of distance labels. Only the PHAST
+    // sweeps are batched, so the target graph has to be a sweep graph.
+    inline void initializeBatch() noexcept {
+        if (batchLabel.empty()) {
+            batchLabel.resize(graph[FORWARD].numVertices());
+        } else {
+            std::fill(batchLabel.begin(), batchLabel.end(), BatchLabel());
+        }
+        batchSweepStart = noVertex;
+    }
+
+    inline void addBatchSource(const size_t lane, const Vertex vertex, const int initialDistance) noexcept {
+        AssertMsg(lane < BatchSize, "Lane " << lane << " is out of range!");
+        const Vertex internalVertex = originalToInternal(vertex);
+        int& distanceOfVertex = batchLabel[internalVertex].distance[lane];
+        if (initialDistance >= distanceOfVertex) return;
+        distanceOfVertex = initialDistance;
+        AssertMsg(upwardSweepGraph.externalToInternal(internalVertex) < upwardSweepGraph.graph.numVertices(), "Vertex is not in sweep graph! (original: "<< vertex << ", CH: " << internalVertex << ")");
+        batchSweepStart = std::min(batchSweepStart, sweepStartOf[upwardSweepGraph.externalToInternal(internalVertex)]);
+    }
+
+    // Copies the result of the last upward search, which must have recorded its search space, into the given lane.
+    // This accounts for journeys that only walk.
+    inline void addUpwardSearchToBatch(const size_t lane) noexcept {
+        AssertMsg(lane < BatchSize, "Lane " << lane << " is out of range!");
+        for (const Vertex vertex : upwardSearchSpace) {
+            int& distanceOfVertex = batchLabel[vertex].distance[lane];
+            if (distance[vertex] >= distanceOfVertex) continue;
+            distanceOfVertex = distance[vertex];
+            const Vertex sweepVertex = upwardSweepGraph.externalToInternal(vertex);
+            if (sweepVertex < upwardSweepGraph.graph.numVertices()) {
+                batchSweepStart = std::min(batchSweepStart, sweepStartOf[sweepVertex]);
+            }
+        }
+    }
+
+    inline void upwardSweepBatch() noexcept {
+        if constexpr (Debug) {
+            std::cout << "Running batched upward sweep from " << batchSweepStart << "/" << Vertex(upwardSweepGraph.graph.numVertices()) << std::endl;
+            timer.restart();
+        }
+
+        for (Vertex sweepV = batchSweepStart; sweepV < upwardSweepGraph.graph.numVertices(); sweepV++) {
+            BatchLabel& label = batchLabel[upwardSweepGraph.internalToExternal(sweepV)];
+            for (const Edge edge : upwardSweepGraph.graph.edgesFrom(sweepV)) {
+                label.relax(batchLabel[upwardSweepGraph.toVertex[edge]], upwardSweepGraph.graph.get(Weight, edge));
+            }
+        }
+
+        if constexpr (Debug) {
+            std::cout << "Time: " << String::musToString(timer.elapsedMicroseconds()) << std::endl;
+        }
+    }
+
+    template<bool T = UseTargetBuckets, typename = std::enable_if_t<T == UseTargetBuckets && !T>>
+    inline void downwardSweepToTargetsBatch() noexcept {
+        if constexpr (Debug) {
+            std::cout << "Running batched downward sweep to targets" << std::endl;
+            timer.restart();
+        }
+
+        for (const Vertex sweepV : targetGraph.graph.vertices()) {
+            BatchLabel& label = batchLabel[targetGraph.internalToExternal(sweepV)];
+            for (const Edge edge : targetGraph.graph.edgesFrom(sweepV)) {
+                label.relax(batchLabel[targetGraph.toVertex[edge]], targetGraph.graph.get(Weight, edge));
+            }
+        }
+
+        if constexpr (Debug) {
+            std::cout << "Time: " << String::musToString(timer.elapsedMicroseconds()) << std::endl;
+        }
+    }
+
+    inline int getBatchDistance(const size_t lane, const Vertex vertex) const noexcept {
+        AssertMsg(lane < BatchSize, "Lane " << lane << " is out of range!");
+        return batchLabel[originalToInternal(vertex)].distance[lane];
+    }
+
     inline int getDistance(const Vertex vertex) noexcept {
         const Vertex internalVertex = originalToInternal(vertex);
         check(internalVertex);
@@ -267,6 +382,7 @@ private:
         }
     }
 
+    template<bool RECORD_SEARCH_SPACE>
     inline void settle() noexcept {
         const Vertex u = Vertex(Q.extractFront() - &(dijkstraLabel[0]));
         AssertMsg(u < graph[FORWARD].numVertices(), u << " is not a valid vertex!");
@@ -291,6 +407,9 @@ private:
         if constexpr (UseStopBuckets) {
             bucketSources.insert(u);
         }
+        if constexpr (RECORD_SEARCH_SPACE) {
+            upwardSearchSpace.emplace_back(u);
+        }
     }
 
     template<bool T = UseStopBuckets, typename = std::enable_if_t<T == UseStopBuckets && !T>>
@@ -300,18 +419,7 @@ private:
             timer.restart();
         }
 
-        for (const Vertex sweepV : stopGraph.graph.vertices()) {
-            const Vertex v = stopGraph.internalToExternal(sweepV);
-            check(v);
-            for (const Edge edge : stopGraph.graph.edgesFrom(sweepV)) {
-                const Vertex u = stopGraph.toVertex[edge];
-                const int weight = stopGraph.graph.get(Weight, edge);
-                const int newDistance = distance[u] + weight;
-                const bool update = newDistance < distance[v];
-                distance[v] = branchlessConditional(update, newDistance, distance[v]);
-                parent[v] = branchlessConditional(update, parent[u], parent[v]);
-            }
-        }
+        downwardSweep(stopGraph);
 
         if constexpr (Debug) {
             std::cout << "Time: " << String::musToString(timer.elapsedMicroseconds()) << std::endl;
@@ -351,18 +459,7 @@ private:
             timer.restart();
         }
 
-        for (const Vertex sweepV : targetGraph.graph.vertices()) {
-            const Vertex v = targetGraph.internalToExternal(sweepV);
-            check(v);
-            for (const Edge edge : targetGraph.graph.edgesFrom(sweepV)) {
-                const Vertex u = targetGraph.toVertex[edge];
-                const int weight = targetGraph.graph.get(Weight, edge);
-                const int newDistance = distance[u] + weight;
-                const bool update = newDistance < distance[v];
-                distance[v] = branchlessConditional(update, newDistance, distance[v]);
-                parent[v] = branchlessConditional(update, parent[u], parent[v]);
-            }
-        }
+        downwardSweep(targetGraph);
 
         if constexpr (Debug) {
             std::cout << "Time: " << String::musToString(timer.elapsedMicroseconds()) << std::endl;
@@ -394,6 +491,37 @@ private:
         }
     }
 
+    inline void downwardSweep(const SweepGraph& sweepGraph) noexcept {
+        if (sweepThreadPinning.numberOfThreads <= 1) {
+            for (const Vertex sweepV : sweepGraph.graph.vertices()) {
+                sweepVertex(sweepGraph, sweepV);
+            }
+        } else {
+            #pragma omp parallel num_threads(sweepThreadPinning.numberOfThreads)
+            {
+                for (size_t level = 0; level < sweepGraph.numberOfLevels(); level++) {
+                    #pragma omp for schedule(static)
+                    for (size_t i = sweepGraph.levelBegin[level]; i < sweepGraph.levelBegin[level + 1]; i++) {
+                        sweepVertex(sweepGraph, sweepGraph.verticesByLevel[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    inline void sweepVertex(const SweepGraph& sweepGraph, const Vertex sweepV) noexcept {
+        const Vertex v = sweepGraph.internalToExternal(sweepV);
+        check(v);
+        for (const Edge edge : sweepGraph.graph.edgesFrom(sweepV)) {
+            const Vertex u = sweepGraph.toVertex[edge];
+            const int weight = sweepGraph.graph.get(Weight, edge);
+            const int newDistance = distance[u] + weight;
+            const bool update = newDistance < distance[v];
+            distance[v] = branchlessConditional(update, newDistance, distance[v]);
+            parent[v] = branchlessConditional(update, parent[u], parent[v]);
+        }
+    }
+
     inline Vertex originalToInternal(const Vertex vertex) const noexcept {
         return positionInOrder.permutate(vertex);
     }
@@ -433,6 +561,12 @@ private:
 
     IndexedSet<false, Vertex> bucketSources;
 
+    std::vector<Vertex> upwardSearchSpace;
+    std::vector<BatchLabel> batchLabel;
+    Vertex batchSweepStart;
+
+    ThreadPinning sweepThreadPinning;
+
     Timer timer;
 };
 
@@ -66,7 +66,7 @@ public:
         profiler.startPhase();
         sourceStop = source;
         targetStop = target;
-        arrivalTime[sourceStop] = departureTime;
+        setArrivalTime(sourceStop, departureTime);
         relaxEdges(sourceStop, departureTime);
         const ConnectionId firstConnection = firstReachableConnection(departureTime);
         profiler.donePhase(PHASE_INITIALIZATION);
@@ -125,11 +125,22 @@ private:
     inline void clear() {
         sourceStop = noStop;
         targetStop = noStop;
-        Vector::fill(arrivalTime, never);
-        Vector::fill(tripReached, TripFlag());
-        if constexpr (PathRetrieval) {
-            Vector::fill(parentLabel, ParentLabel());
+        for (const StopId stop : touchedStops) {
+            arrivalTime[stop] = never;
+            if constexpr (PathRetrieval) {
+                parentLabel[stop] = ParentLabel();
+            }
         }
+        touchedStops.clear();
+        for (const TripId trip : touchedTrips) {
+            tripReached[trip] = TripFlag();
+        }
+        touchedTrips.clear();
+    }
+
+    inline void setArrivalTime(const StopId stop, const int time) noexcept {
+        if (arrivalTime[stop] == never) touchedStops.emplace_back(stop);
+        arrivalTime[stop] = time;
     }
 
     inline ConnectionId firstReachableConnection(const int departureTime) const noexcept {
@@ -166,6 +177,7 @@ private:
                 suppressUnusedParameterWarning(id);
                 tripReached[connection.tripId] = true;
             }
+            touchedTrips.emplace_back(connection.tripId);
             return true;
         }
         return false;
@@ -174,7 +186,7 @@ private:
     inline void arrivalByTrip(const StopId stop, const int time, const TripId trip) noexcept {
         if (arrivalTime[stop] <= time) return;
         profiler.countMetric(METRIC_STOPS_BY_TRIP);
-        arrivalTime[stop] = time;
+        setArrivalTime(stop, time);
         if constexpr (PathRetrieval) {
             parentLabel[stop].parent = data.connections[tripReached[trip]].departureStopId;
             parentLabel[stop].reachedByTransfer = false;
@@ -195,7 +207,7 @@ private:
     inline void arrivalByTransfer(const StopId stop, const int time, const StopId parent, const Edge edge) noexcept {
         if (arrivalTime[stop] <= time) return;
         profiler.countMetric(METRIC_STOPS_BY_TRANSFER);
-        arrivalTime[stop] = time;
+        setArrivalTime(stop, time);
         if constexpr (PathRetrieval) {
             parentLabel[stop].parent = parent;
             parentLabel[stop].reachedByTransfer = true;
@@ -213,6 +225,9 @@ private:
     std::vector<int> arrivalTime;
     std::vector<ParentLabel> parentLabel;
 
+    std::vector<StopId> touchedStops;
+    std::vector<TripId> touchedTrips;
+
     Profiler profiler;
 };
 }
@@ -92,7 +92,7 @@ public:
         targetVertex = target;
         targetStop = data.isStop(target) ? StopId(target) : StopId(data.numberOfStops());
         if (data.isStop(source)) {
-            arrivalTime[source] = departureTime;
+            setArrivalTime(StopId(source), departureTime);
         }
         runInitialTransfers();
         const ConnectionId firstConnection = firstReachableConnection(departureTime);
@@ -157,13 +157,27 @@ private:
         sourceDepartureTime = never;
         targetVertex = noVertex;
         targetStop = noStop;
-        Vector::fill(arrivalTime, never);
-        Vector::fill(tripReached, TripFlag());
-        Vector::fill(dijkstraLabels, DijkstraLabel());
+        for (const StopId stop : touchedStops) {
+            arrivalTime[stop] = never;
+            if constexpr (PathRetrieval) {
+                parentLabel[stop] = ParentLabel();
+            }
+        }
+        touchedStops.clear();
+        for (const TripId trip : touchedTrips) {
+            tripReached[trip] = TripFlag();
+        }
+        touchedTrips.clear();
         queue.clear();
-        if constexpr (PathRetrieval) {
-            Vector::fill(parentLabel, ParentLabel());
+        for (const Vertex vertex : touchedVertices) {
+            dijkstraLabels[vertex] = DijkstraLabel();
         }
+        touchedVertices.clear();
+    }
+
+    inline void setArrivalTime(const StopId stop, const int time) noexcept {
+        if (arrivalTime[stop] == never) touchedStops.emplace_back(stop);
+        arrivalTime[stop] = time;
     }
 
     inline ConnectionId firstReachableConnection(const int departureTime) const noexcept {
@@ -201,6 +215,7 @@ private:
                 suppressUnusedParameterWarning(id);
                 tripReached[connection.tripId] = true;
             }
+            touchedTrips.emplace_back(connection.tripId);
             return true;
         }
         return false;
@@ -209,7 +224,7 @@ private:
     inline void arrivalByTrip(const StopId stop, const int time, const TripId trip) noexcept {
         if (arrivalTime[stop] <= time) return;
         profiler.countMetric(METRIC_STOPS_BY_TRIP);
-        arrivalTime[stop] = time;
+        setArrivalTime(stop, time);
         if constexpr (PathRetrieval) {
             parentLabel[stop].parent = data.connections[tripReached[trip]].departureStopId;
             parentLabel[stop].tripId = trip;
@@ -262,6 +277,7 @@ private:
 
     inline void arrivalByEdge(const Vertex vertex, const int time, const Vertex parent) noexcept {
         if (dijkstraLabels[vertex].arrivalTime <= time) return;
+        if (dijkstraLabels[vertex].arrivalTime == never) touchedVertices.emplace_back(vertex);
         dijkstraLabels[vertex].arrivalTime = time;
         dijkstraLabels[vertex].parent = parent;
         queue.update(&dijkstraLabels[vertex]);
@@ -270,7 +286,7 @@ private:
     inline void arrivalByTransfer(const StopId stop, const int time, const Vertex parent) noexcept {
         if (arrivalTime[stop] <= time) return;
         profiler.countMetric(METRIC_STOPS_BY_TRANSFER);
-        arrivalTime[stop] = time;
+        setArrivalTime(stop, time);
         if constexpr (PathRetrieval) {
             parentLabel[stop].parent = parent;
             parentLabel[stop].tripId = noTripId;
@@ -294,6 +310,10 @@ private:
     std::vector<DijkstraLabel> dijkstraLabels;
     ExternalKHeap<2, DijkstraLabel> queue;
 
+    std::vector<StopId> touchedStops;
+    std::vector<TripId> touchedTrips;
+    std::vector<Vertex> touchedVertices;
+
     Profiler profiler;
 
 };
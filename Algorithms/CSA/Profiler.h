@@ -9,6 +9,7 @@
 #include "../../DataStructures/CSA/Data.h"
 
 #include "../../Helpers/Types.h"
+#include "../../Helpers/Histogram.h"
 #include "../../Helpers/Timer.h"
 #include "../../Helpers/String/String.h"
 #include "../../Helpers/HighlightText.h"
@@ -168,7 +169,12 @@ public:
         totalTime(0.0),
         phaseTime(NUM_PHASES, 0.0),
         metricValue(NUM_METRICS, 0),
-        numQueries(0) {
+        numQueries(0),
+        queryPhaseTime(NUM_PHASES, 0.0),
+        queryMetricValue(NUM_METRICS, 0),
+        totalTimeHistogram(Histogram::TimeResolution),
+        phaseHistograms(NUM_PHASES, Histogram(Histogram::TimeResolution)),
+        metricHistograms(NUM_METRICS) {
     }
 
     inline void registerPhases(const std::initializer_list<Phase>& phaseList) noexcept {
@@ -188,14 +194,29 @@ public:
         Vector::fill(phaseTime, 0.0);
         Vector::fill(metricValue, (size_t)0);
         numQueries = 0;
+        totalTimeHistogram.clear();
+        for (Histogram& histogram : phaseHistograms) histogram.clear();
+        for (Histogram& histogram : metricHistograms) histogram.clear();
     }
 
     inline void start() noexcept {
+        Vector::fill(queryPhaseTime, 0.0);
+        Vector::fill(queryMetricValue, (size_t)0);
         totalTimer.restart();
     }
 
     inline void done() noexcept {
-        totalTime += totalTimer.elapsedMicroseconds();
+        const double queryTime = totalTimer.elapsedMicroseconds();
+        totalTime += queryTime;
+        totalTimeHistogram.add(queryTime);
+        for (size_t i = 0; i < NUM_PHASES; i++) {
+            phaseTime[i] += queryPhaseTime[i];
+            phaseHistograms[i].add(queryPhaseTime[i]);
+        }
+        for (size_t i = 0; i < NUM_METRICS; i++) {
+            metricValue[i] += queryMetricValue[i];
+            metricHistograms[i].add(uint64_t(queryMetricValue[i]));
+        }
         numQueries++;
     }
 
@@ -204,11 +225,11 @@ public:
     }
 
     inline void donePhase(const Phase phase) noexcept {
-        phaseTime[phase] += phaseTimer.elapsedMicroseconds();
+        queryPhaseTime[phase] += phaseTimer.elapsedMicroseconds();
     }
 
     inline void countMetric(const Metric metric) noexcept {
-        metricValue[metric]++;
+        queryMetricValue[metric]++;
     }
 
     inline double getTotalTime() const noexcept {
@@ -232,9 +253,27 @@ public:
             metricValue[i] += other.metricValue[i];
         }
         numQueries += other.numQueries;
+        totalTimeHistogram += other.totalTimeHistogram;
+        for (size_t i = 0; i < NUM_PHASES; i++) {
+            phaseHistograms[i] += other.phaseHistograms[i];
+        }
+        for (size_t i = 0; i < NUM_METRICS; i++) {
+            metricHistograms[i] += other.metricHistograms[i];
+        }
         return *this;
     }
 
+    template<typename FUNCTION>
+    inline void forEachStatistic(const FUNCTION& function) const noexcept {
+        function("Total time", true, totalTimeHistogram);
+        for (const Phase phase : phases) {
+            function(PhaseNames[phase], true, phaseHistograms[phase]);
+        }
+        for (const Metric metric : metrics) {
+            function(MetricNames[metric], false, metricHistograms[metric]);
+        }
+    }
+
     inline void printStatistics() const noexcept {
         std::cout << std::endl;
         std::cout << "Total time: " << String::musToString(getTotalTime()) << std::endl;
@@ -245,6 +284,14 @@ public:
         for (const Metric metric : metrics) {
             std::cout << MetricNames[metric] << ": " << String::prettyDouble(getMetric(metric)) << std::endl;
         }
+        printPercentiles();
+    }
+
+    inline void printPercentiles() const noexcept {
+        Histogram::printHeader("Per query");
+        forEachStatistic([&](const std::string& name, const bool isTime, const Histogram& histogram) {
+            histogram.print(name, isTime);
+        });
     }
 
 private:
@@ -256,6 +303,11 @@ private:
     std::vector<Metric> metrics;
     std::vector<size_t> metricValue;
     size_t numQueries;
+    std::vector<double> queryPhaseTime;
+    std::vector<size_t> queryMetricValue;
+    Histogram totalTimeHistogram;
+    std::vector<Histogram> phaseHistograms;
+    std::vector<Histogram> metricHistograms;
 };
 
 }
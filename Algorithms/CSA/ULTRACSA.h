@@ -79,7 +79,7 @@ public:
             targetStop = data.isStop(target) ? StopId(target) : StopId(data.numberOfStops());
         }
         if (data.isStop(sourceVertex)) {
-            arrivalTime[sourceVertex] = departureTime;
+            setArrivalTime(StopId(sourceVertex), departureTime);
         }
         runInitialTransfers();
         const ConnectionId firstConnection = firstReachableConnection(departureTime);
@@ -144,11 +144,22 @@ private:
         sourceDepartureTime = never;
         targetVertex = noVertex;
         targetStop = noStop;
-        Vector::fill(arrivalTime, never);
-        Vector::fill(tripReached, TripFlag());
-        if constexpr (PathRetrieval) {
-            Vector::fill(parentLabel, ParentLabel());
+        for (const StopId stop : touchedStops) {
+            arrivalTime[stop] = never;
+            if constexpr (PathRetrieval) {
+                parentLabel[stop] = ParentLabel();
+            }
         }
+        touchedStops.clear();
+        for (const TripId trip : touchedTrips) {
+            tripReached[trip] = TripFlag();
+        }
+        touchedTrips.clear();
+    }
+
+    inline void setArrivalTime(const StopId stop, const int time) noexcept {
+        if (arrivalTime[stop] == never) touchedStops.emplace_back(stop);
+        arrivalTime[stop] = time;
     }
 
     inline ConnectionId firstReachableConnection(const int departureTime) const noexcept {
@@ -185,6 +196,7 @@ private:
                 suppressUnusedParameterWarning(id);
                 tripReached[connection.tripId] = true;
             }
+            touchedTrips.emplace_back(connection.tripId);
             return true;
         }
         return false;
@@ -193,7 +205,7 @@ private:
     inline void arrivalByTrip(const StopId stop, const int time, const TripId trip) noexcept {
         if (arrivalTime[stop] <= time) return;
         profiler.countMetric(METRIC_STOPS_BY_TRIP);
-        arrivalTime[stop] = time;
+        setArrivalTime(stop, time);
         if constexpr (PathRetrieval) {
             parentLabel[stop].parent = data.connections[tripReached[trip]].departureStopId;
             parentLabel[stop].reachedByTransfer = false;
@@ -233,7 +245,7 @@ private:
     inline void arrivalByTransfer(const StopId stop, const int time, const Vertex parent, const Edge edge) noexcept {
         if (arrivalTime[stop] <= time) return;
         profiler.countMetric(METRIC_STOPS_BY_TRANSFER);
-        arrivalTime[stop] = time;
+        setArrivalTime(stop, time);
         if constexpr (PathRetrieval) {
             parentLabel[stop].parent = parent;
             parentLabel[stop].reachedByTransfer = true;
@@ -254,6 +266,9 @@ private:
     std::vector<int> arrivalTime;
     std::vector<ParentLabel> parentLabel;
 
+    std::vector<StopId> touchedStops;
+    std::vector<TripId> touchedTrips;
+
     Profiler profiler;
 
 };
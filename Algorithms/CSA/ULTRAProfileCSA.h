@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "../CH/CH.h"
+#include "../RAPTOR/InitialTransfers.h"
+
+#include "../../Helpers/Assert.h"
+#include "../../Helpers/Timer.h"
+#include "../../Helpers/Types.h"
+#include "../../Helpers/Vector/Vector.h"
+#include "../../DataStructures/CSA/Data.h"
+#include "../../DataStructures/CSA/Entities/ProfileEntry.h"
+#include "Profiler.h"
+
+namespace CSA {
+
+// Profile Connection Scan (pCSA) with ULTRA shortcuts: computes all Pareto-optimal (departure time, arrival time)
+// pairs for journeys from source to target that depart within [minDepartureTime, maxDepartureTime].
+// The connections are scanned in descending order of departure time. Every stop keeps the profile of boarding a trip
+// at the stop, and every trip keeps the earliest arrival time at the target when staying seated. Like ULTRACSA, the
+// initial and final transfers are computed with Bucket-CH and at most one shortcut is used between two trips.
+template<typename PROFILER = NoProfiler>
+class ULTRAProfileCSA {
+
+public:
+    using InitialTransferGraph = CHGraph;
+    using Profiler = PROFILER;
+    using Type = ULTRAProfileCSA<Profiler>;
+
+public:
+    ULTRAProfileCSA(const Data& data, const CH::CH& chData, const Profiler& profilerTemplate = Profiler()) :
+        data(data),
+        initialTransfers(chData, FORWARD, data.numberOfStops()),
+        sourceVertex(noVertex),
+        targetVertex(noVertex),
+        targetStop(noStop),
+        minDepartureTime(never),
+        maxDepartureTime(never),
+        earliestArrivalTime(never),
+        tripReached(data.numberOfTrips(), false),
+        arrivalTime(data.numberOfStops() + 1, never),
+        tripArrivalTime(data.numberOfTrips(), never),
+        stopProfile(data.numberOfStops()),
+        profiler(profilerTemplate) {
+        AssertMsg(!Graph::hasLoops(data.transferGraph), "Shortcut graph may not have loops!");
+        AssertMsg(Vector::isSorted(data.connections), "Connections must be sorted in ascending order!");
+        profiler.registerPhases({PHASE_CLEAR, PHASE_INITIALIZATION, PHASE_CONNECTION_SCAN});
+        profiler.registerMetrics({METRIC_CONNECTIONS, METRIC_EDGES, METRIC_STOPS_BY_TRIP, METRIC_STOPS_BY_TRANSFER});
+        profiler.initialize();
+    }
+
+    // The earliest arrival time for the latest departure time bounds the scan: No connection departing after it can
+    // be part of a journey that departs within the time range and is not dominated.
+    inline void run(const Vertex source, const int minTime, const int maxTime, const Vertex target) noexcept {
+        AssertMsg(target != noVertex, "Profile queries require a target vertex!");
+        AssertMsg(minTime <= maxTime, "Departure time range [" << minTime << ", " << maxTime << "] is empty!");
+        profiler.start();
+
+        profiler.startPhase();
+        clear();
+        profiler.donePhase(PHASE_CLEAR);
+
+        profiler.startPhase();
+        sourceVertex = source;
+        targetVertex = target;
+        targetStop = data.isStop(target) ? StopId(target) : StopId(data.numberOfStops());
+        minDepartureTime = minTime;
+        maxDepartureTime = maxTime;
+        initialTransfers.run(sourceVertex, targetVertex);
+        computeEarliestArrivalTime();
+        const ConnectionId firstConnection = firstReachableConnection(minDepartureTime);
+        const ConnectionId lastConnection = (earliestArrivalTime == never) ? firstConnection : firstReachableConnection(earliestArrivalTime + 1);
+        profiler.donePhase(PHASE_INITIALIZATION);
+
+        profiler.startPhase();
+        scanConnections(firstConnection, lastConnection);
+        collectProfile();
+        profiler.donePhase(PHASE_CONNECTION_SCAN);
+
+        profiler.done();
+    }
+
+    // Profile entries ordered by descending departure time. The first entry may depart after maxDepartureTime, if it is
+    // the best journey for the departure times after the last entry within the range. Journeys that walk directly from
+    // source to target are not included; entries that are dominated by walking are removed.
+    inline const std::vector<ProfileEntry>& getProfile() const noexcept {
+        return profile;
+    }
+
+    inline int getDirectTransferTime() const noexcept {
+        return initialTransfers.getDistance();
+    }
+
+    // Earliest arrival time at the target when departing at the given time, including the direct transfer.
+    inline int getEarliestArrivalTime(const int departureTime) const noexcept {
+        AssertMsg(departureTime >= minDepartureTime && departureTime <= maxDepartureTime, "Departure time " << departureTime << " is outside of the profile range!");
+        const size_t entry = firstEntryDepartingBefore(profile, departureTime);
+        const int walkingArrivalTime = (getDirectTransferTime() == INFTY) ? never : departureTime + getDirectTransferTime();
+        return (entry == 0) ? walkingArrivalTime : std::min(walkingArrivalTime, profile[entry - 1].arrivalTime);
+    }
+
+    inline const Profiler& getProfiler() const noexcept {
+        return profiler;
+    }
+
+private:
+    inline void clear() noexcept {
+        sourceVertex = noVertex;
+        targetVertex = noVertex;
+        targetStop = noStop;
+        minDepartureTime = never;
+        maxDepartureTime = never;
+        earliestArrivalTime = never;
+        for (const StopId stop : touchedStops) {
+            arrivalTime[stop] = never;
+        }
+        touchedStops.clear();
+        for (const TripId trip : touchedTrips) {
+            tripReached[trip] = false;
+        }
+        touchedTrips.clear();
+        for (const StopId stop : profileStops) {
+            stopProfile[stop].clear();
+        }
+        profileStops.clear();
+        for (const TripId trip : profileTrips) {
+            tripArrivalTime[trip] = never;
+        }
+        profileTrips.clear();
+        sourceProfile.clear();
+        profile.clear();
+    }
+
+    inline ConnectionId firstReachableConnection(const int departureTime) const noexcept {
+        return ConnectionId(Vector::lowerBound(data.connections, departureTime, [](const Connection& connection, const int time) {
+            return connection.departureTime < time;
+        }));
+    }
+
+    // Forward earliest arrival scan for maxDepartureTime, as in ULTRACSA without parent pointers.
+    inline void computeEarliestArrivalTime() noexcept {
+        if (data.isStop(sourceVertex)) {
+            arrivalByTransfer(StopId(sourceVertex), maxDepartureTime);
+        }
+        for (const Vertex stop : initialTransfers.getForwardPOIs()) {
+            AssertMsg(data.isStop(stop), "Reached POI " << stop << " is not a stop!");
+            profiler.countMetric(METRIC_EDGES);
+            arrivalByTransfer(StopId(stop), maxDepartureTime + initialTransfers.getForwardDistance(stop));
+        }
+        if (initialTransfers.getDistance() != INFTY) {
+            profiler.countMetric(METRIC_EDGES);
+            arrivalByTransfer(targetStop, maxDepartureTime + initialTransfers.getDistance());
+        }
+        for (ConnectionId i = firstReachableConnection(maxDepartureTime); i < data.connections.size(); i++) {
+            const Connection& connection = data.connections[i];
+            if (connection.departureTime > arrivalTime[targetStop]) break;
+            if (!tripReached[connection.tripId]) {
+                if (arrivalTime[connection.departureStopId] > connection.departureTime - data.minTransferTime(connection.departureStopId)) continue;
+                tripReached[connection.tripId] = true;
+                touchedTrips.emplace_back(connection.tripId);
+            }
+            profiler.countMetric(METRIC_CONNECTIONS);
+            if (arrivalTime[connection.arrivalStopId] <= connection.arrivalTime) continue;
+            arrivalByTransfer(connection.arrivalStopId, connection.arrivalTime);
+            for (const Edge edge : data.transferGraph.edgesFrom(connection.arrivalStopId)) {
+                profiler.countMetric(METRIC_EDGES);
+                arrivalByTransfer(StopId(data.transferGraph.get(ToVertex, edge)), connection.arrivalTime + data.transferGraph.get(TravelTime, edge));
+            }
+            if (initialTransfers.getBackwardDistance(connection.arrivalStopId) != INFTY) {
+                profiler.countMetric(METRIC_EDGES);
+                arrivalByTransfer(targetStop, connection.arrivalTime + initialTransfers.getBackwardDistance(connection.arrivalStopId));
+            }
+        }
+        earliestArrivalTime = arrivalTime[targetStop];
+    }
+
+    inline void arrivalByTransfer(const StopId stop, const int time) noexcept {
+        if (arrivalTime[stop] <= time) return;
+        profiler.countMetric(METRIC_STOPS_BY_TRANSFER);
+        if (arrivalTime[stop] == never) touchedStops.emplace_back(stop);
+        arrivalTime[stop] = time;
+    }
+
+    inline void scanConnections(const ConnectionId begin, const ConnectionId end) noexcept {
+        for (size_t i = end; i > begin; i--) {
+            const Connection& connection = data.connections[i - 1];
+            profiler.countMetric(METRIC_CONNECTIONS);
+            int time = std::min(tripArrivalTime[connection.tripId], arrivalTimeAfterTrip(connection.arrivalStopId, connection.arrivalTime));
+            if (time > earliestArrivalTime) continue;
+            if (tripArrivalTime[connection.tripId] == never) profileTrips.emplace_back(connection.tripId);
+            tripArrivalTime[connection.tripId] = time;
+            addProfileEntry(connection.departureStopId, connection.departureTime - data.minTransferTime(connection.departureStopId), time);
+        }
+    }
+
+    // Arrival time at the target after leaving a trip at the given stop: Either by the final transfer, by boarding
+    // another trip at the stop, or by taking a shortcut and boarding another trip there.
+    inline int arrivalTimeAfterTrip(const StopId stop, const int time) noexcept {
+        if (stop == targetStop) return time;
+        int result = arrivalTimeByBoarding(stop, time);
+        if (initialTransfers.getBackwardDistance(stop) != INFTY) {
+            result = std::min(result, time + initialTransfers.getBackwardDistance(stop));
+        }
+        for (const Edge edge : data.transferGraph.edgesFrom(stop)) {
+            profiler.countMetric(METRIC_EDGES);
+            result = std::min(result, arrivalTimeByBoarding(StopId(data.transferGraph.get(ToVertex, edge)), time + data.transferGraph.get(TravelTime, edge)));
+        }
+        return result;
+    }
+
+    // The entries of a stop profile are ordered by descending departure time and strictly decreasing arrival time,
+    // so the earliest arrival is found at the last entry that departs no earlier than the given time.
+    inline int arrivalTimeByBoarding(const StopId stop, const int time) const noexcept {
+        const std::vector<ProfileEntry>& entries = stopProfile[stop];
+        if (entries.empty()) return never;
+        if (entries.back().departureTime >= time) return entries.back().arrivalTime;
+        const size_t entry = firstEntryDepartingBefore(entries, time);
+        return (entry == 0) ? never : entries[entry - 1].arrivalTime;
+    }
+
+    inline static size_t firstEntryDepartingBefore(const std::vector<ProfileEntry>& entries, const int time) noexcept {
+        return std::partition_point(entries.begin(), entries.end(), [&](const ProfileEntry& entry) {
+            return entry.departureTime >= time;
+        }) - entries.begin();
+    }
+
+    inline void addProfileEntry(const StopId stop, const int departureTime, const int time) noexcept {
+        std::vector<ProfileEntry>& entries = stopProfile[stop];
+        if (entries.empty()) {
+            profileStops.emplace_back(stop);
+        } else if (entries.back().arrivalTime <= time) {
+            return;
+        }
+        profiler.countMetric(METRIC_STOPS_BY_TRIP);
+        if (!entries.empty() && entries.back().departureTime == departureTime) {
+            entries.back().arrivalTime = time;
+        } else {
+            entries.emplace_back(departureTime, time);
+        }
+        const int transferTime = (stop == sourceVertex) ? 0 : initialTransfers.getForwardDistance(stop);
+        if (transferTime == INFTY) return;
+        const int sourceDepartureTime = departureTime - transferTime;
+        if (sourceDepartureTime < minDepartureTime) return;
+        sourceProfile.emplace_back(sourceDepartureTime, time);
+    }
+
+    // The initial transfers differ in length, so the entries at the source are not created in order of departure time.
+    // Of the entries departing after maxDepartureTime, only the earliest one is kept.
+    inline void collectProfile() noexcept {
+        std::sort(sourceProfile.begin(), sourceProfile.end(), [](const ProfileEntry& a, const ProfileEntry& b) {
+            return (a.departureTime > b.departureTime) || ((a.departureTime == b.departureTime) && (a.arrivalTime < b.arrivalTime));
+        });
+        for (const ProfileEntry& entry : sourceProfile) {
+            if (!profile.empty() && profile.back().arrivalTime <= entry.arrivalTime) continue;
+            if (getDirectTransferTime() != INFTY && entry.travelTime() >= getDirectTransferTime()) continue;
+            if (entry.departureTime > maxDepartureTime && !profile.empty()) profile.pop_back();
+            profile.emplace_back(entry);
+        }
+    }
+
+private:
+    const Data& data;
+    RAPTOR::BucketCHInitialTransfers initialTransfers;
+
+    Vertex sourceVertex;
+    Vertex targetVertex;
+    StopId targetStop;
+    int minDepartureTime;
+    int maxDepartureTime;
+    int earliestArrivalTime;
+
+    std::vector<bool> tripReached;
+    std::vector<int> arrivalTime;
+    std::vector<StopId> touchedStops;
+    std::vector<TripId> touchedTrips;
+
+    std::vector<int> tripArrivalTime;
+    std::vector<std::vector<ProfileEntry>> stopProfile;
+    std::vector<StopId> profileStops;
+    std::vector<TripId> profileTrips;
+
+    std::vector<ProfileEntry> sourceProfile;
+    std::vector<ProfileEntry> profile;
+
+    Profiler profiler;
+
+};
+}
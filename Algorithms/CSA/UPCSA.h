@@ -30,6 +30,7 @@ public:
     using Type = UPCSA<UseStopBuckets, UseTargetBuckets, PathRetrieval, Profiler>;
     using InitialAndFinalTransfers = RAPTOR::BasicInitialAndFinalTransfers<Debug, UseStopBuckets, UseTargetBuckets>;
     using TripFlag = Meta::IF<PathRetrieval, ConnectionId, bool>;
+    constexpr static size_t BatchSize = InitialAndFinalTransfers::BatchSize;
 
 private:
     inline static Order vertexOrder(const CH::CH& chData, const bool useDFSOrder) noexcept {
@@ -96,10 +97,10 @@ private:
     };
 
 public:
-    UPCSA(const Data& oldData, const CH::CH& oldCHData, const IndexedSet<false, Vertex>& oldTargets, const bool reorder, const bool useDFSOrder, const Profiler& profilerTemplate = Profiler()) :
+    UPCSA(const Data& oldData, const CH::CH& oldCHData, const IndexedSet<false, Vertex>& oldTargets, const bool reorder, const bool useDFSOrder, const Profiler& profilerTemplate = Profiler(), const ThreadPinning& threadPinning = ThreadPinning(1, 1)) :
         queryData(oldData, oldCHData, oldTargets, reorder, useDFSOrder),
         data(queryData.data),
-        initialAndFinalTransfers(queryData.chData, queryData.phastOrder, data.numberOfStops(), queryData.targets),
+        initialAndFinalTransfers(queryData.chData, queryData.phastOrder, data.numberOfStops(), queryData.targets, FORWARD, threadPinning),
         sourceVertex(noVertex),
         sourceDepartureTime(never),
         targetVertices(queryData.targets),
@@ -149,6 +150,67 @@ public:
         profiler.done();
     }
 
+    // Runs up to BatchSize queries at once. The initial transfers and connection scans are run for each source
+    // separately, the final transfers of all sources are evaluated by one batched upward and downward sweep.
+    // The whole batch is counted as a single query by the profiler.
+    template<bool T = UseTargetBuckets, typename = std::enable_if_t<T == UseTargetBuckets && !T>>
+    inline void runBatch(const std::vector<Vertex>& sources, const std::vector<int>& departureTimes) noexcept {
+        AssertMsg(sources.size() == departureTimes.size(), "Number of sources (" << sources.size() << ") and departure times (" << departureTimes.size() << ") differ!");
+        AssertMsg(sources.size() <= BatchSize, "Batch contains " << sources.size() << " sources, but only " << BatchSize << " are supported!");
+        profiler.start();
+
+        profiler.startPhase();
+        initialAndFinalTransfers.initializeBatch();
+        profiler.donePhase(PHASE_CLEAR);
+
+        for (size_t lane = 0; lane < sources.size(); lane++) {
+            profiler.startPhase();
+            clear();
+            profiler.donePhase(PHASE_CLEAR);
+
+            profiler.startPhase();
+            sourceVertex = Vertex(queryData.externalToInternal[sources[lane]]);
+            sourceDepartureTime = departureTimes[lane];
+            initialAndFinalTransfers.initialize();
+            if (data.isStop(sourceVertex)) {
+                arrivalTime[sourceVertex] = sourceDepartureTime;
+            }
+            runInitialTransfers<true>();
+            initialAndFinalTransfers.addUpwardSearchToBatch(lane);
+            const ConnectionId firstConnection = firstReachableConnection(sourceDepartureTime);
+            profiler.donePhase(PHASE_INITIALIZATION);
+
+            profiler.startPhase();
+            scanConnections(firstConnection, ConnectionId(data.connections.size()));
+            profiler.donePhase(PHASE_CONNECTION_SCAN);
+
+            profiler.startPhase();
+            for (const StopId stop : data.stops()) {
+                initialAndFinalTransfers.addBatchSource(lane, stop, arrivalTime[stop]);
+            }
+            profiler.donePhase(PHASE_UPWARD_SWEEP);
+        }
+
+        profiler.startPhase();
+        initialAndFinalTransfers.upwardSweepBatch();
+        profiler.donePhase(PHASE_UPWARD_SWEEP);
+        profiler.startPhase();
+        initialAndFinalTransfers.downwardSweepToTargetsBatch();
+        profiler.donePhase(PHASE_DOWNWARD_SEARCH);
+
+        profiler.done();
+    }
+
+    inline int getBatchEarliestArrivalTime(const size_t lane, const Vertex vertex) const noexcept {
+        const Vertex internalVertex(queryData.externalToInternal[vertex]);
+        AssertMsg(targetVertices.contains(internalVertex), "Vertex " << internalVertex << " is not a target!");
+        return initialAndFinalTransfers.getBatchDistance(lane, internalVertex);
+    }
+
+    inline void useParallelSweeps(const ThreadPinning& threadPinning) noexcept {
+        initialAndFinalTransfers.useParallelSweeps(threadPinning);
+    }
+
     inline bool reachable(const Vertex vertex) noexcept {
         const Vertex internalVertex(queryData.externalToInternal[vertex]);
         AssertMsg(targetVertices.contains(internalVertex), "Vertex " << internalVertex << " is not a target!");
@@ -213,6 +275,10 @@ public:
         return profiler;
     }
 
+    inline Profiler& getProfiler() noexcept {
+        return profiler;
+    }
+
     inline long long getUpwardSweepGraphVertices() const noexcept {
         return initialAndFinalTransfers.getUpwardSweepGraphVertices();
     }
@@ -304,9 +370,10 @@ private:
         }
     }
 
+    template<bool FOR_BATCH = false>
     inline void runInitialTransfers() noexcept {
         initialAndFinalTransfers.template addSource<false>(sourceVertex, sourceDepartureTime, sourceVertex);
-        initialAndFinalTransfers.upwardSearch();
+        initialAndFinalTransfers.template upwardSearch<FOR_BATCH>();
         initialAndFinalTransfers.downwardSearchToStops();
         for (const StopId stop : data.stops()) {
             arrivalByTransfer(stop, initialAndFinalTransfers.getDistance(stop), sourceVertex, noEdge);
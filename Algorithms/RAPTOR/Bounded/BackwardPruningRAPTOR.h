@@ -164,9 +164,14 @@ private:
             AssertMsg(trip[stopIndex].departureTime >= previousRoundLabel(stop).arrivalTimeByTransfer, "Cannot scan a route after the last trip has departed (Route: " << route << ", Stop: " << stop << ", StopIndex: " << stopIndex << ", Time: " << previousRoundLabel(stop).arrivalTimeByTransfer << ", LastDeparture: " << trip[stopIndex].departureTime << ", RoundIndex: " << roundIndex << ")!");
 
             StopIndex parentIndex = stopIndex;
+            const int* departureTimes = data.departureTimesOfRoute(route);
+            const size_t numberOfTrips = data.numberOfTripsInRoute(route);
+            size_t tripIndex = numberOfTrips - 1;
             while (stopIndex < tripSize - 1) {
-                while ((trip > firstTrip) && ((trip - tripSize + stopIndex)->departureTime >= previousRoundLabel(stop).arrivalTimeByTransfer)) {
-                    trip -= tripSize;
+                const size_t earliestTrip = findEarliestTripBackward(departureTimes + (stopIndex * numberOfTrips), tripIndex, previousRoundLabel(stop).arrivalTimeByTransfer);
+                if (earliestTrip < tripIndex) {
+                    tripIndex = earliestTrip;
+                    trip = firstTrip + (tripIndex * tripSize);
                     parentIndex = stopIndex;
                 }
                 stopIndex++;
@@ -231,13 +231,17 @@ public:
         stopsUpdatedByTransfer.clear();
         routesServingUpdatedStops.clear();
         if constexpr (RESET_CAPACITIES) {
-            std::vector<Round>().swap(rounds);
+            rounds.reset();
             std::vector<BestBagType>(bestLabelsByRoute.size()).swap(bestLabelsByRoute);
             std::vector<BestBagType>(bestLabelsByTransfer.size()).swap(bestLabelsByTransfer);
         } else {
             rounds.clear();
-            Vector::fill(bestLabelsByRoute);
-            Vector::fill(bestLabelsByTransfer);
+            for (BestBagType& bag : bestLabelsByRoute) {
+                bag.clear();
+            }
+            for (BestBagType& bag : bestLabelsByTransfer) {
+                bag.clear();
+            }
         }
     }
 
@@ -285,18 +289,17 @@ private:
             StopId stop = stops[stopIndex];
 
             const StopEvent* firstTrip = data.firstTripOfRoute(route);
-            const StopEvent* lastTrip = data.lastTripOfRoute(route);
+            const int* departureTimes = data.departureTimesOfRoute(route);
+            const size_t numberOfTrips = data.numberOfTripsInRoute(route);
 
-            RouteBagType routeBag;
+            routeBag.clear();
 
             while (stopIndex < tripSize - 1) {
                 for (size_t i = 0; i < previousRound()[stop].size(); i++) {
                     const Label& label = previousRound()[stop][i];
-                    const StopEvent* trip = firstTrip;
-                    while ((trip < lastTrip) && (trip[stopIndex].departureTime < label.arrivalTime)) {
-                        trip += tripSize;
-                    }
-                    if (trip[stopIndex].departureTime < label.arrivalTime) continue;
+                    const size_t tripIndex = findEarliestTripForward(departureTimes + (stopIndex * numberOfTrips), 0, numberOfTrips, label.arrivalTime);
+                    if (tripIndex == numberOfTrips) continue;
+                    const StopEvent* trip = firstTrip + (tripIndex * tripSize);
 
                     RouteLabel newLabel;
                     newLabel.trip = trip;
@@ -366,7 +369,7 @@ private:
     }
 
     inline void startNewRound() noexcept {
-        rounds.emplace_back(data.numberOfStops());
+        rounds.addRound(data.numberOfStops());
     }
 
     inline size_t currentNumberOfTrips() const noexcept {
@@ -425,7 +428,8 @@ private:
     ForwardPruningRAPTOR<Profiler> forwardPruningRAPTOR;
     BackwardPruningRAPTOR<Profiler> backwardPruningRAPTOR;
 
-    std::vector<Round> rounds;
+    BagRounds<BagType> rounds;
+    RouteBagType routeBag;
 
     size_t maxTrips;
 
@@ -238,11 +238,13 @@ public:
         targetStop = StopId(data.numberOfStops());
         queue.clear();
         if constexpr (RESET_CAPACITIES) {
-            std::vector<Round>().swap(rounds);
+            rounds.reset();
             std::vector<DijkstraBagType>(dijkstraBags.size()).swap(dijkstraBags);
         } else {
             rounds.clear();
-            Vector::fill(dijkstraBags);
+            for (DijkstraBagType& bag : dijkstraBags) {
+                bag.clear();
+            }
         }
     }
 
@@ -298,18 +300,17 @@ private:
             StopId stop = stops[stopIndex];
 
             const StopEvent* firstTrip = data.firstTripOfRoute(route);
-            const StopEvent* lastTrip = data.lastTripOfRoute(route);
+            const int* departureTimes = data.departureTimesOfRoute(route);
+            const size_t numberOfTrips = data.numberOfTripsInRoute(route);
 
-            RouteBagType routeBag;
+            routeBag.clear();
 
             while (stopIndex < tripSize - 1) {
                 for (size_t i = 0; i < previousRound()[stop].size(); i++) {
                     const Label& label = previousRound()[stop][i];
-                    const StopEvent* trip = firstTrip;
-                    while ((trip < lastTrip) && (trip[stopIndex].departureTime < label.arrivalTime)) {
-                        trip += tripSize;
-                    }
-                    if (trip[stopIndex].departureTime < label.arrivalTime) continue;
+                    const size_t tripIndex = findEarliestTripForward(departureTimes + (stopIndex * numberOfTrips), 0, numberOfTrips, label.arrivalTime);
+                    if (tripIndex == numberOfTrips) continue;
+                    const StopEvent* trip = firstTrip + (tripIndex * tripSize);
 
                     RouteLabel newLabel;
                     newLabel.trip = trip;
@@ -414,7 +415,7 @@ private:
     }
 
     inline void startNewRound() noexcept {
-        rounds.emplace_back(data.numberOfStops() + 1);
+        rounds.addRound(data.numberOfStops() + 1);
     }
 
     inline void arrivalByRoute(const StopId stop, const Label& label) noexcept {
@@ -464,7 +465,8 @@ private:
 
     CoreCHInitialTransfers initialTransfers;
 
-    std::vector<Round> rounds;
+    BagRounds<BagType> rounds;
+    RouteBagType routeBag;
 
     IndexedSet<false, StopId> stopsUpdatedByRoute;
     IndexedSet<false, StopId> stopsUpdatedByTransfer;
@@ -96,28 +96,37 @@ private:
     };
 
     struct SeparatedBestBag {
-        inline Bag<BestLabel>& byRoute() noexcept {
+        inline ParetoBag& byRoute() noexcept {
             return labelsByRoute;
         }
 
-        inline Bag<BestLabel>& byTransfer() noexcept {
+        inline ParetoBag& byTransfer() noexcept {
             return labelsByTransfer;
         }
 
-        Bag<BestLabel> labelsByRoute;
-        Bag<BestLabel> labelsByTransfer;
+        inline void clear() noexcept {
+            labelsByRoute.clear();
+            labelsByTransfer.clear();
+        }
+
+        ParetoBag labelsByRoute;
+        ParetoBag labelsByTransfer;
     };
 
     struct CombinedBestBag {
-        inline Bag<BestLabel>& byRoute() noexcept {
+        inline ParetoBag& byRoute() noexcept {
             return labels;
         }
 
-        inline Bag<BestLabel>& byTransfer() noexcept {
+        inline ParetoBag& byTransfer() noexcept {
             return labels;
         }
 
-        Bag<BestLabel> labels;
+        inline void clear() noexcept {
+            labels.clear();
+        }
+
+        ParetoBag labels;
     };
 
     using BagType = Bag<Label>;
@@ -227,11 +236,13 @@ public:
         targetStop = noStop;
         sourceDepartureTime = never;
         if constexpr (RESET_CAPACITIES) {
-            std::vector<Round>().swap(rounds);
+            rounds.reset();
             std::vector<BestBag>(bestLabels.size()).swap(bestLabels);
         } else {
             rounds.clear();
-            Vector::fill(bestLabels);
+            for (BestBag& bag : bestLabels) {
+                bag.clear();
+            }
         }
     }
 
@@ -282,18 +293,17 @@ private:
             StopId stop = stops[stopIndex];
 
             const StopEvent* firstTrip = data.firstTripOfRoute(route);
-            const StopEvent* lastTrip = data.lastTripOfRoute(route);
+            const int* departureTimes = data.departureTimesOfRoute(route);
+            const size_t numberOfTrips = data.numberOfTripsInRoute(route);
 
-            RouteBagType routeBag;
+            routeBag.clear();
 
             while (stopIndex < tripSize - 1) {
                 for (size_t i = 0; i < previousRound()[stop].size(); i++) {
                     const Label& label = previousRound()[stop][i];
-                    const StopEvent* trip = firstTrip;
-                    while ((trip < lastTrip) && (trip[stopIndex].departureTime < label.arrivalTime)) {
-                        trip += tripSize;
-                    }
-                    if (trip[stopIndex].departureTime < label.arrivalTime) continue;
+                    const size_t tripIndex = findEarliestTripForward(departureTimes + (stopIndex * numberOfTrips), 0, numberOfTrips, label.arrivalTime);
+                    if (tripIndex == numberOfTrips) continue;
+                    const StopEvent* trip = firstTrip + (tripIndex * tripSize);
 
                     RouteLabel newLabel;
                     newLabel.trip = trip;
@@ -363,7 +373,7 @@ private:
     }
 
     inline void startNewRound() noexcept {
-        rounds.emplace_back(data.numberOfStops());
+        rounds.addRound(data.numberOfStops());
     }
 
     inline void arrivalByTransfer(const StopId stop, const Label& label) noexcept {
@@ -403,7 +413,8 @@ private:
 private:
     const Data& data;
 
-    std::vector<Round> rounds;
+    BagRounds<BagType> rounds;
+    RouteBagType routeBag;
 
     std::vector<BestBag> bestLabels;
 
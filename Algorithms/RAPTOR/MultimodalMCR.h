@@ -407,18 +407,17 @@ private:
             StopId stop = stops[stopIndex];
 
             const StopEvent* firstTrip = data.raptorData.firstTripOfRoute(route);
-            const StopEvent* lastTrip = data.raptorData.lastTripOfRoute(route);
+            const int* departureTimes = data.raptorData.departureTimesOfRoute(route);
+            const size_t numberOfTrips = data.raptorData.numberOfTripsInRoute(route);
 
             RouteBagType routeBag;
 
             while (stopIndex < tripSize - 1) {
                 for (size_t i = 0; i < previousRound()[stop].size(); i++) {
                     const Label& label = previousRound()[stop][i];
-                    const StopEvent* trip = firstTrip;
-                    while ((trip < lastTrip) && (trip[stopIndex].departureTime < label.arrivalTime)) {
-                        trip += tripSize;
-                    }
-                    if (trip[stopIndex].departureTime < label.arrivalTime) continue;
+                    const size_t tripIndex = findEarliestTripForward(departureTimes + (stopIndex * numberOfTrips), 0, numberOfTrips, label.arrivalTime);
+                    if (tripIndex == numberOfTrips) continue;
+                    const StopEvent* trip = firstTrip + (tripIndex * tripSize);
                     routeBag.merge(RouteLabel(trip, label, stopIndex, i));
                 }
                 stopIndex++;
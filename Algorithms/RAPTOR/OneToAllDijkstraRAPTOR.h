@@ -232,9 +232,14 @@ private:
 
             StopIndex parentIndex = stopIndex;
             const StopEvent* firstTrip = data.firstTripOfRoute(route);
+            const int* departureTimes = data.departureTimesOfRoute(route);
+            const size_t numberOfTrips = data.numberOfTripsInRoute(route);
+            size_t tripIndex = numberOfTrips - 1;
             while (stopIndex < tripSize - 1) {
-                while ((trip > firstTrip) && ((trip - tripSize + stopIndex)->departureTime >= previousRound()[stop].arrivalTime)) {
-                    trip -= tripSize;
+                const size_t earliestTrip = findEarliestTripBackward(departureTimes + (stopIndex * numberOfTrips), tripIndex, previousRound()[stop].arrivalTime);
+                if (earliestTrip < tripIndex) {
+                    tripIndex = earliestTrip;
+                    trip = firstTrip + (tripIndex * tripSize);
                     parentIndex = stopIndex;
                 }
                 stopIndex++;
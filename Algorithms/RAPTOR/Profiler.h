@@ -8,6 +8,7 @@
 #include "../../DataStructures/RAPTOR/Data.h"
 
 #include "../../Helpers/Timer.h"
+#include "../../Helpers/Histogram.h"
 
 namespace RAPTOR {
 
@@ -92,6 +93,7 @@ public:
     inline void startRound() const noexcept {}
     inline void startExtraRound(const ExtraRound) const noexcept {}
     inline void doneRound() const noexcept {}
+    inline void restartRounds() const noexcept {}
 
     inline void startPhase() const noexcept {}
     inline void donePhase(const Phase) const noexcept {}
@@ -399,7 +401,10 @@ public:
         inExtraRound(false),
         numQueries(0),
         numRounds(0),
-        totalNumRounds(0) {
+        totalNumRounds(0),
+        totalTimeHistogram(Histogram::TimeResolution),
+        phaseHistograms(NUM_PHASES, Histogram(Histogram::TimeResolution)),
+        metricHistograms(NUM_METRICS) {
     }
 
     inline void registerExtraRounds(const std::initializer_list<ExtraRound>& extraRoundList) noexcept {
@@ -429,17 +434,32 @@ public:
         numQueries = 0;
         numRounds = 0;
         totalNumRounds = 0;
+        totalTimeHistogram.clear();
+        roundsHistogram.clear();
+        for (Histogram& histogram : phaseHistograms) histogram.clear();
+        for (Histogram& histogram : metricHistograms) histogram.clear();
     }
 
     inline void start() noexcept {
         currentRoundData = NULL;
         numRounds = 0;
         inExtraRound = false;
+        Vector::fill(queryData.metricValue, 0LL);
+        Vector::fill(queryData.phaseTime, 0.0);
         totalTimer.restart();
     }
 
     inline void done() noexcept {
-        totalTime += totalTimer.elapsedMicroseconds();
+        const double queryTime = totalTimer.elapsedMicroseconds();
+        totalTime += queryTime;
+        totalTimeHistogram.add(queryTime);
+        roundsHistogram.add(uint64_t(numRounds));
+        for (size_t i = 0; i < NUM_PHASES; i++) {
+            phaseHistograms[i].add(queryData.phaseTime[i]);
+        }
+        for (size_t i = 0; i < NUM_METRICS; i++) {
+            metricHistograms[i].add(uint64_t(queryData.metricValue[i]));
+        }
         numQueries++;
     }
 
@@ -466,16 +486,25 @@ public:
         }
     }
 
+    // Profile queries run the rounds once per departure time. The rounds of each departure time are added to the
+    // statistics of the rounds with the same index.
+    inline void restartRounds() noexcept {
+        numRounds = 0;
+    }
+
     inline void startPhase() noexcept {
         phaseTimer.restart();
     }
 
     inline void donePhase(const Phase phase) noexcept {
-        currentRoundData->phaseTime[phase] += phaseTimer.elapsedMicroseconds();
+        const double time = phaseTimer.elapsedMicroseconds();
+        currentRoundData->phaseTime[phase] += time;
+        queryData.phaseTime[phase] += time;
     }
 
-    inline void countMetric(const Metric metric) const noexcept {
+    inline void countMetric(const Metric metric) noexcept {
         currentRoundData->metricValue[metric]++;
+        queryData.metricValue[metric]++;
     }
 
     inline double getTotalTime() const noexcept {
@@ -528,6 +557,26 @@ public:
         total.print(metrics, phases, "total");
         std::cout << "Total time: " << String::musToString(totalTime/numQueries) << std::endl;
         std::cout << "Avg. rounds: " << String::prettyDouble(totalNumRounds/static_cast<double>(numQueries)) << std::endl;
+        printPercentiles();
+    }
+
+    inline void printPercentiles() const noexcept {
+        Histogram::printHeader("Per query");
+        forEachStatistic([&](const std::string& name, const bool isTime, const Histogram& histogram) {
+            histogram.print(name, isTime);
+        });
+    }
+
+    template<typename FUNCTION>
+    inline void forEachStatistic(const FUNCTION& function) const noexcept {
+        function("Total time", true, totalTimeHistogram);
+        function("Rounds", false, roundsHistogram);
+        for (const Phase phase : phases) {
+            function(PhaseNames[phase], true, phaseHistograms[phase]);
+        }
+        for (const Metric metric : metrics) {
+            function(MetricNames[metric], false, metricHistograms[metric]);
+        }
     }
 
     inline AggregateProfiler& operator+=(const AggregateProfiler& other) noexcept {
@@ -542,6 +591,15 @@ public:
             extraRoundData[i] += other.extraRoundData[i];
         }
         numQueries += other.numQueries;
+        totalNumRounds += other.totalNumRounds;
+        totalTimeHistogram += other.totalTimeHistogram;
+        roundsHistogram += other.roundsHistogram;
+        for (size_t i = 0; i < NUM_PHASES; i++) {
+            phaseHistograms[i] += other.phaseHistograms[i];
+        }
+        for (size_t i = 0; i < NUM_METRICS; i++) {
+            metricHistograms[i] += other.metricHistograms[i];
+        }
         return *this;
     }
 
@@ -559,6 +617,11 @@ public:
     size_t numQueries;
     size_t numRounds;
     size_t totalNumRounds;
+    RoundData queryData;
+    Histogram totalTimeHistogram;
+    Histogram roundsHistogram;
+    std::vector<Histogram> phaseHistograms;
+    std::vector<Histogram> metricHistograms;
 };
 
 }
@@ -4,7 +4,10 @@
 #include <vector>
 #include <string>
 
+#include "../../Helpers/Helpers.h"
+
 #include "../../DataStructures/RAPTOR/Data.h"
+#include "../../DataStructures/RAPTOR/Entities/ArrivalLabel.h"
 #include "../../DataStructures/RAPTOR/Entities/EarliestArrivalTime.h"
 #include "../../DataStructures/Container/Set.h"
 #include "../../DataStructures/Container/Map.h"
@@ -13,7 +16,8 @@
 
 namespace RAPTOR {
 
-template<bool TARGET_PRUNING, typename PROFILER = NoProfiler, bool TRANSITIVE = true, bool USE_MIN_TRANSFER_TIMES = false, bool PREVENT_DIRECT_WALKING = false>
+// With LAZY_RESET = false, all labels are reset eagerly before every query instead of being invalidated by timestamps.
+template<bool TARGET_PRUNING, typename PROFILER = NoProfiler, bool TRANSITIVE = true, bool USE_MIN_TRANSFER_TIMES = false, bool PREVENT_DIRECT_WALKING = false, bool LAZY_RESET = true>
 class RAPTOR {
 
 public:
@@ -22,16 +26,17 @@ public:
     static constexpr bool Transitive = TRANSITIVE;
     static constexpr bool UseMinTransferTimes = USE_MIN_TRANSFER_TIMES;
     static constexpr bool PreventDirectWalking = PREVENT_DIRECT_WALKING;
+    static constexpr bool LazyReset = LAZY_RESET;
     static constexpr bool SeparateRouteAndTransferEntries = !Transitive | UseMinTransferTimes | PreventDirectWalking;
     static constexpr int RoundFactor = SeparateRouteAndTransferEntries ? 2 : 1;
     using ArrivalTime = EarliestArrivalTime<SeparateRouteAndTransferEntries>;
-    using Type = RAPTOR<TargetPruning, Profiler, Transitive, UseMinTransferTimes, PreventDirectWalking>;
+    using Type = RAPTOR<TargetPruning, Profiler, Transitive, UseMinTransferTimes, PreventDirectWalking, LazyReset>;
     using InitialTransferGraph = TransferGraph;
     using SourceType = StopId;
 
 private:
     struct EarliestArrivalLabel {
-        EarliestArrivalLabel() : arrivalTime(never), parentDepartureTime(never), parent(noStop), usesRoute(false), routeId(noRouteId) {}
+        EarliestArrivalLabel() : arrivalTime(never), parentDepartureTime(never), parent(noStop), usesRoute(false), routeId(noRouteId), timestamp(0) {}
         int arrivalTime;
         int parentDepartureTime;
         StopId parent;
@@ -40,13 +45,31 @@ private:
             RouteId routeId;
             Edge transferId;
         };
+        int timestamp;
     };
     using Round = std::vector<EarliestArrivalLabel>;
 
+    struct DepartureLabel {
+        DepartureLabel(const RouteId routeId = noRouteId, const StopIndex stopIndex = noStopIndex, const int departureTime = never) : route(routeId, stopIndex), departureTime(departureTime) {}
+        RouteSegment route;
+        int departureTime;
+        inline bool operator<(const DepartureLabel& other) const noexcept {
+            return (departureTime > other.departureTime) || ((departureTime == other.departureTime) && (route.routeId < other.route.routeId));
+        }
+    };
+
+    struct ConsolidatedDepartureLabel {
+        ConsolidatedDepartureLabel(const int departureTime = never) : departureTime(departureTime) {}
+        std::vector<RouteSegment> routes;
+        int departureTime;
+    };
+
 public:
     RAPTOR(const Data& data, const Profiler& profilerTemplate = Profiler()) :
         data(data),
+        numberOfRounds(0),
         earliestArrival(data.numberOfStops()),
+        earliestArrivalTimestamps(data.numberOfStops(), 0),
         stopsUpdatedByRoute(data.numberOfStops()),
         stopsUpdatedByTransfer(data.numberOfStops()),
         routesServingUpdatedStops(data.numberOfRoutes()),
@@ -54,6 +77,8 @@ public:
         targetStop(noStop),
         sourceDepartureTime(never),
         walkingDistance(INFTY),
+        timestamp(0),
+        earliestArrivalTimestamp(0),
         profiler(profilerTemplate) {
         if constexpr (UseMinTransferTimes) {
             AssertMsg(!data.hasImplicitBufferTimes(), "Either min transfer times have to be used OR departure buffer times have to be implicit!");
@@ -76,51 +101,54 @@ public:
         profiler.startExtraRound(EXTRA_ROUND_CLEAR);
         clear();
         profiler.doneRound();
+        runForDepartureTime(source, departureTime, target, maxRounds);
+        profiler.done();
+    }
+
+    // rRAPTOR: Runs one query per departure time of a trip at the source (or at a stop reachable by the initial
+    // transfers) within [minDepartureTime, maxDepartureTime], from the latest to the earliest. The round labels are
+    // kept between the departure times, so every label of a later departure prunes the search for earlier ones.
+    // Afterwards, getProfile() returns the Pareto profile (departure time, arrival time, number of trips) at the
+    // target. The journeys and arrivals of the individual departure times are not available.
+    // Labels of later departure times prune by the combined route and transfer arrival time, so for TRANSITIVE = true
+    // the transfer graph must actually be transitively closed.
+    inline void runProfile(const StopId source, const int minDepartureTime, const int maxDepartureTime, const StopId target, const size_t maxRounds = INFTY) noexcept {
+        static_assert(TargetPruning, "Profile queries require target pruning!");
+        AssertMsg(data.isStop(target), "Profile queries require a target stop!");
+        profiler.start();
+        profiler.startExtraRound(EXTRA_ROUND_CLEAR);
+        clear();
+        profile.clear();
+        profileArrivalTimes.clear();
+        profiler.doneRound();
 
         profiler.startExtraRound(EXTRA_ROUND_INITIALIZATION);
         profiler.startPhase();
-        initialize(source, departureTime, target);
+        const std::vector<ConsolidatedDepartureLabel> departures = collectDepartures(source, minDepartureTime, maxDepartureTime, target);
         profiler.donePhase(PHASE_INITIALIZATION);
-        profiler.startPhase();
-        relaxTransfers<true>();
-        profiler.donePhase(PHASE_TRANSFERS);
         profiler.doneRound();
 
-        for (size_t i = 0; i < maxRounds; i++) {
-            profiler.startRound();
-            profiler.startPhase();
-            startNewRound();
-            profiler.donePhase(PHASE_INITIALIZATION);
-            profiler.startPhase();
-            collectRoutesServingUpdatedStops();
-            profiler.donePhase(PHASE_COLLECT);
-            profiler.startPhase();
-            scanRoutes();
-            profiler.donePhase(PHASE_SCAN);
-            if (stopsUpdatedByRoute.empty()) {
-                profiler.doneRound();
-                break;
-            }
-            if constexpr (SeparateRouteAndTransferEntries) {
-                profiler.startPhase();
-                startNewRound();
-                profiler.donePhase(PHASE_INITIALIZATION);
-            }
-            profiler.startPhase();
-            relaxTransfers<false>();
-            profiler.donePhase(PHASE_TRANSFERS);
-            profiler.doneRound();
+        for (size_t i = 0; i < departures.size(); i++) {
+            profiler.restartRounds();
+            startNewDepartureTime();
+            // The first departure time scans all routes, which covers the trips departing after maxDepartureTime.
+            runForDepartureTime<true>(source, departures[i].departureTime, target, maxRounds, (i == 0) ? nullptr : &departures[i].routes);
+            addProfileLabels(departures[i].departureTime);
         }
         profiler.done();
     }
 
+    inline const std::vector<ProfileLabel>& getProfile() const noexcept {
+        return profile;
+    }
+
     inline std::vector<Journey> getJourneys() const noexcept {
         return getJourneys(targetStop);
     }
 
     inline std::vector<Journey> getJourneys(const StopId stop) const noexcept {
         std::vector<Journey> journeys;
-        for (size_t i = 0; i < rounds.size(); i += RoundFactor) {
+        for (size_t i = 0; i < numberOfRounds; i += RoundFactor) {
             getJourney(journeys, i, stop);
         }
         return journeys;
@@ -138,7 +166,7 @@ public:
     inline std::vector<ArrivalLabel> getArrivals(const StopId stop) const noexcept {
         AssertMsg(data.isStop(stop), "The StopId " << stop << " does not correspond to any stop!");
         std::vector<ArrivalLabel> labels;
-        for (size_t i = 0; i < rounds.size(); i += RoundFactor) {
+        for (size_t i = 0; i < numberOfRounds; i += RoundFactor) {
             getArrival(labels, i, stop);
         }
         return labels;
@@ -150,17 +178,18 @@ public:
 
     inline std::vector<int> getArrivalTimes(const StopId stop) const noexcept {
         std::vector<int> arrivalTimes;
-        for (size_t i = 0; i < rounds.size(); i += RoundFactor) {
+        for (size_t i = 0; i < numberOfRounds; i += RoundFactor) {
             getArrivalTime(arrivalTimes, i, stop);
         }
         return arrivalTimes;
     }
 
     inline bool reachable(const StopId stop) const noexcept {
-        return earliestArrival[stop].getArrivalTime() < never;
+        return getEarliestArrivalTime(stop) < never;
     }
 
     inline int getEarliestArrivalTime(const StopId stop) const noexcept {
+        if (LazyReset && earliestArrivalTimestamps[stop] != earliestArrivalTimestamp) return never;
         return earliestArrival[stop].getArrivalTime();
     }
 
@@ -188,13 +217,19 @@ public:
         targetStop = noStop;
         sourceDepartureTime = never;
         walkingDistance = INFTY;
+        numberOfRounds = 0;
         if constexpr (RESET_CAPACITIES) {
             std::vector<Round>().swap(rounds);
-            std::vector<ArrivalTime>(earliestArrival.size(), never).swap(earliestArrival);
-        } else {
+            std::vector<ArrivalTime>(earliestArrival.size()).swap(earliestArrival);
+            std::vector<int>(earliestArrivalTimestamps.size(), 0).swap(earliestArrivalTimestamps);
+            timestamp = 0;
+            earliestArrivalTimestamp = 0;
+        } else if constexpr (!LazyReset) {
             rounds.clear();
             Vector::fill(earliestArrival);
         }
+        startNewTimestamp();
+        startNewEarliestArrivalTimestamp();
     }
 
     inline void reset() noexcept {
@@ -208,29 +243,168 @@ public:
     inline int getArrivalTime(const StopId stop, const size_t numberOfTrips) const noexcept {
         size_t round = numberOfTrips * RoundFactor;
         if constexpr (SeparateRouteAndTransferEntries) {
-            if ((round + 1 < rounds.size()) && (rounds[round + 1][stop].arrivalTime < rounds[round][stop].arrivalTime)) round++;
+            if ((round + 1 < numberOfRounds) && (roundLabel(round + 1, stop).arrivalTime < roundLabel(round, stop).arrivalTime)) round++;
         }
-        AssertMsg(rounds[round][stop].arrivalTime < never, "No label found for stop " << stop << " in round " << round << "!");
-        return rounds[round][stop].arrivalTime;
+        AssertMsg(roundLabel(round, stop).arrivalTime < never, "No label found for stop " << stop << " in round " << round << "!");
+        return roundLabel(round, stop).arrivalTime;
     }
 
 private:
+    // In profile mode, the round labels of later departure times are kept, and they also prune the search.
+    template<bool PROFILE = false>
+    inline void runForDepartureTime(const StopId source, const int departureTime, const StopId target, const size_t maxRounds, const std::vector<RouteSegment>* departureRoutes = nullptr) noexcept {
+        profiler.startExtraRound(EXTRA_ROUND_INITIALIZATION);
+        profiler.startPhase();
+        initialize<PROFILE>(source, departureTime, target);
+        profiler.donePhase(PHASE_INITIALIZATION);
+        profiler.startPhase();
+        relaxTransfers<true, PROFILE>();
+        profiler.donePhase(PHASE_TRANSFERS);
+        profiler.doneRound();
+
+        for (size_t i = 0; i < maxRounds; i++) {
+            profiler.startRound();
+            profiler.startPhase();
+            startNewRound();
+            profiler.donePhase(PHASE_INITIALIZATION);
+            profiler.startPhase();
+            if (i == 0 && departureRoutes) {
+                collectRoutes(*departureRoutes);
+            } else {
+                collectRoutesServingUpdatedStops();
+            }
+            profiler.donePhase(PHASE_COLLECT);
+            profiler.startPhase();
+            scanRoutes<PROFILE>();
+            profiler.donePhase(PHASE_SCAN);
+            if (stopsUpdatedByRoute.empty()) {
+                profiler.doneRound();
+                break;
+            }
+            if constexpr (SeparateRouteAndTransferEntries) {
+                profiler.startPhase();
+                startNewRound();
+                profiler.donePhase(PHASE_INITIALIZATION);
+            }
+            profiler.startPhase();
+            relaxTransfers<false, PROFILE>();
+            profiler.donePhase(PHASE_TRANSFERS);
+            profiler.doneRound();
+        }
+    }
+
+    template<bool PROFILE>
     inline void initialize(const StopId source, const int departureTime, const StopId target) noexcept {
         sourceStop = source;
         targetStop = target;
         sourceDepartureTime = departureTime;
         startNewRound();
-        arrivalByRoute(source, sourceDepartureTime);
-        currentRound()[source].parent = source;
-        currentRound()[source].parentDepartureTime = sourceDepartureTime;
-        currentRound()[source].usesRoute = false;
+        arrivalByRoute<PROFILE>(source, sourceDepartureTime);
+        EarliestArrivalLabel& sourceLabel = currentRoundLabel(source);
+        sourceLabel.parent = source;
+        sourceLabel.parentDepartureTime = sourceDepartureTime;
+        sourceLabel.usesRoute = false;
         if constexpr (SeparateRouteAndTransferEntries) startNewRound();
     }
 
+    inline std::vector<ConsolidatedDepartureLabel> collectDepartures(const StopId source, const int minDepartureTime, const int maxDepartureTime, const StopId target) const noexcept {
+        std::vector<DepartureLabel> departureLabels;
+        collectDepartures(source, 0, minDepartureTime, maxDepartureTime, departureLabels);
+        for (const Edge edge : data.transferGraph.edgesFrom(source)) {
+            const StopId stop = StopId(data.transferGraph.get(ToVertex, edge));
+            if constexpr (PreventDirectWalking) if (stop == target) continue;
+            collectDepartures(stop, data.transferGraph.get(TravelTime, edge), minDepartureTime, maxDepartureTime, departureLabels);
+        }
+        sort(departureLabels);
+        std::vector<ConsolidatedDepartureLabel> result;
+        for (const DepartureLabel& label : departureLabels) {
+            if (result.empty() || result.back().departureTime != label.departureTime) {
+                result.emplace_back(label.departureTime);
+            }
+            result.back().routes.emplace_back(label.route);
+        }
+        return result;
+    }
+
+    inline void collectDepartures(const StopId stop, const int transferTime, const int minDepartureTime, const int maxDepartureTime, std::vector<DepartureLabel>& departureLabels) const noexcept {
+        for (const RouteSegment& route : data.routesContainingStop(stop)) {
+            const size_t tripSize = data.numberOfStopsInRoute(route.routeId);
+            if (route.stopIndex + 1 == tripSize) continue;
+            for (const StopEvent* trip = data.firstTripOfRoute(route.routeId); trip <= data.lastTripOfRoute(route.routeId); trip += tripSize) {
+                const int departureTime = trip[route.stopIndex].departureTime - transferTime;
+                if (departureTime < minDepartureTime) continue;
+                if (departureTime > maxDepartureTime) break;
+                departureLabels.emplace_back(route.routeId, route.stopIndex, departureTime);
+            }
+        }
+    }
+
+    inline void startNewDepartureTime() noexcept {
+        stopsUpdatedByRoute.clear();
+        stopsUpdatedByTransfer.clear();
+        routesServingUpdatedStops.clear();
+        walkingDistance = INFTY;
+        numberOfRounds = 0;
+        if constexpr (LazyReset) {
+            startNewEarliestArrivalTimestamp();
+        } else {
+            Vector::fill(earliestArrival);
+        }
+    }
+
+    // If a timestamp would overflow, all labels are reset and the timestamp starts over.
+    inline void startNewTimestamp() noexcept {
+        if (timestamp == std::numeric_limits<int>::max()) {
+            for (Round& round : rounds) {
+                Vector::fill(round);
+            }
+            timestamp = 0;
+        }
+        timestamp++;
+    }
+
+    inline void startNewEarliestArrivalTimestamp() noexcept {
+        if (earliestArrivalTimestamp == std::numeric_limits<int>::max()) {
+            Vector::fill(earliestArrivalTimestamps, 0);
+            earliestArrivalTimestamp = 0;
+        }
+        earliestArrivalTimestamp++;
+    }
+
+    // Adds a profile label for every number of trips for which the arrival time at the target improved. The round
+    // labels still contain the arrivals of all later departure times, so an improvement can only stem from a journey
+    // that departs at the current departure time.
+    inline void addProfileLabels(const int departureTime) noexcept {
+        const size_t maxNumberOfTrips = (rounds.size() + RoundFactor - 1) / RoundFactor;
+        if (profileArrivalTimes.size() < maxNumberOfTrips) profileArrivalTimes.resize(maxNumberOfTrips, never);
+        int arrivalTime = never;
+        for (size_t numberOfTrips = 0; numberOfTrips < profileArrivalTimes.size(); numberOfTrips++) {
+            const int arrivalTimeWithFewerTrips = arrivalTime;
+            for (size_t round = numberOfTrips * RoundFactor; round < std::min(rounds.size(), (numberOfTrips + 1) * RoundFactor); round++) {
+                const EarliestArrivalLabel& label = rounds[round][targetStop];
+                if (!LazyReset || label.timestamp == timestamp) arrivalTime = std::min(arrivalTime, label.arrivalTime);
+            }
+            if (arrivalTime < arrivalTimeWithFewerTrips && arrivalTime < profileArrivalTimes[numberOfTrips]) {
+                profile.emplace_back(departureTime, arrivalTime, numberOfTrips);
+            }
+            profileArrivalTimes[numberOfTrips] = arrivalTime;
+        }
+    }
+
+    inline void collectRoutes(const std::vector<RouteSegment>& routes) noexcept {
+        for (const RouteSegment& route : routes) {
+            if (routesServingUpdatedStops.contains(route.routeId)) {
+                routesServingUpdatedStops[route.routeId] = std::min(routesServingUpdatedStops[route.routeId], route.stopIndex);
+            } else {
+                routesServingUpdatedStops.insert(route.routeId, route.stopIndex);
+            }
+        }
+    }
+
     inline void collectRoutesServingUpdatedStops() noexcept {
         for (const StopId stop : stopsUpdatedByTransfer) {
             AssertMsg(data.isStop(stop), "Stop " << stop << " is out of range!");
-            const int arrivalTime = previousRound()[stop].arrivalTime;
+            const int arrivalTime = previousRoundLabel(stop).arrivalTime;
             AssertMsg(arrivalTime < never, "Updated stop has arrival time = never!");
             for (const RouteSegment& route : data.routesContainingStop(stop)) {
                 AssertMsg(data.isRoute(route.routeId), "Route " << route.routeId << " is out of range!");
@@ -246,6 +420,7 @@ private:
         }
     }
 
+    template<bool PROFILE>
     inline void scanRoutes() noexcept {
         stopsUpdatedByRoute.clear();
         for (const RouteId route : routesServingUpdatedStops.getKeys()) {
@@ -257,20 +432,25 @@ private:
             const StopId* stops = data.stopArrayOfRoute(route);
             const StopEvent* trip = data.lastTripOfRoute(route);
             StopId stop = stops[stopIndex];
-            AssertMsg(trip[stopIndex].departureTime >= previousRound()[stop].arrivalTime, "Cannot scan a route after the last trip has departed (Route: " << route << ", Stop: " << stop << ", StopIndex: " << stopIndex << ", Time: " << previousRound()[stop].arrivalTime << ", LastDeparture: " << trip[stopIndex].departureTime << ")!");
+            AssertMsg(trip[stopIndex].departureTime >= previousRoundLabel(stop).arrivalTime, "Cannot scan a route after the last trip has departed (Route: " << route << ", Stop: " << stop << ", StopIndex: " << stopIndex << ", Time: " << previousRoundLabel(stop).arrivalTime << ", LastDeparture: " << trip[stopIndex].departureTime << ")!");
 
             StopIndex parentIndex = stopIndex;
             const StopEvent* firstTrip = data.firstTripOfRoute(route);
+            const int* departureTimes = data.departureTimesOfRoute(route);
+            const size_t numberOfTrips = data.numberOfTripsInRoute(route);
+            size_t tripIndex = numberOfTrips - 1;
             while (stopIndex < tripSize - 1) {
-                while ((trip > firstTrip) && ((trip - tripSize + stopIndex)->departureTime >= previousRound()[stop].arrivalTime)) {
-                    trip -= tripSize;
+                const size_t earliestTrip = findEarliestTripBackward(departureTimes + (stopIndex * numberOfTrips), tripIndex, previousRoundLabel(stop).arrivalTime);
+                if (earliestTrip < tripIndex) {
+                    tripIndex = earliestTrip;
+                    trip = firstTrip + (tripIndex * tripSize);
                     parentIndex = stopIndex;
                 }
                 stopIndex++;
                 stop = stops[stopIndex];
                 profiler.countMetric(METRIC_ROUTE_SEGMENTS);
-                if (arrivalByRoute(stop, trip[stopIndex].arrivalTime)) {
-                    EarliestArrivalLabel& label = currentRound()[stop];
+                if (arrivalByRoute<PROFILE>(stop, trip[stopIndex].arrivalTime)) {
+                    EarliestArrivalLabel& label = currentRoundLabel(stop);
                     label.parent = stops[parentIndex];
                     label.parentDepartureTime = trip[parentIndex].departureTime;
                     label.usesRoute = true;
@@ -280,12 +460,12 @@ private:
         }
     }
 
-    template<bool INITIAL_TRANSFERS = false>
+    template<bool INITIAL_TRANSFERS, bool PROFILE>
     inline void relaxTransfers() noexcept {
         stopsUpdatedByTransfer.clear();
         routesServingUpdatedStops.clear();
         for (const StopId stop : stopsUpdatedByRoute) {
-            const int earliestArrivalTime = SeparateRouteAndTransferEntries ? previousRound()[stop].arrivalTime : currentRound()[stop].arrivalTime;
+            const int earliestArrivalTime = SeparateRouteAndTransferEntries ? previousRoundLabel(stop).arrivalTime : currentRoundLabel(stop).arrivalTime;
             for (const Edge edge : data.transferGraph.edgesFrom(stop)) {
                 if constexpr (INITIAL_TRANSFERS && PreventDirectWalking) {
                     if (data.transferGraph.get(ToVertex, edge) == targetStop) {
@@ -297,8 +477,8 @@ private:
                 const int arrivalTime = earliestArrivalTime + data.transferGraph.get(TravelTime, edge);
                 AssertMsg(data.isStop(data.transferGraph.get(ToVertex, edge)), "Graph contains edges to non stop vertices!");
                 const StopId toStop = StopId(data.transferGraph.get(ToVertex, edge));
-                if (arrivalByTransfer(toStop, arrivalTime)) {
-                    EarliestArrivalLabel& label = currentRound()[toStop];
+                if (arrivalByTransfer<PROFILE>(toStop, arrivalTime)) {
+                    EarliestArrivalLabel& label = currentRoundLabel(toStop);
                     label.parent = stop;
                     label.parentDepartureTime = earliestArrivalTime;
                     label.usesRoute = false;
@@ -307,8 +487,8 @@ private:
             }
             if constexpr (SeparateRouteAndTransferEntries) {
                 const int arrivalTime = earliestArrivalTime + getMinTransferTime<INITIAL_TRANSFERS>(stop);
-                if (arrivalByTransfer(stop, arrivalTime)) {
-                    EarliestArrivalLabel& label = currentRound()[stop];
+                if (arrivalByTransfer<PROFILE>(stop, arrivalTime)) {
+                    EarliestArrivalLabel& label = currentRoundLabel(stop);
                     label.parent = stop;
                     label.parentDepartureTime = earliestArrivalTime;
                     label.usesRoute = false;
@@ -329,37 +509,67 @@ private:
         }
     }
 
-    inline Round& currentRound() noexcept {
-        AssertMsg(!rounds.empty(), "Cannot return current round, because no round exists!");
-        return rounds.back();
+    inline const EarliestArrivalLabel& roundLabel(const size_t round, const StopId stop) const noexcept {
+        AssertMsg(round < numberOfRounds, "Round " << round << " is out of bounds (numberOfRounds = " << numberOfRounds << ")!");
+        const EarliestArrivalLabel& label = rounds[round][stop];
+        return (!LazyReset || label.timestamp == timestamp) ? label : emptyLabel;
+    }
+
+    inline EarliestArrivalLabel& currentRoundLabel(const StopId stop) noexcept {
+        AssertMsg(numberOfRounds > 0, "Cannot return current round, because no round exists!");
+        EarliestArrivalLabel& label = rounds[numberOfRounds - 1][stop];
+        if (LazyReset && label.timestamp != timestamp) {
+            label = emptyLabel;
+            label.timestamp = timestamp;
+        }
+        return label;
+    }
+
+    inline const EarliestArrivalLabel& previousRoundLabel(const StopId stop) const noexcept {
+        AssertMsg(numberOfRounds >= 2, "Cannot return previous round, because less than two rounds exist!");
+        return roundLabel(numberOfRounds - 2, stop);
     }
 
-    inline Round& previousRound() noexcept {
-        AssertMsg(rounds.size() >= 2, "Cannot return previous round, because less than two rounds exist!");
-        return rounds[rounds.size() - 2];
+    inline ArrivalTime& earliestArrivalLabel(const StopId stop) noexcept {
+        if (LazyReset && earliestArrivalTimestamps[stop] != earliestArrivalTimestamp) {
+            earliestArrival[stop] = ArrivalTime();
+            earliestArrivalTimestamps[stop] = earliestArrivalTimestamp;
+        }
+        return earliestArrival[stop];
     }
 
     inline void startNewRound() noexcept {
-        rounds.emplace_back(data.numberOfStops());
+        if (numberOfRounds == rounds.size()) rounds.emplace_back(data.numberOfStops());
+        numberOfRounds++;
     }
 
+    template<bool PROFILE>
     inline bool arrivalByRoute(const StopId stop, const int time) noexcept {
         AssertMsg(data.isStop(stop), "Stop " << stop << " is out of range!");
-        if constexpr (TargetPruning) if (earliestArrival[targetStop].getArrivalTimeByRoute() <= time) return false;
-        if (earliestArrival[stop].getArrivalTimeByRoute() <= time) return false;
+        if constexpr (TargetPruning) if (earliestArrivalLabel(targetStop).getArrivalTimeByRoute() <= time) return false;
+        if (earliestArrivalLabel(stop).getArrivalTimeByRoute() <= time) return false;
+        if constexpr (PROFILE) {
+            if constexpr (TargetPruning) if (roundLabel(numberOfRounds - 1, targetStop).arrivalTime <= time) return false;
+            if (roundLabel(numberOfRounds - 1, stop).arrivalTime <= time) return false;
+        }
         profiler.countMetric(METRIC_STOPS_BY_TRIP);
-        currentRound()[stop].arrivalTime = time;
+        currentRoundLabel(stop).arrivalTime = time;
         earliestArrival[stop].setArrivalTimeByRoute(time);
         stopsUpdatedByRoute.insert(stop);
         return true;
     }
 
+    template<bool PROFILE>
     inline bool arrivalByTransfer(const StopId stop, const int time) noexcept {
         AssertMsg(data.isStop(stop), "Stop " << stop << " is out of range!");
-        if constexpr (TargetPruning) if (earliestArrival[targetStop].getArrivalTimeByTransfer() <= time) return false;
-        if (earliestArrival[stop].getArrivalTimeByTransfer() <= time) return false;
+        if constexpr (TargetPruning) if (earliestArrivalLabel(targetStop).getArrivalTimeByTransfer() <= time) return false;
+        if (earliestArrivalLabel(stop).getArrivalTimeByTransfer() <= time) return false;
+        if constexpr (PROFILE) {
+            if constexpr (TargetPruning) if (roundLabel(numberOfRounds - 1, targetStop).arrivalTime <= time) return false;
+            if (roundLabel(numberOfRounds - 1, stop).arrivalTime <= time) return false;
+        }
         profiler.countMetric(METRIC_STOPS_BY_TRANSFER);
-        currentRound()[stop].arrivalTime = time;
+        currentRoundLabel(stop).arrivalTime = time;
         earliestArrival[stop].setArrivalTimeByTransfer(time);
         stopsUpdatedByTransfer.insert(stop);
         return true;
@@ -367,13 +577,13 @@ private:
 
     inline void getJourney(std::vector<Journey>& journeys, size_t round, StopId stop) const noexcept {
         if constexpr (SeparateRouteAndTransferEntries) {
-            if ((round + 1 < rounds.size()) && (rounds[round + 1][stop].arrivalTime < rounds[round][stop].arrivalTime)) round++;
+            if ((round + 1 < numberOfRounds) && (roundLabel(round + 1, stop).arrivalTime < roundLabel(round, stop).arrivalTime)) round++;
         }
-        if (rounds[round][stop].arrivalTime >= (journeys.empty() ? never : journeys.back().back().arrivalTime)) return;
+        if (roundLabel(round, stop).arrivalTime >= (journeys.empty() ? never : journeys.back().back().arrivalTime)) return;
         Journey journey;
         do {
             AssertMsg(round != size_t(-1), "Backtracking parent pointers did not pass through the source stop!");
-            const EarliestArrivalLabel& label = rounds[round][stop];
+            const EarliestArrivalLabel& label = roundLabel(round, stop);
             journey.emplace_back(label.parent, stop, label.parentDepartureTime, label.arrivalTime, label.usesRoute, label.routeId);
             stop = label.parent;
             if constexpr (SeparateRouteAndTransferEntries) {
@@ -387,25 +597,28 @@ private:
 
     inline void getArrival(std::vector<ArrivalLabel>& labels, size_t round, const StopId stop) const noexcept {
         if constexpr (SeparateRouteAndTransferEntries) {
-            if ((round + 1 < rounds.size()) && (rounds[round + 1][stop].arrivalTime < rounds[round][stop].arrivalTime)) round++;
+            if ((round + 1 < numberOfRounds) && (roundLabel(round + 1, stop).arrivalTime < roundLabel(round, stop).arrivalTime)) round++;
         }
-        if (rounds[round][stop].arrivalTime >= (labels.empty() ? never : labels.back().arrivalTime)) return;
-        labels.emplace_back(rounds[round][stop].arrivalTime, round / RoundFactor);
+        if (roundLabel(round, stop).arrivalTime >= (labels.empty() ? never : labels.back().arrivalTime)) return;
+        labels.emplace_back(roundLabel(round, stop).arrivalTime, round / RoundFactor);
     }
 
     inline void getArrivalTime(std::vector<int>& labels, size_t round, const StopId stop) const noexcept {
         if constexpr (SeparateRouteAndTransferEntries) {
-            if ((round + 1 < rounds.size()) && (rounds[round + 1][stop].arrivalTime < rounds[round][stop].arrivalTime)) round++;
+            if ((round + 1 < numberOfRounds) && (roundLabel(round + 1, stop).arrivalTime < roundLabel(round, stop).arrivalTime)) round++;
         }
-        labels.emplace_back(std::min(rounds[round][stop].arrivalTime, (labels.empty()) ? (never) : (labels.back())));
+        labels.emplace_back(std::min(roundLabel(round, stop).arrivalTime, (labels.empty()) ? (never) : (labels.back())));
     }
 
 private:
     const Data& data;
 
     std::vector<Round> rounds;
+    size_t numberOfRounds;
+    const EarliestArrivalLabel emptyLabel;
 
     std::vector<ArrivalTime> earliestArrival;
+    std::vector<int> earliestArrivalTimestamps;
 
     IndexedSet<false, StopId> stopsUpdatedByRoute;
     IndexedSet<false, StopId> stopsUpdatedByTransfer;
@@ -415,6 +628,11 @@ private:
     StopId targetStop;
     int sourceDepartureTime;
     int walkingDistance;
+    int timestamp;
+    int earliestArrivalTimestamp;
+
+    std::vector<ProfileLabel> profile;
+    std::vector<int> profileArrivalTimes;
 
     Profiler profiler;
 
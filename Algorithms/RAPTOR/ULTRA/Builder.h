@@ -8,17 +8,20 @@
 #include "../../../Helpers/Console/Progress.h"
 
 #include "ShortcutSearch.h"
+#include "MergeShortcuts.h"
 
 namespace RAPTOR::ULTRA {
 
-template<bool DEBUG = false, bool COUNT_OPTIMAL_CANDIDATES = false, bool IGNORE_ISOLATED_CANDIDATES = false>
+template<bool DEBUG = false, bool COUNT_OPTIMAL_CANDIDATES = false, bool IGNORE_ISOLATED_CANDIDATES = false, typename PROFILER = NoProfiler>
 class Builder {
 
 public:
     inline static constexpr bool Debug = DEBUG;
     inline static constexpr bool CountOptimalCandidates = COUNT_OPTIMAL_CANDIDATES;
     inline static constexpr bool IgnoreIsolatedCandidates = IGNORE_ISOLATED_CANDIDATES;
-    using Type = Builder<Debug, CountOptimalCandidates, IgnoreIsolatedCandidates>;
+    using Profiler = PROFILER;
+    using Type = Builder<Debug, CountOptimalCandidates, IgnoreIsolatedCandidates, Profiler>;
+    using ShortcutSearchType = ShortcutSearch<Debug, CountOptimalCandidates, IgnoreIsolatedCandidates, Profiler>;
 
 public:
     Builder(const Data& data) :
@@ -33,14 +36,16 @@ public:
         if (verbose) std::cout << "Computing shortcuts with " << threadPinning.numberOfThreads << " threads." << std::endl;
 
         size_t optimalCandidates = 0;
+        const std::vector<Station> stationOfStop = computeStationOfStop(data, threadPinning);
         Progress progress(data.numberOfStops(), verbose);
+        std::vector<std::vector<Shortcut>> threadShortcuts(threadPinning.numberOfThreads);
+        std::vector<Profiler> threadProfilers(threadPinning.numberOfThreads);
         omp_set_num_threads(threadPinning.numberOfThreads);
         #pragma omp parallel
         {
             threadPinning.pinThread();
 
-            DynamicTransferGraph localShortcutGraph = shortcutGraph;
-            ShortcutSearch<Debug, CountOptimalCandidates, IgnoreIsolatedCandidates> shortcutSearch(data, localShortcutGraph, witnessTransferLimit);
+            ShortcutSearchType shortcutSearch(data, stationOfStop, threadShortcuts[omp_get_thread_num()], witnessTransferLimit);
 
             #pragma omp for schedule(dynamic)
             for (size_t i = 0; i < data.numberOfStops(); i++) {
@@ -48,24 +53,19 @@ public:
                 progress++;
             }
 
-            #pragma omp critical
-            {
-                if constexpr (CountOptimalCandidates) {
-                    optimalCandidates += shortcutSearch.getNumberOfOptimalCandidates();
-                }
-                for (const Vertex from : shortcutGraph.vertices()) {
-                    for (const Edge edge : localShortcutGraph.edgesFrom(from)) {
-                        const Vertex to = localShortcutGraph.get(ToVertex, edge);
-                        if (!shortcutGraph.hasEdge(from, to)) {
-                            shortcutGraph.addEdge(from, to).set(TravelTime, localShortcutGraph.get(TravelTime, edge));
-                        } else {
-                            AssertMsg(shortcutGraph.get(TravelTime, shortcutGraph.findEdge(from, to)) == localShortcutGraph.get(TravelTime, edge), "Edge from " << from << " to " << to << " has inconclusive travel time (" << shortcutGraph.get(TravelTime, shortcutGraph.findEdge(from, to)) << ", " << localShortcutGraph.get(TravelTime, edge) << ")");
-                        }
-                    }
-                }
+            if constexpr (CountOptimalCandidates) {
+                #pragma omp atomic
+                optimalCandidates += shortcutSearch.getNumberOfOptimalCandidates();
             }
+            threadProfilers[omp_get_thread_num()] = shortcutSearch.getProfiler();
         }
         progress.finished();
+        mergeShortcuts(threadShortcuts, shortcutGraph, threadPinning);
+        profiler = Profiler();
+        for (const Profiler& threadProfiler : threadProfilers) {
+            profiler += threadProfiler;
+        }
+        if (verbose) profiler.printStatistics();
         if constexpr (CountOptimalCandidates) {
             std::cout << "#Optimal candidates: " << String::prettyInt(optimalCandidates) << std::endl;
         } else {
@@ -81,9 +81,14 @@ public:
         return shortcutGraph;
     }
 
+    inline const Profiler& getProfiler() const noexcept {
+        return profiler;
+    }
+
 private:
     const Data& data;
     DynamicTransferGraph shortcutGraph;
+    Profiler profiler;
 };
 
 }
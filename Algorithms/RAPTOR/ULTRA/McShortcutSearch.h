@@ -14,6 +14,9 @@
 #include "../../../DataStructures/Container/Set.h"
 #include "../../../DataStructures/Container/ExternalKHeap.h"
 #include "../../../DataStructures/RAPTOR/Data.h"
+#include "../../../DataStructures/RAPTOR/Entities/Shortcut.h"
+
+#include "Station.h"
 
 namespace RAPTOR::ULTRA {
 
@@ -456,23 +459,11 @@ public:
         }
     };
 
-    struct Station {
-        Station() : representative(noStop) {}
-        StopId representative;
-        std::vector<StopId> stops;
-        inline void add(const StopId stop) noexcept {
-            if (representative > stop) {
-                representative = stop;
-            }
-            stops.emplace_back(stop);
-        }
-    };
-
 public:
-    McShortcutSearch(const Data& data, DynamicTransferGraph& shortcutGraph, const int intermediateWitnessTransferLimit, const int finalWitnessTransferLimit) :
+    McShortcutSearch(const Data& data, const std::vector<Station>& stationOfStop, std::vector<RAPTOR::Shortcut>& foundShortcuts, const int intermediateWitnessTransferLimit, const int finalWitnessTransferLimit) :
         data(data),
-        shortcutGraph(shortcutGraph),
-        stationOfStop(data.numberOfStops()),
+        foundShortcuts(foundShortcuts),
+        stationOfStop(stationOfStop),
         sourceStation(),
         sourceDepartureTime(0),
         shortcutCandidatesInQueue(0),
@@ -486,15 +477,7 @@ public:
         earliestDepartureTime(data.getMinDepartureTime()),
         timestamp(0) {
         AssertMsg(data.hasImplicitBufferTimes(), "Shortcut search requires implicit departure buffer times!");
-        Dijkstra<TransferGraph, false> dijkstra(data.transferGraph);
-        for (const StopId stop : data.stops()) {
-            dijkstra.run(stop, noVertex, [&](const Vertex u) {
-                if (!data.isStop(u)) return;
-                stationOfStop[stop].add(StopId(u));
-            }, NoOperation, [&](const Vertex, const Edge edge) {
-                return data.transferGraph.get(TravelTime, edge) > 0;
-            });
-        }
+        shortcutGraph.addVertices(data.numberOfStops());
     }
 
     inline void run(const StopId source, const int minTime, const int maxTime) noexcept {
@@ -506,6 +489,7 @@ public:
             for (const Shortcut& shortcut : shortcuts) {
                 if (!shortcutGraph.hasEdge(shortcut.origin, shortcut.destination)) {
                     shortcutGraph.addEdge(shortcut.origin, shortcut.destination).set(TravelTime, shortcut.travelTime);
+                    foundShortcuts.emplace_back(shortcut.origin, shortcut.destination, shortcut.travelTime);
                 } else {
                     AssertMsg(shortcutGraph.get(TravelTime, shortcutGraph.findEdge(shortcut.origin, shortcut.destination)) == shortcut.travelTime, "Edge from " << shortcut.origin << " to " << shortcut.destination << " has inconclusive travel time (" << shortcutGraph.get(TravelTime, shortcutGraph.findEdge(shortcut.origin, shortcut.destination)) << ", " << shortcut.travelTime << ")");
                 }
@@ -1011,8 +995,10 @@ private:
 
 private:
     const Data& data;
-    DynamicTransferGraph& shortcutGraph;
-    std::vector<Station> stationOfStop;
+    std::vector<RAPTOR::Shortcut>& foundShortcuts;
+    //Shortcuts found so far, which are no longer candidates
+    DynamicTransferGraph shortcutGraph;
+    const std::vector<Station>& stationOfStop;
 
     Station sourceStation;
     int sourceDepartureTime;
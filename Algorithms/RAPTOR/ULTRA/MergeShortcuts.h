@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "../../../DataStructures/RAPTOR/Data.h"
+#include "../../../DataStructures/RAPTOR/Entities/Shortcut.h"
+#include "../../../Helpers/MultiThreading.h"
+
+namespace RAPTOR::ULTRA {
+
+// Adds the shortcuts collected by the individual threads to the shortcut graph.
+// threadShortcuts must contain one vector per thread. The vectors are sorted in parallel, then the origin stops are
+// split into one range per vector, and the shortcuts of each range are gathered, sorted and deduplicated in parallel.
+// The work is distributed with omp for, so the result does not depend on the number of threads OpenMP actually grants.
+// Only the final insertion of the (already unique) edges into the graph is sequential.
+inline void mergeShortcuts(std::vector<std::vector<Shortcut>>& threadShortcuts, DynamicTransferGraph& shortcutGraph, const ThreadPinning& threadPinning) noexcept {
+    AssertMsg(threadShortcuts.size() == threadPinning.numberOfThreads, "Expected one shortcut vector per thread!");
+    const auto shortcutOrder = [](const Shortcut& a, const Shortcut& b) {
+        return (a.origin < b.origin) || ((a.origin == b.origin) && (a.destination < b.destination));
+    };
+    const size_t numberOfShards = threadShortcuts.size();
+    const size_t numberOfStops = shortcutGraph.numVertices();
+    std::vector<std::vector<Shortcut>> shards(numberOfShards);
+
+    omp_set_num_threads(threadPinning.numberOfThreads);
+    #pragma omp parallel
+    {
+        threadPinning.pinThread();
+
+        #pragma omp for
+        for (size_t i = 0; i < threadShortcuts.size(); i++) {
+            std::sort(threadShortcuts[i].begin(), threadShortcuts[i].end(), shortcutOrder);
+        }
+
+        #pragma omp for
+        for (size_t shardId = 0; shardId < numberOfShards; shardId++) {
+            const StopId firstOrigin(numberOfStops * shardId / numberOfShards);
+            const StopId endOrigin(numberOfStops * (shardId + 1) / numberOfShards);
+            std::vector<Shortcut>& shard = shards[shardId];
+            for (const std::vector<Shortcut>& shortcuts : threadShortcuts) {
+                const auto begin = std::lower_bound(shortcuts.begin(), shortcuts.end(), firstOrigin, [](const Shortcut& shortcut, const StopId origin) {
+                    return shortcut.origin < origin;
+                });
+                const auto end = std::lower_bound(begin, shortcuts.end(), endOrigin, [](const Shortcut& shortcut, const StopId origin) {
+                    return shortcut.origin < origin;
+                });
+                shard.insert(shard.end(), begin, end);
+            }
+            std::sort(shard.begin(), shard.end(), shortcutOrder);
+            size_t numberOfUniqueShortcuts = 0;
+            for (size_t i = 0; i < shard.size(); i++) {
+                if ((numberOfUniqueShortcuts > 0) && (shard[numberOfUniqueShortcuts - 1].origin == shard[i].origin) && (shard[numberOfUniqueShortcuts - 1].destination == shard[i].destination)) {
+                    AssertMsg(shard[numberOfUniqueShortcuts - 1].travelTime == shard[i].travelTime, "Edge from " << shard[i].origin << " to " << shard[i].destination << " has inconclusive travel time (" << shard[numberOfUniqueShortcuts - 1].travelTime << ", " << shard[i].travelTime << ")");
+                    continue;
+                }
+                shard[numberOfUniqueShortcuts++] = shard[i];
+            }
+            shard.resize(numberOfUniqueShortcuts, Shortcut(noStop, noStop));
+        }
+
+        #pragma omp for
+        for (size_t i = 0; i < threadShortcuts.size(); i++) {
+            std::vector<Shortcut>().swap(threadShortcuts[i]);
+        }
+    }
+
+    const bool hadShortcuts = (shortcutGraph.numEdges() > 0);
+    for (const std::vector<Shortcut>& shard : shards) {
+        for (const Shortcut& shortcut : shard) {
+            if (hadShortcuts && shortcutGraph.hasEdge(shortcut.origin, shortcut.destination)) {
+                AssertMsg(shortcutGraph.get(TravelTime, shortcutGraph.findEdge(shortcut.origin, shortcut.destination)) == shortcut.travelTime, "Edge from " << shortcut.origin << " to " << shortcut.destination << " has inconclusive travel time (" << shortcutGraph.get(TravelTime, shortcutGraph.findEdge(shortcut.origin, shortcut.destination)) << ", " << shortcut.travelTime << ")");
+                continue;
+            }
+            shortcutGraph.addEdge(shortcut.origin, shortcut.destination).set(TravelTime, shortcut.travelTime);
+        }
+    }
+}
+
+}
@@ -32,36 +32,24 @@ public:
     void computeShortcuts(const ThreadPinning& threadPinning, const int intermediateWitnessTransferLimit = 0, const int finalWitnessTransferLimit = 0, const int minDepartureTime = -never, const int maxDepartureTime = never, const bool verbose = true) noexcept {
         if (verbose) std::cout << "Computing shortcuts with " << threadPinning.numberOfThreads << " threads." << std::endl;
 
+        const std::vector<Station> stationOfStop = computeStationOfStop(data, threadPinning);
         Progress progress(data.numberOfStops(), verbose);
+        std::vector<std::vector<Shortcut>> threadShortcuts(threadPinning.numberOfThreads);
         omp_set_num_threads(threadPinning.numberOfThreads);
         #pragma omp parallel
         {
             threadPinning.pinThread();
 
-            DynamicTransferGraph localShortcutGraph = shortcutGraph;
-            MultimodalMcShortcutSearch<Debug, TimeFactor> shortcutSearch(data, transitiveTransferGraph, localShortcutGraph, intermediateWitnessTransferLimit, finalWitnessTransferLimit);
+            MultimodalMcShortcutSearch<Debug, TimeFactor> shortcutSearch(data, stationOfStop, transitiveTransferGraph, threadShortcuts[omp_get_thread_num()], intermediateWitnessTransferLimit, finalWitnessTransferLimit);
 
             #pragma omp for schedule(dynamic)
             for (size_t i = 0; i < data.numberOfStops(); i++) {
                 shortcutSearch.run(StopId(i), minDepartureTime, maxDepartureTime);
                 progress++;
             }
-
-            #pragma omp critical
-            {
-                for (const Vertex from : shortcutGraph.vertices()) {
-                    for (const Edge edge : localShortcutGraph.edgesFrom(from)) {
-                        const Vertex to = localShortcutGraph.get(ToVertex, edge);
-                        if (!shortcutGraph.hasEdge(from, to)) {
-                            shortcutGraph.addEdge(from, to).set(TravelTime, localShortcutGraph.get(TravelTime, edge));
-                        } else {
-                            AssertMsg(shortcutGraph.get(TravelTime, shortcutGraph.findEdge(from, to)) == localShortcutGraph.get(TravelTime, edge), "Edge from " << from << " to " << to << " has inconclusive travel time (" << shortcutGraph.get(TravelTime, shortcutGraph.findEdge(from, to)) << ", " << localShortcutGraph.get(TravelTime, edge) << ")");
-                        }
-                    }
-                }
-            }
         }
         progress.finished();
+        mergeShortcuts(threadShortcuts, shortcutGraph, threadPinning);
     }
 
     inline const DynamicTransferGraph& getShortcutGraph() const noexcept {
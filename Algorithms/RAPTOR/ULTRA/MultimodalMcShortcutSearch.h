@@ -14,6 +14,9 @@
 #include "../../../DataStructures/Container/Set.h"
 #include "../../../DataStructures/Container/ExternalKHeap.h"
 #include "../../../DataStructures/RAPTOR/Data.h"
+#include "../../../DataStructures/RAPTOR/Entities/Shortcut.h"
+
+#include "Station.h"
 
 namespace RAPTOR::ULTRA {
 
@@ -500,24 +503,12 @@ public:
         }
     };
 
-    struct Station {
-        Station() : representative(noStop) {}
-        StopId representative;
-        std::vector<StopId> stops;
-        inline void add(const StopId stop) noexcept {
-            if (representative > stop) {
-                representative = stop;
-            }
-            stops.emplace_back(stop);
-        }
-    };
-
 public:
-    MultimodalMcShortcutSearch(const Data& data, const TransferGraph& transitiveTransferGraph, DynamicTransferGraph& shortcutGraph, const int intermediateWitnessTransferLimit, const int finalWitnessTransferLimit) :
+    MultimodalMcShortcutSearch(const Data& data, const std::vector<Station>& stationOfStop, const TransferGraph& transitiveTransferGraph, std::vector<RAPTOR::Shortcut>& foundShortcuts, const int intermediateWitnessTransferLimit, const int finalWitnessTransferLimit) :
         data(data),
         transitiveTransferGraph(transitiveTransferGraph),
-        shortcutGraph(shortcutGraph),
-        stationOfStop(data.numberOfStops()),
+        foundShortcuts(foundShortcuts),
+        stationOfStop(stationOfStop),
         sourceStation(),
         sourceDepartureTime(0),
         stopsReachedByDirectTransfer(data.numberOfStops()),
@@ -532,15 +523,7 @@ public:
         earliestDepartureTime(data.getMinDepartureTime()),
         timestamp(0) {
         AssertMsg(data.hasImplicitBufferTimes(), "Shortcut search requires implicit departure buffer times!");
-        Dijkstra<TransferGraph, false> dijkstra(data.transferGraph);
-        for (const StopId stop : data.stops()) {
-            dijkstra.run(stop, noVertex, [&](const Vertex u) {
-                if (!data.isStop(u)) return;
-                stationOfStop[stop].add(StopId(u));
-            }, NoOperation, [&](const Vertex, const Edge edge) {
-                return data.transferGraph.get(TravelTime, edge) > 0;
-            });
-        }
+        shortcutGraph.addVertices(data.numberOfStops());
     }
 
     inline void run(const StopId source, const int minTime, const int maxTime) noexcept {
@@ -552,6 +535,7 @@ public:
             for (const Shortcut& shortcut : shortcuts) {
                 if (!shortcutGraph.hasEdge(shortcut.origin, shortcut.destination)) {
                     shortcutGraph.addEdge(shortcut.origin, shortcut.destination).set(TravelTime, shortcut.travelTime);
+                    foundShortcuts.emplace_back(shortcut.origin, shortcut.destination, shortcut.travelTime);
                 } else {
                     AssertMsg(shortcutGraph.get(TravelTime, shortcutGraph.findEdge(shortcut.origin, shortcut.destination)) == shortcut.travelTime, "Edge from " << shortcut.origin << " to " << shortcut.destination << " has inconclusive travel time (" << shortcutGraph.get(TravelTime, shortcutGraph.findEdge(shortcut.origin, shortcut.destination)) << ", " << shortcut.travelTime << ")");
                 }
@@ -1132,8 +1116,10 @@ private:
 private:
     const Data& data;
     const TransferGraph& transitiveTransferGraph;
-    DynamicTransferGraph& shortcutGraph;
-    std::vector<Station> stationOfStop;
+    std::vector<RAPTOR::Shortcut>& foundShortcuts;
+    //Route labels that would duplicate one of these are not candidates
+    DynamicTransferGraph shortcutGraph;
+    const std::vector<Station>& stationOfStop;
 
     Station sourceStation;
     int sourceDepartureTime;
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <initializer_list>
+#include <vector>
+#include <string>
+
+#include "../../../Helpers/Timer.h"
+#include "../../../Helpers/String/String.h"
+#include "../../../Helpers/Vector/Vector.h"
+
+namespace RAPTOR::ULTRA {
+
+typedef enum {
+    PHASE_CLEAR,
+    PHASE_INITIAL_TRANSFERS,
+    PHASE_COLLECT_DEPARTURES,
+    PHASE_ROUTE_SCANS,
+    PHASE_INTERMEDIATE_TRANSFERS,
+    PHASE_FINAL_TRANSFERS,
+    NUM_PHASES
+} Phase;
+
+constexpr const char* PhaseNames[] = {
+    "Clear",
+    "Initial transfers",
+    "Collect departures",
+    "Route scans",
+    "Intermediate transfers",
+    "Final transfers",
+};
+
+typedef enum {
+    METRIC_SOURCES,
+    METRIC_DEPARTURE_TIMES,
+    METRIC_CLEARED_VERTICES,
+    METRIC_SHORTCUTS,
+    NUM_METRICS
+} Metric;
+
+constexpr const char* MetricNames[] = {
+    "Sources",
+    "Departure times",
+    "Cleared vertices",
+    "Shortcuts",
+};
+
+class NoProfiler {
+
+public:
+    inline void startPhase() const noexcept {}
+    inline void donePhase(const Phase) const noexcept {}
+
+    inline void countMetric(const Metric, const size_t = 1) const noexcept {}
+
+    inline NoProfiler& operator+=(const NoProfiler&) noexcept {return *this;}
+
+    inline void printStatistics() const noexcept {}
+};
+
+// Accumulates the time spent in each phase of the shortcut search over all sources.
+// One profiler is used per thread; the profilers of all threads are summed up afterwards.
+class AggregateProfiler : public NoProfiler {
+
+public:
+    AggregateProfiler() :
+        phaseTime(NUM_PHASES, 0.0),
+        metricValue(NUM_METRICS, 0) {
+    }
+
+    inline void startPhase() noexcept {
+        phaseTimer.restart();
+    }
+
+    inline void donePhase(const Phase phase) noexcept {
+        phaseTime[phase] += phaseTimer.elapsedMicroseconds();
+    }
+
+    inline void countMetric(const Metric metric, const size_t value = 1) noexcept {
+        metricValue[metric] += value;
+    }
+
+    inline AggregateProfiler& operator+=(const AggregateProfiler& other) noexcept {
+        for (size_t i = 0; i < NUM_PHASES; i++) {
+            phaseTime[i] += other.phaseTime[i];
+        }
+        for (size_t i = 0; i < NUM_METRICS; i++) {
+            metricValue[i] += other.metricValue[i];
+        }
+        return *this;
+    }
+
+    inline void printStatistics() const noexcept {
+        const double totalTime = Vector::sum(phaseTime);
+        std::cout << std::endl << "Shortcut search statistics (summed over all threads):" << std::endl;
+        for (size_t i = 0; i < NUM_PHASES; i++) {
+            std::cout << "\t" << std::left << std::setw(24) << PhaseNames[i] << std::right << std::setw(16) << String::msToString(phaseTime[i] / 1000) << std::setw(10) << String::percent(phaseTime[i] / totalTime) << std::endl;
+        }
+        std::cout << "\t" << std::left << std::setw(24) << "Total" << std::right << std::setw(16) << String::msToString(totalTime / 1000) << std::endl;
+        for (size_t i = 0; i < NUM_METRICS; i++) {
+            std::cout << MetricNames[i] << ": " << String::prettyInt(metricValue[i]) << std::endl;
+        }
+    }
+
+private:
+    Timer phaseTimer;
+    std::vector<double> phaseTime;
+    std::vector<size_t> metricValue;
+};
+
+}
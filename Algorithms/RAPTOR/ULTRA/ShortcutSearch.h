@@ -16,16 +16,20 @@
 #include "../../../DataStructures/RAPTOR/Data.h"
 #include "../../../DataStructures/RAPTOR/Entities/Shortcut.h"
 
+#include "Profiler.h"
+#include "Station.h"
+
 namespace RAPTOR::ULTRA {
 
-template<bool DEBUG = false, bool COUNT_OPTIMAL_CANDIDATES = false, bool IGNORE_ISOLATED_CANDIDATES = false>
+template<bool DEBUG = false, bool COUNT_OPTIMAL_CANDIDATES = false, bool IGNORE_ISOLATED_CANDIDATES = false, typename PROFILER = NoProfiler>
 class ShortcutSearch {
 
 public:
     inline static constexpr bool Debug = DEBUG;
     inline static constexpr bool CountOptimalCandidates = COUNT_OPTIMAL_CANDIDATES;
     inline static constexpr bool IgnoreIsolatedCandidates = IGNORE_ISOLATED_CANDIDATES;
-    using Type = ShortcutSearch<Debug, CountOptimalCandidates, IgnoreIsolatedCandidates>;
+    using Profiler = PROFILER;
+    using Type = ShortcutSearch<Debug, CountOptimalCandidates, IgnoreIsolatedCandidates, Profiler>;
 
 public:
     struct ArrivalLabel : public ExternalKHeapElement {
@@ -54,25 +58,21 @@ public:
         }
     };
 
-    struct Station {
-        Station() : representative(noStop) {}
-        StopId representative;
-        std::vector<StopId> stops;
-        inline void add(const StopId stop) noexcept {
-            if (representative > stop) {
-                representative = stop;
-            }
-            stops.emplace_back(stop);
-        }
-    };
-
 public:
-    ShortcutSearch(const Data& data, DynamicTransferGraph& shortcutGraph, const int witnessTransferLimit) :
+    ShortcutSearch(const Data& data, const std::vector<Station>& stationOfStop, std::vector<Shortcut>& foundShortcuts, const int witnessTransferLimit) :
         data(data),
-        shortcutGraph(shortcutGraph),
-        stationOfStop(data.numberOfStops()),
+        foundShortcuts(foundShortcuts),
+        stationOfStop(stationOfStop),
         sourceStation(),
         sourceDepartureTime(0),
+        directTransferArrivalLabels(data.transferGraph.numVertices()),
+        zeroTripsArrivalLabels(data.numberOfStops()),
+        oneTripArrivalLabels(data.transferGraph.numVertices()),
+        oneTripTimestamps(data.transferGraph.numVertices(), 0),
+        twoTripsArrivalLabels(data.transferGraph.numVertices()),
+        twoTripsTimestamps(data.transferGraph.numVertices(), 0),
+        oneTripTransferParent(data.transferGraph.numVertices(), noStop),
+        twoTripsRouteParent(data.numberOfStops(), noStop),
         shortcutCandidatesInQueue(0),
         shortcutDestinationCandidates(data.numberOfStops()),
         optimalCandidates(0),
@@ -83,22 +83,19 @@ public:
         earliestDepartureTime(data.getMinDepartureTime()),
         timestamp(0) {
         AssertMsg(data.hasImplicitBufferTimes(), "Shortcut search requires implicit departure buffer times!");
-        Dijkstra<TransferGraph, false> dijkstra(data.transferGraph);
-        for (const StopId stop : data.stops()) {
-            dijkstra.run(stop, noVertex, [&](const Vertex u) {
-                if (!data.isStop(u)) return;
-                stationOfStop[stop].add(StopId(u));
-            }, NoOperation, [&](const Vertex, const Edge edge) {
-                return data.transferGraph.get(TravelTime, edge) > 0;
-            });
-        }
+        shortcutGraph.addVertices(data.numberOfStops());
     }
 
     inline void run(const StopId source, const int minTime, const int maxTime) noexcept {
         AssertMsg(data.isStop(source), "source (" << source << ") is not a stop!");
         if (stationOfStop[source].representative != source) return;
+        profiler.countMetric(METRIC_SOURCES);
         setSource(source);
-        for (const ConsolidatedDepartureLabel& label : collectDepartures(minTime, maxTime)) {
+        profiler.startPhase();
+        const std::vector<ConsolidatedDepartureLabel> departures = collectDepartures(minTime, maxTime);
+        profiler.donePhase(PHASE_COLLECT_DEPARTURES);
+        profiler.countMetric(METRIC_DEPARTURE_TIMES, departures.size());
+        for (const ConsolidatedDepartureLabel& label : departures) {
             runForDepartureTime(label);
             if constexpr (CountOptimalCandidates) {
                 optimalCandidates += shortcuts.size();
@@ -106,6 +103,8 @@ public:
             for (const Shortcut& shortcut : shortcuts) {
                 if (!shortcutGraph.hasEdge(shortcut.origin, shortcut.destination)) {
                     shortcutGraph.addEdge(shortcut.origin, shortcut.destination).set(TravelTime, shortcut.travelTime);
+                    foundShortcuts.emplace_back(shortcut.origin, shortcut.destination, shortcut.travelTime);
+                    profiler.countMetric(METRIC_SHORTCUTS);
                 } else {
                     AssertMsg(shortcutGraph.get(TravelTime, shortcutGraph.findEdge(shortcut.origin, shortcut.destination)) == shortcut.travelTime, "Edge from " << shortcut.origin << " to " << shortcut.destination << " has inconclusive travel time (" << shortcutGraph.get(TravelTime, shortcutGraph.findEdge(shortcut.origin, shortcut.destination)) << ", " << shortcut.travelTime << ")");
                 }
@@ -118,14 +117,22 @@ public:
         return optimalCandidates;
     }
 
+    inline const Profiler& getProfiler() const noexcept {
+        return profiler;
+    }
+
 private:
     inline void setSource(const StopId source) noexcept {
         AssertMsg(directTransferQueue.empty(), "Queue for round 0 is not empty!");
         AssertMsg(stationOfStop[source].representative == source, "Source " << source << " is not representative of its station!");
+        profiler.startPhase();
         clear();
+        profiler.donePhase(PHASE_CLEAR);
+        profiler.startPhase();
         sourceStation = stationOfStop[source];
         initialDijkstra();
         sort(stopsReachedByDirectTransfer);
+        profiler.donePhase(PHASE_INITIAL_TRANSFERS);
         if constexpr (Debug) {
             std::cout << "   Source stop: " << source << std::endl;
             std::cout << "   Number of stops reached by direct transfer: " << String::prettyInt(stopsReachedByDirectTransfer.size()) << std::endl;
@@ -145,13 +152,23 @@ private:
         stopsUpdatedByTransfer.clear();
 
         sourceDepartureTime = label.departureTime;
+        profiler.startPhase();
         relaxInitialTransfers();
+        profiler.donePhase(PHASE_INITIAL_TRANSFERS);
+        profiler.startPhase();
         collectRoutes1(label.routes);
         scanRoutes<1>();
+        profiler.donePhase(PHASE_ROUTE_SCANS);
+        profiler.startPhase();
         intermediateDijkstra();
+        profiler.donePhase(PHASE_INTERMEDIATE_TRANSFERS);
+        profiler.startPhase();
         collectRoutes2();
         scanRoutes<2>();
+        profiler.donePhase(PHASE_ROUTE_SCANS);
+        profiler.startPhase();
         finalDijkstra();
+        profiler.donePhase(PHASE_FINAL_TRANSFERS);
     }
 
     inline std::vector<ConsolidatedDepartureLabel> collectDepartures(const int minTime, const int maxTime) noexcept {
@@ -195,24 +212,30 @@ private:
     }
 
 private:
+    // Only the labels of vertices reached by the previous source are reset, the label vectors are never reallocated.
+    // The heaps locate labels by pointer arithmetic, so the labels stay in contiguous vectors.
     inline void clear() noexcept {
-        sourceStation = Station();
+        sourceStation.representative = noStop;
+        sourceStation.stops.clear();
 
-        std::vector<ArrivalLabel>(data.transferGraph.numVertices()).swap(directTransferArrivalLabels);
         stopsReachedByDirectTransfer.clear();
-
-        std::vector<ArrivalLabel>(data.numberOfStops()).swap(zeroTripsArrivalLabels);
-
         oneTripQueue.clear();
-        std::vector<ArrivalLabel>(data.transferGraph.numVertices()).swap(oneTripArrivalLabels);
-        std::vector<u_int16_t>(data.transferGraph.numVertices(), 0).swap(oneTripTimestamps);
-
         twoTripsQueue.clear();
-        std::vector<ArrivalLabel>(data.transferGraph.numVertices()).swap(twoTripsArrivalLabels);
-        std::vector<u_int16_t>(data.transferGraph.numVertices(), 0).swap(twoTripsTimestamps);
 
-        std::vector<StopId>(data.transferGraph.numVertices(), noStop).swap(oneTripTransferParent);
-        std::vector<StopId>(data.numberOfStops(), noStop).swap(twoTripsRouteParent);
+        profiler.countMetric(METRIC_CLEARED_VERTICES, touchedVertices.size());
+        for (const Vertex vertex : touchedVertices) {
+            directTransferArrivalLabels[vertex].arrivalTime = never;
+            oneTripArrivalLabels[vertex].arrivalTime = never;
+            oneTripTimestamps[vertex] = 0;
+            twoTripsArrivalLabels[vertex].arrivalTime = never;
+            twoTripsTimestamps[vertex] = 0;
+            oneTripTransferParent[vertex] = noStop;
+            if (data.isStop(vertex)) {
+                zeroTripsArrivalLabels[vertex].arrivalTime = never;
+                twoTripsRouteParent[vertex] = noStop;
+            }
+        }
+        touchedVertices.clear();
 
         shortcutCandidatesInQueue = 0;
         shortcutDestinationCandidates.clear();
@@ -325,6 +348,7 @@ private:
     }
 
     inline void initialDijkstra() noexcept {
+        touch(sourceStation.representative);
         directTransferArrivalLabels[sourceStation.representative].arrivalTime = 0;
         directTransferQueue.update(&(directTransferArrivalLabels[sourceStation.representative]));
         while (!directTransferQueue.empty()) {
@@ -334,6 +358,7 @@ private:
                 const Vertex neighborVertex = data.transferGraph.get(ToVertex, edge);
                 const int newArrivalTime = currentLabel->arrivalTime + data.transferGraph.get(TravelTime, edge);
                 if (newArrivalTime < directTransferArrivalLabels[neighborVertex].arrivalTime) {
+                    touch(neighborVertex);
                     directTransferArrivalLabels[neighborVertex].arrivalTime = newArrivalTime;
                     directTransferQueue.update(&(directTransferArrivalLabels[neighborVertex]));
                 }
@@ -588,22 +613,36 @@ private:
             zeroTripsArrivalLabels[vertex].arrivalTime = arrivalTime;
             suppressUnusedParameterWarning(labelTimestamp);
         } else if constexpr (ROUND == 1) {
+            touch(vertex);
             oneTripArrivalLabels[vertex].arrivalTime = arrivalTime;
             oneTripTimestamps[vertex] = labelTimestamp;
         } else if constexpr (ROUND == 2) {
+            touch(vertex);
             twoTripsArrivalLabels[vertex].arrivalTime = arrivalTime;
             twoTripsTimestamps[vertex] = labelTimestamp;
         }
     }
 
+    // Remembers the vertex for the next clear() when the first of its labels is set. The parent pointers of a vertex
+    // are only set together with one of its arrival labels, and zeroTripsArrivalLabels only for stops that were
+    // already reached by the initial Dijkstra search.
+    inline void touch(const Vertex vertex) noexcept {
+        if (directTransferArrivalLabels[vertex].arrivalTime != never) return;
+        if (oneTripArrivalLabels[vertex].arrivalTime != never) return;
+        if (twoTripsArrivalLabels[vertex].arrivalTime != never) return;
+        touchedVertices.emplace_back(vertex);
+    }
+
     inline bool isShortcutCandidate(const Vertex vertex) const noexcept {
         return oneTripArrivalLabels[vertex].isOnHeap() && data.isStop(oneTripTransferParent[vertex]);
     }
 
 private:
     const Data& data;
-    DynamicTransferGraph& shortcutGraph;
-    std::vector<Station> stationOfStop;
+    std::vector<Shortcut>& foundShortcuts;
+    //Known shortcuts are neither added twice nor reconsidered as candidates
+    DynamicTransferGraph shortcutGraph;
+    const std::vector<Station>& stationOfStop;
 
     Station sourceStation;
     int sourceDepartureTime;
@@ -626,6 +665,9 @@ private:
     std::vector<StopId> oneTripTransferParent;
     std::vector<StopId> twoTripsRouteParent;
 
+    //Vertices with at least one label that has to be reset before the next source
+    std::vector<Vertex> touchedVertices;
+
     size_t shortcutCandidatesInQueue;
     //Maps potential shortcut destinations to the final stops of the candidate journeys using that shortcut
     IndexedMap<Set<StopId>, false, StopId> shortcutDestinationCandidates;
@@ -642,6 +684,8 @@ private:
 
     u_int16_t timestamp;
 
+    Profiler profiler;
+
 };
 
 }
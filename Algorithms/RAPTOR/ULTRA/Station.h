@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "../../Dijkstra/Dijkstra.h"
+
+#include "../../../Helpers/MultiThreading.h"
+
+#include "../../../DataStructures/RAPTOR/Data.h"
+
+namespace RAPTOR::ULTRA {
+
+struct Station {
+    Station() : representative(noStop) {}
+    StopId representative;
+    std::vector<StopId> stops;
+    inline void add(const StopId stop) noexcept {
+        if (representative > stop) {
+            representative = stop;
+        }
+        stops.emplace_back(stop);
+    }
+};
+
+// Stops that are connected by transfers with travel time 0 form a station.
+// The mapping is computed once per preprocessing run and shared read-only by all shortcut searches.
+inline std::vector<Station> computeStationOfStop(const Data& data, const ThreadPinning& threadPinning) noexcept {
+    std::vector<Station> stationOfStop(data.numberOfStops());
+    omp_set_num_threads(threadPinning.numberOfThreads);
+    #pragma omp parallel
+    {
+        threadPinning.pinThread();
+        Dijkstra<TransferGraph, false> dijkstra(data.transferGraph);
+
+        #pragma omp for schedule(dynamic, 64)
+        for (size_t i = 0; i < data.numberOfStops(); i++) {
+            const StopId stop(i);
+            dijkstra.run(stop, noVertex, [&](const Vertex u) {
+                if (!data.isStop(u)) return;
+                stationOfStop[stop].add(StopId(u));
+            }, NoOperation, [&](const Vertex, const Edge edge) {
+                return data.transferGraph.get(TravelTime, edge) > 0;
+            });
+        }
+    }
+    return stationOfStop;
+}
+
+}
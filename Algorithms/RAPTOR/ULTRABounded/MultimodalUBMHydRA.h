@@ -465,20 +465,18 @@ private:
             StopId stop = stops[stopIndex];
 
             const StopEvent* firstTrip = raptorData.firstTripOfRoute(route);
-            const StopEvent* lastTrip = raptorData.lastTripOfRoute(route);
+            const int* departureTimes = raptorData.departureTimesOfRoute(route);
+            const size_t numberOfTrips = raptorData.numberOfTripsInRoute(route);
 
             RouteBagType routeBag;
 
             while (stopIndex < tripSize - 1) {
                 for (size_t i = 0; i < previousRound()[stop].size(); i++) {
                     const Label& label = previousRound()[stop][i];
-                    const StopEvent* trip = firstTrip;
-                    while ((trip < lastTrip) && (trip[stopIndex].departureTime < label.arrivalTime)) {
-                        trip += tripSize;
-                    }
-                    if (trip[stopIndex].departureTime < label.arrivalTime) continue;
-                    const size_t tripOffset = (trip - firstTrip) / tripSize;
-                    const TripId reverseTrip = backwardPruningQuery.getReverseTrip(route, tripOffset);
+                    const size_t tripIndex = findEarliestTripForward(departureTimes + (stopIndex * numberOfTrips), 0, numberOfTrips, label.arrivalTime);
+                    if (tripIndex == numberOfTrips) continue;
+                    const StopEvent* trip = firstTrip + (tripIndex * tripSize);
+                    const TripId reverseTrip = backwardPruningQuery.getReverseTrip(route, tripIndex);
                     const StopIndex reachedIndex = StopIndex(tripSize - backwardPruningQuery.getReachedIndex(reverseTrip, maxTrips - currentNumberOfTrips()) - 1);
                     if (reachedIndex < stopIndex) continue;
                     routeBag.merge(RouteLabel(trip, label, stopIndex, i, reachedIndex));
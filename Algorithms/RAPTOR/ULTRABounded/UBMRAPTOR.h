@@ -96,7 +96,7 @@ private:
     };
 
     using BagType = Bag<Label>;
-    using BestBagType = Bag<BestLabel>;
+    using BestBagType = ParetoBag;
     using Round = std::vector<BagType>;
     using RouteBagType = RouteBag<RouteLabel>;
 
@@ -290,18 +290,17 @@ private:
             StopId stop = stops[stopIndex];
 
             const StopEvent* firstTrip = data.firstTripOfRoute(route);
-            const StopEvent* lastTrip = data.lastTripOfRoute(route);
+            const int* departureTimes = data.departureTimesOfRoute(route);
+            const size_t numberOfTrips = data.numberOfTripsInRoute(route);
 
             RouteBagType routeBag;
 
             while (stopIndex < tripSize - 1) {
                 for (size_t i = 0; i < previousRound()[stop].size(); i++) {
                     const Label& label = previousRound()[stop][i];
-                    const StopEvent* trip = firstTrip;
-                    while ((trip < lastTrip) && (trip[stopIndex].departureTime < label.arrivalTime)) {
-                        trip += tripSize;
-                    }
-                    if (trip[stopIndex].departureTime < label.arrivalTime) continue;
+                    const size_t tripIndex = findEarliestTripForward(departureTimes + (stopIndex * numberOfTrips), 0, numberOfTrips, label.arrivalTime);
+                    if (tripIndex == numberOfTrips) continue;
+                    const StopEvent* trip = firstTrip + (tripIndex * tripSize);
 
                     RouteLabel newLabel;
                     newLabel.trip = trip;
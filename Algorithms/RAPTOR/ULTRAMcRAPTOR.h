@@ -202,11 +202,13 @@ public:
         targetStop = StopId(data.numberOfStops());
         sourceDepartureTime = never;
         if constexpr (RESET_CAPACITIES) {
-            std::vector<Round>().swap(rounds);
+            rounds.reset();
             std::vector<BestBagType>(bestLabels.size()).swap(bestLabels);
         } else {
             rounds.clear();
-            Vector::fill(bestLabels);
+            for (BestBagType& bag : bestLabels) {
+                bag.clear();
+            }
         }
     }
 
@@ -262,18 +264,17 @@ private:
             StopId stop = stops[stopIndex];
 
             const StopEvent* firstTrip = data.firstTripOfRoute(route);
-            const StopEvent* lastTrip = data.lastTripOfRoute(route);
+            const int* departureTimes = data.departureTimesOfRoute(route);
+            const size_t numberOfTrips = data.numberOfTripsInRoute(route);
 
-            RouteBagType routeBag;
+            routeBag.clear();
 
             while (stopIndex < tripSize - 1) {
                 for (size_t i = 0; i < previousRound()[stop].size(); i++) {
                     const Label& label = previousRound()[stop][i];
-                    const StopEvent* trip = firstTrip;
-                    while ((trip < lastTrip) && (trip[stopIndex].departureTime < label.arrivalTime)) {
-                        trip += tripSize;
-                    }
-                    if (trip[stopIndex].departureTime < label.arrivalTime) continue;
+                    const size_t tripIndex = findEarliestTripForward(departureTimes + (stopIndex * numberOfTrips), 0, numberOfTrips, label.arrivalTime);
+                    if (tripIndex == numberOfTrips) continue;
+                    const StopEvent* trip = firstTrip + (tripIndex * tripSize);
 
                     RouteLabel newLabel;
                     newLabel.trip = trip;
@@ -389,7 +390,7 @@ private:
     }
 
     inline void startNewRound() noexcept {
-        rounds.emplace_back(data.numberOfStops() + 1);
+        rounds.addRound(data.numberOfStops() + 1);
     }
 
     inline void arrival(const StopId stop, const Label& label, IndexedSet<false, StopId>& updatedStops, Metric metric) noexcept {
@@ -428,7 +429,8 @@ private:
 
     BucketCHInitialTransfers initialTransfers;
 
-    std::vector<Round> rounds;
+    BagRounds<BagType> rounds;
+    RouteBagType routeBag;
 
     std::vector<BestBagType> bestLabels;
 
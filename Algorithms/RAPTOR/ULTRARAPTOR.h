@@ -6,7 +6,10 @@
 
 #include "InitialTransfers.h"
 
+#include "../../Helpers/Helpers.h"
+
 #include "../../DataStructures/RAPTOR/Data.h"
+#include "../../DataStructures/RAPTOR/Entities/ArrivalLabel.h"
 #include "../../DataStructures/RAPTOR/Entities/EarliestArrivalTime.h"
 #include "../../DataStructures/Container/Set.h"
 #include "../../DataStructures/Container/Map.h"
@@ -43,10 +46,27 @@ private:
     };
     using Round = std::vector<EarliestArrivalLabel>;
 
+    struct DepartureLabel {
+        DepartureLabel(const RouteId routeId = noRouteId, const StopIndex stopIndex = noStopIndex, const int departureTime = never) : route(routeId, stopIndex), departureTime(departureTime) {}
+        RouteSegment route;
+        int departureTime;
+        inline bool operator<(const DepartureLabel& other) const noexcept {
+            return (departureTime > other.departureTime) || ((departureTime == other.departureTime) && (route.routeId < other.route.routeId));
+        }
+    };
+
+    struct ConsolidatedDepartureLabel {
+        ConsolidatedDepartureLabel(const int departureTime = never) : departureTime(departureTime) {}
+        std::vector<RouteSegment> routes;
+        int departureTime;
+    };
+
 public:
     ULTRARAPTOR(const Data& data, const InitialTransferType initialTransfers, const Profiler& profilerTemplate = Profiler()) :
         data(data),
         initialTransfers(initialTransfers),
+        numberOfRounds(0),
+        numberOfUsedRounds(0),
         earliestArrival(data.numberOfStops() + 1),
         stopsUpdatedByRoute(data.numberOfStops() + 1),
         stopsUpdatedByTransfer(data.numberOfStops() + 1),
@@ -89,38 +109,60 @@ public:
         initialize(source, departureTime, target);
         profiler.donePhase(PHASE_INITIALIZATION);
         profiler.startPhase();
+        initialTransfers.template run<!PreventDirectWalking>(sourceVertex, targetVertex);
         relaxInitialTransfers(departureTime);
         profiler.donePhase(PHASE_TRANSFERS);
         profiler.doneRound();
 
-        for (size_t i = 0; i < maxRounds; i++) {
-            profiler.startRound();
+        runRounds(maxRounds);
+        profiler.done();
+    }
+
+    // rRAPTOR: Runs one query per departure time of a trip at a stop reachable by the initial transfers within
+    // [minDepartureTime, maxDepartureTime], from the latest to the earliest. The initial and final transfers are
+    // computed only once, and the round labels are kept between the departure times, so every label of a later
+    // departure prunes the search for earlier ones. Afterwards, getProfile() returns the Pareto profile
+    // (departure time, arrival time, number of trips) at the target. The journeys and arrivals of the individual
+    // departure times are not available.
+    inline void runProfile(const Vertex source, const int minDepartureTime, const int maxDepartureTime, const Vertex target, const size_t maxRounds = INFTY) noexcept {
+        profiler.start();
+        profiler.startExtraRound(EXTRA_ROUND_CLEAR);
+        clear();
+        profile.clear();
+        profileArrivalTimes.clear();
+        profiler.doneRound();
+
+        profiler.startExtraRound(EXTRA_ROUND_INITIALIZATION);
+        profiler.startPhase();
+        initialTransfers.template run<!PreventDirectWalking>(source, target);
+        profiler.donePhase(PHASE_TRANSFERS);
+        profiler.startPhase();
+        const std::vector<ConsolidatedDepartureLabel> departures = collectDepartures(source, minDepartureTime, maxDepartureTime, target);
+        profiler.donePhase(PHASE_INITIALIZATION);
+        profiler.doneRound();
+
+        for (size_t i = 0; i < departures.size(); i++) {
+            profiler.restartRounds();
+            profiler.startExtraRound(EXTRA_ROUND_INITIALIZATION);
             profiler.startPhase();
-            startNewRound();
+            startNewDepartureTime();
+            initialize<true>(source, departures[i].departureTime, target);
             profiler.donePhase(PHASE_INITIALIZATION);
             profiler.startPhase();
-            collectRoutesServingUpdatedStops();
-            profiler.donePhase(PHASE_COLLECT);
-            profiler.startPhase();
-            scanRoutes();
-            profiler.donePhase(PHASE_SCAN);
-            if (stopsUpdatedByRoute.empty()) {
-                profiler.doneRound();
-                break;
-            }
-            if constexpr (SeparateRouteAndTransferEntries) {
-                profiler.startPhase();
-                startNewRound();
-                profiler.donePhase(PHASE_INITIALIZATION);
-            }
-            profiler.startPhase();
-            relaxIntermediateTransfers();
+            relaxInitialTransfers<true>(departures[i].departureTime);
             profiler.donePhase(PHASE_TRANSFERS);
             profiler.doneRound();
+            // The first departure time scans all routes, which covers the trips departing after maxDepartureTime.
+            runRounds<true>(maxRounds, (i == 0) ? nullptr : &departures[i].routes);
+            addProfileLabels(departures[i].departureTime);
         }
         profiler.done();
     }
 
+    inline const std::vector<ProfileLabel>& getProfile() const noexcept {
+        return profile;
+    }
+
     inline std::vector<Journey> getJourneys() const noexcept {
         return getJourneys(targetStop);
     }
@@ -128,7 +170,7 @@ public:
     inline std::vector<Journey> getJourneys(const Vertex vertex) const noexcept {
         const StopId target = (vertex == targetVertex) ? (targetStop) : (StopId(vertex));
         std::vector<Journey> journeys;
-        for (size_t i = 0; i < rounds.size(); i += RoundFactor) {
+        for (size_t i = 0; i < numberOfRounds; i += RoundFactor) {
             getJourney(journeys, i, target);
         }
         return journeys;
@@ -146,7 +188,7 @@ public:
     inline std::vector<ArrivalLabel> getArrivals(const Vertex vertex) const noexcept {
         const StopId target = (vertex == targetVertex) ? (targetStop) : (StopId(vertex));
         std::vector<ArrivalLabel> labels;
-        for (size_t i = 0; i < rounds.size(); i += RoundFactor) {
+        for (size_t i = 0; i < numberOfRounds; i += RoundFactor) {
             getArrival(labels, i, target);
         }
         return labels;
@@ -159,7 +201,7 @@ public:
     inline std::vector<int> getArrivalTimes(const Vertex vertex) const noexcept {
         const StopId target = (vertex == targetVertex) ? (targetStop) : (StopId(vertex));
         std::vector<int> arrivalTimes;
-        for (size_t i = 0; i < rounds.size(); i += RoundFactor) {
+        for (size_t i = 0; i < numberOfRounds; i += RoundFactor) {
             getArrivalTime(arrivalTimes, i, target);
         }
         return arrivalTimes;
@@ -181,7 +223,7 @@ public:
 
     inline int getEarliestArrivalNumberOfTrips() const noexcept {
         const int eat = getEarliestArrivalTime();
-        for (size_t i = rounds.size() - 1; i < rounds.size(); i -= RoundFactor) {
+        for (size_t i = numberOfRounds - 1; i < numberOfRounds; i -= RoundFactor) {
             if (rounds[i][targetStop].arrivalTime == eat) return i;
         }
         return -1;
@@ -229,7 +271,7 @@ public:
         const StopId target = (vertex == targetVertex) ? (targetStop) : (StopId(vertex));
         size_t round = numberOfTrips * RoundFactor;
         if constexpr (SeparateRouteAndTransferEntries) {
-            if ((round + 1 < rounds.size()) && (rounds[round + 1][target].arrivalTime < rounds[round][target].arrivalTime)) round++;
+            if ((round + 1 < numberOfRounds) && (rounds[round + 1][target].arrivalTime < rounds[round][target].arrivalTime)) round++;
         }
         AssertMsg(rounds[round][target].arrivalTime < never, "No label found for stop " << target << " in round " << round << "!");
         return rounds[round][target].arrivalTime;
@@ -242,13 +284,17 @@ public:
         routesServingUpdatedStops.clear();
         targetStop = StopId(data.numberOfStops());
         sourceDepartureTime = never;
+        numberOfRounds = 0;
         if constexpr (RESET_CAPACITIES) {
             std::vector<Round>().swap(rounds);
             std::vector<int>(earliestArrival.size(), never).swap(earliestArrival);
         } else {
-            rounds.clear();
+            for (size_t i = 0; i < numberOfUsedRounds; i++) {
+                Vector::fill(rounds[i]);
+            }
             Vector::fill(earliestArrival);
         }
+        numberOfUsedRounds = 0;
     }
 
     inline void reset() noexcept {
@@ -256,6 +302,41 @@ public:
     }
 
 private:
+    // In profile mode, the round labels of later departure times are kept, and they also prune the search.
+    template<bool PROFILE = false>
+    inline void runRounds(const size_t maxRounds, const std::vector<RouteSegment>* departureRoutes = nullptr) noexcept {
+        for (size_t i = 0; i < maxRounds; i++) {
+            profiler.startRound();
+            profiler.startPhase();
+            startNewRound();
+            profiler.donePhase(PHASE_INITIALIZATION);
+            profiler.startPhase();
+            if (i == 0 && departureRoutes) {
+                collectRoutes(*departureRoutes);
+            } else {
+                collectRoutesServingUpdatedStops();
+            }
+            profiler.donePhase(PHASE_COLLECT);
+            profiler.startPhase();
+            scanRoutes<PROFILE>();
+            profiler.donePhase(PHASE_SCAN);
+            if (stopsUpdatedByRoute.empty()) {
+                profiler.doneRound();
+                break;
+            }
+            if constexpr (SeparateRouteAndTransferEntries) {
+                profiler.startPhase();
+                startNewRound();
+                profiler.donePhase(PHASE_INITIALIZATION);
+            }
+            profiler.startPhase();
+            relaxIntermediateTransfers<PROFILE>();
+            profiler.donePhase(PHASE_TRANSFERS);
+            profiler.doneRound();
+        }
+    }
+
+    template<bool PROFILE = false>
     inline void initialize(const Vertex source, const int departureTime, const Vertex target) noexcept {
         sourceVertex = source;
         targetVertex = target;
@@ -265,7 +346,7 @@ private:
         sourceDepartureTime = departureTime;
         startNewRound();
         if (data.isStop(source)) {
-            arrivalByRoute(StopId(source), sourceDepartureTime);
+            arrivalByRoute<PROFILE>(StopId(source), sourceDepartureTime);
             currentRound()[source].parent = source;
             currentRound()[source].parentDepartureTime = sourceDepartureTime;
             currentRound()[source].usesRoute = false;
@@ -274,6 +355,77 @@ private:
         if constexpr (SeparateRouteAndTransferEntries) startNewRound();
     }
 
+    inline std::vector<ConsolidatedDepartureLabel> collectDepartures(const Vertex source, const int minDepartureTime, const int maxDepartureTime, const Vertex target) const noexcept {
+        std::vector<DepartureLabel> departureLabels;
+        if (data.isStop(source)) {
+            collectDepartures(StopId(source), 0, minDepartureTime, maxDepartureTime, departureLabels);
+        }
+        for (const Vertex stop : initialTransfers.getForwardPOIs()) {
+            if (stop == target || stop == source) continue;
+            AssertMsg(data.isStop(stop), "Reached POI " << stop << " is not a stop!");
+            collectDepartures(StopId(stop), initialTransfers.getForwardDistance(stop), minDepartureTime, maxDepartureTime, departureLabels);
+        }
+        sort(departureLabels);
+        std::vector<ConsolidatedDepartureLabel> result;
+        for (const DepartureLabel& label : departureLabels) {
+            if (result.empty() || result.back().departureTime != label.departureTime) {
+                result.emplace_back(label.departureTime);
+            }
+            result.back().routes.emplace_back(label.route);
+        }
+        return result;
+    }
+
+    inline void collectDepartures(const StopId stop, const int transferTime, const int minDepartureTime, const int maxDepartureTime, std::vector<DepartureLabel>& departureLabels) const noexcept {
+        for (const RouteSegment& route : data.routesContainingStop(stop)) {
+            const size_t tripSize = data.numberOfStopsInRoute(route.routeId);
+            if (route.stopIndex + 1 == tripSize) continue;
+            for (const StopEvent* trip = data.firstTripOfRoute(route.routeId); trip <= data.lastTripOfRoute(route.routeId); trip += tripSize) {
+                const int departureTime = trip[route.stopIndex].departureTime - transferTime;
+                if (departureTime < minDepartureTime) continue;
+                if (departureTime > maxDepartureTime) break;
+                departureLabels.emplace_back(route.routeId, route.stopIndex, departureTime);
+            }
+        }
+    }
+
+    inline void startNewDepartureTime() noexcept {
+        stopsUpdatedByRoute.clear();
+        stopsUpdatedByTransfer.clear();
+        routesServingUpdatedStops.clear();
+        numberOfRounds = 0;
+        Vector::fill(earliestArrival);
+    }
+
+    // Adds a profile label for every number of trips for which the arrival time at the target improved. The rounds
+    // still contain the arrivals of all later departure times, so an improvement can only stem from a journey that
+    // departs at the current departure time.
+    inline void addProfileLabels(const int departureTime) noexcept {
+        const size_t maxNumberOfTrips = (numberOfUsedRounds + RoundFactor - 1) / RoundFactor;
+        if (profileArrivalTimes.size() < maxNumberOfTrips) profileArrivalTimes.resize(maxNumberOfTrips, never);
+        int arrivalTime = never;
+        for (size_t numberOfTrips = 0; numberOfTrips < profileArrivalTimes.size(); numberOfTrips++) {
+            const int arrivalTimeWithFewerTrips = arrivalTime;
+            for (size_t round = numberOfTrips * RoundFactor; round < std::min(numberOfUsedRounds, (numberOfTrips + 1) * RoundFactor); round++) {
+                arrivalTime = std::min(arrivalTime, rounds[round][targetStop].arrivalTime);
+            }
+            if (arrivalTime < arrivalTimeWithFewerTrips && arrivalTime < profileArrivalTimes[numberOfTrips]) {
+                profile.emplace_back(departureTime, arrivalTime, numberOfTrips);
+            }
+            profileArrivalTimes[numberOfTrips] = arrivalTime;
+        }
+    }
+
+    inline void collectRoutes(const std::vector<RouteSegment>& routes) noexcept {
+        for (const RouteSegment& route : routes) {
+            if (routesServingUpdatedStops.contains(route.routeId)) {
+                routesServingUpdatedStops[route.routeId] = std::min(routesServingUpdatedStops[route.routeId], route.stopIndex);
+            } else {
+                routesServingUpdatedStops.insert(route.routeId, route.stopIndex);
+            }
+        }
+    }
+
     inline void collectRoutesServingUpdatedStops() noexcept {
         for (const StopId stop : stopsUpdatedByTransfer) {
             AssertMsg(data.isStop(stop), "Stop " << stop << " is out of range!");
@@ -293,6 +445,7 @@ private:
         }
     }
 
+    template<bool PROFILE>
     inline void scanRoutes() noexcept {
         stopsUpdatedByRoute.clear();
         for (const RouteId route : routesServingUpdatedStops.getKeys()) {
@@ -308,15 +461,20 @@ private:
 
             StopIndex parentIndex = stopIndex;
             const StopEvent* firstTrip = data.firstTripOfRoute(route);
+            const int* departureTimes = data.departureTimesOfRoute(route);
+            const size_t numberOfTrips = data.numberOfTripsInRoute(route);
+            size_t tripIndex = numberOfTrips - 1;
             while (stopIndex < tripSize - 1) {
-                while ((trip > firstTrip) && ((trip - tripSize + stopIndex)->departureTime >= previousRound()[stop].arrivalTime)) {
-                    trip -= tripSize;
+                const size_t earliestTrip = findEarliestTripBackward(departureTimes + (stopIndex * numberOfTrips), tripIndex, previousRound()[stop].arrivalTime);
+                if (earliestTrip < tripIndex) {
+                    tripIndex = earliestTrip;
+                    trip = firstTrip + (tripIndex * tripSize);
                     parentIndex = stopIndex;
                 }
                 stopIndex++;
                 stop = stops[stopIndex];
                 profiler.countMetric(METRIC_ROUTE_SEGMENTS);
-                if (arrivalByRoute(stop, trip[stopIndex].arrivalTime)) {
+                if (arrivalByRoute<PROFILE>(stop, trip[stopIndex].arrivalTime)) {
                     EarliestArrivalLabel& label = currentRound()[stop];
                     label.parent = stops[parentIndex];
                     label.parentDepartureTime = trip[parentIndex].departureTime;
@@ -327,14 +485,14 @@ private:
         }
     }
 
+    template<bool PROFILE = false>
     inline void relaxInitialTransfers(const int sourceDepartureTime) noexcept {
-        initialTransfers.template run<!PreventDirectWalking>(sourceVertex, targetVertex);
         for (const Vertex stop : initialTransfers.getForwardPOIs()) {
             if (stop == targetStop) continue;
             AssertMsg(data.isStop(stop), "Reached POI " << stop << " is not a stop!");
             AssertMsg(initialTransfers.getForwardDistance(stop) != INFTY, "Vertex " << stop << " was not reached!");
             const int arrivalTime = sourceDepartureTime + initialTransfers.getForwardDistance(stop);
-            if (arrivalByTransfer(StopId(stop), arrivalTime)) {
+            if (arrivalByTransfer<PROFILE>(StopId(stop), arrivalTime)) {
                 EarliestArrivalLabel& label = currentRound()[stop];
                 label.parent = sourceVertex;
                 label.parentDepartureTime = sourceDepartureTime;
@@ -345,7 +503,7 @@ private:
         if constexpr (!PreventDirectWalking) {
             if (initialTransfers.getDistance() != INFTY) {
                 const int arrivalTime = sourceDepartureTime + initialTransfers.getDistance();
-                if (arrivalByTransfer(targetStop, arrivalTime)) {
+                if (arrivalByTransfer<PROFILE>(targetStop, arrivalTime)) {
                     EarliestArrivalLabel& label = currentRound()[targetStop];
                     label.parent = sourceVertex;
                     label.parentDepartureTime = sourceDepartureTime;
@@ -356,6 +514,7 @@ private:
         }
     }
 
+    template<bool PROFILE>
     inline void relaxIntermediateTransfers() noexcept {
         stopsUpdatedByTransfer.clear();
         routesServingUpdatedStops.clear();
@@ -367,7 +526,7 @@ private:
                 profiler.countMetric(METRIC_EDGES);
                 const int arrivalTime = earliestArrivalTime + data.transferGraph.get(TravelTime, edge);
                 AssertMsg(data.isStop(data.transferGraph.get(ToVertex, edge)), "Graph contains edges to non stop vertices!");
-                if (arrivalByTransfer(toStop, arrivalTime)) {
+                if (arrivalByTransfer<PROFILE>(toStop, arrivalTime)) {
                     EarliestArrivalLabel& label = currentRound()[toStop];
                     label.parent = stop;
                     label.parentDepartureTime = earliestArrivalTime;
@@ -377,7 +536,7 @@ private:
             }
             if (initialTransfers.getBackwardDistance(stop) != INFTY) {
                 const int arrivalTime = earliestArrivalTime + initialTransfers.getBackwardDistance(stop);
-                if (arrivalByTransfer(targetStop, arrivalTime)) {
+                if (arrivalByTransfer<PROFILE>(targetStop, arrivalTime)) {
                     EarliestArrivalLabel& label = currentRound()[targetStop];
                     label.parent = stop;
                     label.parentDepartureTime = earliestArrivalTime;
@@ -386,7 +545,7 @@ private:
                 }
             }
             if constexpr (SeparateRouteAndTransferEntries) {
-                if (arrivalByTransfer(stop, earliestArrivalTime)) {
+                if (arrivalByTransfer<PROFILE>(stop, earliestArrivalTime)) {
                     EarliestArrivalLabel& label = currentRound()[stop];
                     label.parent = stop;
                     label.parentDepartureTime = earliestArrivalTime;
@@ -399,23 +558,30 @@ private:
     }
 
     inline Round& currentRound() noexcept {
-        AssertMsg(!rounds.empty(), "Cannot return current round, because no round exists!");
-        return rounds.back();
+        AssertMsg(numberOfRounds > 0, "Cannot return current round, because no round exists!");
+        return rounds[numberOfRounds - 1];
     }
 
     inline Round& previousRound() noexcept {
-        AssertMsg(rounds.size() >= 2, "Cannot return previous round, because less than two rounds exist!");
-        return rounds[rounds.size() - 2];
+        AssertMsg(numberOfRounds >= 2, "Cannot return previous round, because less than two rounds exist!");
+        return rounds[numberOfRounds - 2];
     }
 
     inline void startNewRound() noexcept {
-        rounds.emplace_back(data.numberOfStops() + 1);
+        if (numberOfRounds == rounds.size()) rounds.emplace_back(data.numberOfStops() + 1);
+        numberOfRounds++;
+        numberOfUsedRounds = std::max(numberOfUsedRounds, numberOfRounds);
     }
 
+    template<bool PROFILE>
     inline bool arrivalByRoute(const StopId stop, const int time) noexcept {
         AssertMsg(data.isStop(stop), "Stop " << stop << " is out of range!");
         if (earliestArrival[targetStop].getArrivalTimeByRoute() <= time) return false;
         if (earliestArrival[stop].getArrivalTimeByRoute() <= time) return false;
+        if constexpr (PROFILE) {
+            if (currentRound()[targetStop].arrivalTime <= time) return false;
+            if (currentRound()[stop].arrivalTime <= time) return false;
+        }
         profiler.countMetric(METRIC_STOPS_BY_TRIP);
         currentRound()[stop].arrivalTime = time;
         earliestArrival[stop].setArrivalTimeByRoute(time);
@@ -423,10 +589,15 @@ private:
         return true;
     }
 
+    template<bool PROFILE>
     inline bool arrivalByTransfer(const StopId stop, const int time) noexcept {
         AssertMsg(data.isStop(stop) || stop == targetStop, "Stop " << stop << " is out of range!");
         if (earliestArrival[targetStop].getArrivalTimeByTransfer() <= time) return false;
         if (earliestArrival[stop].getArrivalTimeByTransfer() <= time) return false;
+        if constexpr (PROFILE) {
+            if (currentRound()[targetStop].arrivalTime <= time) return false;
+            if (currentRound()[stop].arrivalTime <= time) return false;
+        }
         profiler.countMetric(METRIC_STOPS_BY_TRANSFER);
         currentRound()[stop].arrivalTime = time;
         earliestArrival[stop].setArrivalTimeByTransfer(time);
@@ -436,7 +607,7 @@ private:
 
     inline void getJourney(std::vector<Journey>& journeys, size_t round, StopId stop) const noexcept {
         if constexpr (SeparateRouteAndTransferEntries) {
-            if ((round + 1 < rounds.size()) && (rounds[round + 1][stop].arrivalTime < rounds[round][stop].arrivalTime)) round++;
+            if ((round + 1 < numberOfRounds) && (rounds[round + 1][stop].arrivalTime < rounds[round][stop].arrivalTime)) round++;
         }
         if (rounds[round][stop].arrivalTime >= (journeys.empty() ? never : journeys.back().back().arrivalTime)) return;
         Journey journey;
@@ -457,7 +628,7 @@ private:
 
     inline void getArrival(std::vector<ArrivalLabel>& labels, size_t round, const StopId stop) const noexcept {
         if constexpr (SeparateRouteAndTransferEntries) {
-            if ((round + 1 < rounds.size()) && (rounds[round + 1][stop].arrivalTime < rounds[round][stop].arrivalTime)) round++;
+            if ((round + 1 < numberOfRounds) && (rounds[round + 1][stop].arrivalTime < rounds[round][stop].arrivalTime)) round++;
         }
         if (rounds[round][stop].arrivalTime >= (labels.empty() ? never : labels.back().arrivalTime)) return;
         labels.emplace_back(rounds[round][stop].arrivalTime, round / RoundFactor);
@@ -465,7 +636,7 @@ private:
 
     inline void getArrivalTime(std::vector<int>& labels, size_t round, const StopId stop) const noexcept {
         if constexpr (SeparateRouteAndTransferEntries) {
-            if ((round + 1 < rounds.size()) && (rounds[round + 1][stop].arrivalTime < rounds[round][stop].arrivalTime)) round++;
+            if ((round + 1 < numberOfRounds) && (rounds[round + 1][stop].arrivalTime < rounds[round][stop].arrivalTime)) round++;
         }
         labels.emplace_back(std::min(rounds[round][stop].arrivalTime, (labels.empty()) ? (never) : (labels.back())));
     }
@@ -475,7 +646,11 @@ private:
 
     InitialTransferType initialTransfers;
 
+    // The rounds are kept between queries. Only the first numberOfUsedRounds of them contain labels of the current
+    // query (including all departure times of a profile query), so clear() resets only these.
     std::vector<Round> rounds;
+    size_t numberOfRounds;
+    size_t numberOfUsedRounds;
 
     std::vector<ArrivalTime> earliestArrival;
 
@@ -488,6 +663,9 @@ private:
     StopId targetStop;
     int sourceDepartureTime;
 
+    std::vector<ProfileLabel> profile;
+    std::vector<int> profileArrivalTimes;
+
     Profiler profiler;
 
 };
@@ -6,6 +6,7 @@
 #include "../../../DataStructures/RAPTOR/Entities/Bags.h"
 #include "../../../DataStructures/TripBased/Data.h"
 
+#include "../Query/ReachedIndex.h"
 #include "../Query/Profiler.h"
 #include "ForwardPruningQuery.h"
 #include "BackwardPruningQuery.h"
@@ -237,7 +238,7 @@ private:
                     const int walkingDistance = walkingDistanceData(j);
                     if (walkingDistance < label.walkingDistance) label.end = j;
                     else if (walkingDistance == label.walkingDistance && offsets[j] != 0) {
-                        const u_int8_t offset = offsets[j];
+                        const ReachedIndex::IndexType offset = offsets[j];
                         for (; j < label.end; j++) {
                             if (walkingDistanceData(StopEventId(j - offset)) == label.walkingDistance) label.end = j;
                         }
@@ -388,7 +389,7 @@ private:
 
     std::vector<TripInfo> tripInfo;
     std::vector<EdgeLabel> edgeLabels;
-    std::vector<u_int8_t> offsets;
+    std::vector<ReachedIndex::IndexType> offsets;
 
     Vertex sourceVertex;
     Vertex targetVertex;
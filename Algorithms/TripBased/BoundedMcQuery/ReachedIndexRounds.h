@@ -1,37 +1,59 @@
 #pragma once
 
+#include <algorithm>
+#include <limits>
+
 #include "../../../DataStructures/TripBased/Data.h"
 
 namespace TripBased {
 
-class ReachedIndexRounds {
+// Reached index with one set of labels per round. The label vectors of all rounds are kept between queries. Outside of
+// the routes touched since the last clear(), every round holds the default labels, so clearing and starting a new
+// round only copy the touched routes.
+template<typename INDEX_TYPE>
+class ReachedIndexRoundsImplementation {
+
+public:
+    using IndexType = INDEX_TYPE;
+    using Type = ReachedIndexRoundsImplementation<IndexType>;
 
 public:
-    ReachedIndexRounds(const Data& data) :
+    ReachedIndexRoundsImplementation(const Data& data) :
         data(data),
         defaultLabels(data.numberOfTrips(), -1),
-        currentRound(0) {
+        numberOfRounds(1),
+        currentRound(0),
+        routeTouched(data.numberOfRoutes(), false) {
         for (const TripId trip : data.trips()) {
-            if (data.numberOfStopsInTrip(trip) > 255) warning("Trip ", trip, " has ", data.numberOfStopsInTrip(trip), " stops!");
+            if (data.numberOfStopsInTrip(trip) > std::numeric_limits<IndexType>::max()) warning("Trip ", trip, " has ", data.numberOfStopsInTrip(trip), " stops!");
             defaultLabels[trip] = data.numberOfStopsInTrip(trip);
         }
+        labels.emplace_back(defaultLabels);
     }
 
 public:
     inline void clear() noexcept {
-        labels.resize(1);
-        labels[0] = defaultLabels;
+        for (const RouteId route : touchedRoutes) {
+            const TripId start = data.firstTripOfRoute[route];
+            const TripId end = data.firstTripOfRoute[route + 1];
+            for (size_t round = 0; round < numberOfRounds; round++) {
+                std::copy_n(defaultLabels.begin() + start, end - start, labels[round].begin() + start);
+            }
+            routeTouched[route] = false;
+        }
+        touchedRoutes.clear();
+        numberOfRounds = 1;
         currentRound = 0;
     }
 
     inline void startNewRound() noexcept {
-        currentRound = labels.size();
-        labels.emplace_back(labels.back());
+        currentRound = numberOfRounds;
+        addRound();
     }
 
     inline void startNewRound(const size_t round) noexcept {
-        while (round >= labels.size()) {
-            labels.emplace_back(labels.back());
+        while (round >= numberOfRounds) {
+            addRound();
         }
         currentRound = round;
     }
@@ -42,18 +64,20 @@ public:
     }
 
     inline StopIndex operator()(const TripId trip, const size_t round) const noexcept {
-        const size_t trueRound = std::min(round, labels.size() - 1);
+        const size_t trueRound = std::min(round, numberOfRounds - 1);
         AssertMsg(trip < labels[trueRound].size(), "Trip " << trip << " is out of bounds!");
         return StopIndex(labels[trueRound][trip]);
     }
 
-    inline bool alreadyReached(const TripId trip, const u_int8_t index) const noexcept {
+    inline bool alreadyReached(const TripId trip, const IndexType index) const noexcept {
         return labels[currentRound][trip] <= index;
     }
 
     inline void update(const TripId trip, const StopIndex index) noexcept {
         AssertMsg(trip < labels[currentRound].size(), "Trip " << trip << " is out of bounds!");
-        const TripId routeEnd = data.firstTripOfRoute[data.routeOfTrip[trip] + 1];
+        const RouteId route = data.routeOfTrip[trip];
+        touch(route);
+        const TripId routeEnd = data.firstTripOfRoute[route + 1];
         for (TripId i = trip; i < routeEnd; i++) {
             if (labels[currentRound][i] <= index) break;
             labels[currentRound][i] = index;
@@ -62,26 +86,60 @@ public:
 
     inline void updateCopyForward(const TripId trip, const StopIndex index) noexcept {
         AssertMsg(trip < labels[currentRound].size(), "Trip " << trip << " is out of bounds!");
-        const TripId routeEnd = data.firstTripOfRoute[data.routeOfTrip[trip] + 1];
+        const RouteId route = data.routeOfTrip[trip];
+        touch(route);
+        const TripId routeEnd = data.firstTripOfRoute[route + 1];
         for (TripId i = trip; i < routeEnd; i++) {
             if (labels[currentRound][i] <= index) break;
             labels[currentRound][i] = index;
-            for (size_t round = currentRound + 1; round < labels.size(); round++) {
+            for (size_t round = currentRound + 1; round < numberOfRounds; round++) {
                 if (labels[round][i] <= index) break;
                 labels[round][i] = index;
             }
         }
     }
 
+private:
+    // Appends a copy of the last round, which only differs from the default labels in the touched routes.
+    inline void addRound() noexcept {
+        if (numberOfRounds == labels.size()) {
+            labels.emplace_back(defaultLabels);
+        }
+        const std::vector<IndexType>& previousLabels = labels[numberOfRounds - 1];
+        std::vector<IndexType>& newLabels = labels[numberOfRounds];
+        for (const RouteId route : touchedRoutes) {
+            const TripId start = data.firstTripOfRoute[route];
+            const TripId end = data.firstTripOfRoute[route + 1];
+            std::copy_n(previousLabels.begin() + start, end - start, newLabels.begin() + start);
+        }
+        numberOfRounds++;
+    }
+
+    inline void touch(const RouteId route) noexcept {
+        if (routeTouched[route]) return;
+        routeTouched[route] = true;
+        touchedRoutes.emplace_back(route);
+    }
+
 private:
     const Data& data;
 
-    std::vector<std::vector<u_int8_t>> labels;
+    std::vector<std::vector<IndexType>> labels;
 
-    std::vector<u_int8_t> defaultLabels;
+    std::vector<IndexType> defaultLabels;
 
+    size_t numberOfRounds;
     size_t currentRound;
 
+    std::vector<bool> routeTouched;
+    std::vector<RouteId> touchedRoutes;
+
 };
 
+#ifdef TB_WIDE_REACHED_INDEX
+using ReachedIndexRounds = ReachedIndexRoundsImplementation<u_int16_t>;
+#else
+using ReachedIndexRounds = ReachedIndexRoundsImplementation<u_int8_t>;
+#endif
+
 }
@@ -19,6 +19,8 @@
 #include "../../../DataStructures/TripBased/Shortcut.h"
 #include "../../../DataStructures/TripBased/ShortcutCollection.h"
 
+#include "../../RAPTOR/ULTRA/Station.h"
+
 namespace TripBased {
 
 template<bool DEBUG = false>
@@ -63,17 +65,7 @@ public:
         }
     };
 
-    struct Station {
-        Station() : representative(noStop) {}
-        StopId representative;
-        std::vector<StopId> stops;
-        inline void add(const StopId stop) noexcept {
-            if (representative > stop) {
-                representative = stop;
-            }
-            stops.emplace_back(stop);
-        }
-    };
+    using Station = RAPTOR::ULTRA::Station;
 
     struct CandidateOriginLabel {
         CandidateOriginLabel(const int arrivalTime, const StopEventId stopEvent) :
@@ -152,10 +144,10 @@ public:
     };
 
 public:
-    DelayShortcutSearch(const Data& tripData, const int arrivalDelayBuffer, const int departureDelayBuffer, ShortcutCollection& shortcuts) :
+    DelayShortcutSearch(const Data& tripData, const std::vector<Station>& stationOfStop, const int arrivalDelayBuffer, const int departureDelayBuffer, ShortcutCollection& shortcuts) :
         tripData(tripData),
         data(tripData.raptorData),
-        stationOfStop(data.numberOfStops()),
+        stationOfStop(stationOfStop),
         sourceStation(),
         sourceDepartureTime(0),
         witnessReachedIndex1(ReachedIndex(tripData)),
@@ -185,15 +177,6 @@ public:
         departureDelayBuffer(departureDelayBuffer),
         shortcuts(shortcuts) {
         AssertMsg(data.hasImplicitBufferTimes(), "Shortcut search requires implicit departure buffer times!");
-        Dijkstra<TransferGraph, false> dijkstra(data.transferGraph);
-        for (const StopId stop : data.stops()) {
-            dijkstra.run(stop, noVertex, [&](const Vertex u) {
-                if (!data.isStop(u)) return;
-                stationOfStop[stop].add(StopId(u));
-            }, NoOperation, [&](const Vertex, const Edge edge) {
-                return data.transferGraph.get(TravelTime, edge) > 0;
-            });
-        }
     }
 
     inline void run(const StopId source, const int minTime, const int maxTime) noexcept {
@@ -1013,7 +996,7 @@ private:
 private:
     const Data& tripData;
     const RAPTOR::Data& data;
-    std::vector<Station> stationOfStop;
+    const std::vector<Station>& stationOfStop;
 
     Station sourceStation;
     int sourceDepartureTime;
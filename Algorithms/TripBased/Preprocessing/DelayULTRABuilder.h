@@ -30,6 +30,7 @@ public:
     void computeShortcuts(const ThreadPinning& threadPinning, const int arrivalDelayBuffer, const int departureDelayBuffer, const size_t memoryLimit = 2048, const int minDepartureTime = -never, const int maxDepartureTime = never, const bool verbose = true) noexcept {
         if (verbose) std::cout << "Computing shortcuts with " << threadPinning.numberOfThreads << " threads." << std::endl;
 
+        const std::vector<RAPTOR::ULTRA::Station> stationOfStop = RAPTOR::ULTRA::computeStationOfStop(data.raptorData, threadPinning);
         Progress progress(data.numberOfStops(), verbose);
         omp_set_num_threads(threadPinning.numberOfThreads);
         std::vector<ShortcutCollection> threadShortcuts(threadPinning.numberOfThreads, ShortcutCollection(data.numberOfStopEvents()));
@@ -38,7 +39,7 @@ public:
             threadPinning.pinThread();
             const size_t threadNum = omp_get_thread_num();
 
-            DelayShortcutSearch<Debug> shortcutSearch(data, arrivalDelayBuffer, departureDelayBuffer, threadShortcuts[threadNum]);
+            DelayShortcutSearch<Debug> shortcutSearch(data, stationOfStop, arrivalDelayBuffer, departureDelayBuffer, threadShortcuts[threadNum]);
 
             #pragma omp for schedule(dynamic)
             for (size_t i = 0; i < data.numberOfStops(); i++) {
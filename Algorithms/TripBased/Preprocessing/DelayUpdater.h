@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <future>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -10,6 +12,7 @@
 #include "../../../DataStructures/TripBased/Delay.h"
 #include "../../../DataStructures/TripBased/DelayData.h"
 #include "../../../DataStructures/TripBased/DelayInfo.h"
+#include "../../../DataStructures/TripBased/DelayQueryDataVersions.h"
 #include "../../../DataStructures/TripBased/DelayUpdateData.h"
 
 #include "../../../Helpers/IO/File.h"
@@ -25,60 +28,9 @@
 
 namespace TripBased {
 
-template<bool SET_EDGE_DEFAULTS, typename GRAPH>
-inline void mergeShortcuts(GRAPH& graph, const std::vector<ShortcutInfo>& newShortcuts) noexcept {
-    GRAPH temp;
-    temp.reserve(graph.numVertices(), graph.numEdges() + newShortcuts.size());
-    size_t j(0);
-    for (const Vertex from : graph.vertices()) {
-        temp.addVertex();
-        Edge i = graph.beginEdgeFrom(from);
-        while (i < graph.endEdgeFrom(from) && j < newShortcuts.size() && newShortcuts[j].from == from) {
-            const Vertex iTo = graph.get(ToVertex, i);
-            const Vertex jTo = newShortcuts[j].to;
-            if (iTo == jTo) {
-                if constexpr (SET_EDGE_DEFAULTS) {
-                    const Edge edge = temp.addEdge(from, iTo, graph.edgeRecord(i));
-                    temp.set(MinOriginDelay, edge, 0);
-                    temp.set(MaxOriginDelay, edge, INFTY);
-                    i++;
-                    j++;
-                } else {
-                    Ensure(false, "Replacement search added a duplicate shortcut!");
-                }
-            } else if (iTo < jTo) {
-                temp.addEdge(from, iTo, graph.edgeRecord(i));
-                i++;
-            } else {
-                const Edge edge = temp.addEdge(from, jTo).set(TravelTime, newShortcuts[j].travelTime);
-                if constexpr (SET_EDGE_DEFAULTS) {
-                    temp.set(MinOriginDelay, edge, 0);
-                    temp.set(MaxOriginDelay, edge, INFTY);
-                } else {
-                    suppressUnusedParameterWarning(edge);
-                }
-                j++;
-            }
-        }
-        for (; i < graph.endEdgeFrom(from); i++) {
-            temp.addEdge(from, graph.get(ToVertex, i), graph.edgeRecord(i));
-        }
-        for (; j < newShortcuts.size() && newShortcuts[j].from == from; j++) {
-            const Edge edge = temp.addEdge(from, newShortcuts[j].to).set(TravelTime, newShortcuts[j].travelTime);
-            if constexpr (SET_EDGE_DEFAULTS) {
-                temp.set(MinOriginDelay, edge, 0);
-                temp.set(MaxOriginDelay, edge, INFTY);
-            } else {
-                suppressUnusedParameterWarning(edge);
-            }
-        }
-    }
-    Graph::move(std::move(temp), graph);
-}
-
 inline void mergeShortcutsIntoDelayData(DelayData& delayData, std::vector<ShortcutInfo>& newShortcuts) noexcept {
-    std::sort(newShortcuts.begin(), newShortcuts.end());
-    mergeShortcuts<true>(delayData.stopEventGraph, newShortcuts);
+    delayData.addReplacementShortcuts(newShortcuts);
+    delayData.mergeReplacementShortcuts();
 }
 
 struct UpdateLogEntry {
@@ -178,11 +130,16 @@ private:
     };
 
 public:
-    DelayUpdaterWithReplacement(DelayData& delayData, const RAPTOR::BucketCHInitialTransfers& initialTransfers, const ThreadPinning& threadPinning, const int targetSlack) :
+    DelayUpdaterWithReplacement(DelayData& delayData, const RAPTOR::BucketCHInitialTransfers& initialTransfers, const ThreadPinning& threadPinning, const int targetSlack, const size_t mergeThreshold = 1000) :
         delayData(delayData),
         delayUpdateData(delayData.createUpdateData(initialTransfers)),
         delayInfo(delayData),
-        builder(delayUpdateData, threadPinning, targetSlack) {
+        builder(delayUpdateData, threadPinning, targetSlack),
+        mergeThreshold(mergeThreshold) {
+    }
+
+    ~DelayUpdaterWithReplacement() {
+        finishShortcutMerge();
     }
 
     inline void preRunUpdate(const std::vector<DelayUpdate>& updates, const bool allowDepartureDelays, const bool replaceDelayedTargets) noexcept {
@@ -193,13 +150,7 @@ public:
 
         builder.run(delayInfo, replaceDelayedTargets);
         std::vector<ShortcutInfo> replacementShortcuts = builder.getShortcuts();
-        if (!replacementShortcuts.empty()) {
-            mergeShortcuts<false>(delayUpdateData.tripData.stopEventGraph, replacementShortcuts);
-            for (ShortcutInfo& shortcut : replacementShortcuts) {
-                shortcut.applyVertexPermutation(delayUpdateData.internalToOriginal);
-            }
-            mergeShortcutsIntoDelayData(delayData, replacementShortcuts);
-        }
+        addReplacementShortcuts(replacementShortcuts);
         updateLog.emplace_back(-INFTY, updates, replacementShortcuts);
     }
 
@@ -221,6 +172,8 @@ public:
             }
             runUpdate(currentUpdates, allowDepartureDelays, replaceDelayedTargets, startTime);
         }
+        finishShortcutMerge();
+        delayData.mergeReplacementShortcuts();
     }
 
     inline void runUpdate(const std::vector<DelayUpdate>& updates, const bool allowDepartureDelays, const bool replaceDelayedTargets, const int startTime) noexcept {
@@ -245,15 +198,9 @@ public:
         statistics.targetSearchTime.emplace_back(builder.getTargetSearchTime());
         phaseTimer.restart();
         std::vector<ShortcutInfo> replacementShortcuts = builder.getShortcuts();
-        if (!replacementShortcuts.empty()) {
-            mergeShortcuts<false>(delayUpdateData.tripData.stopEventGraph, replacementShortcuts);
-            for (ShortcutInfo& shortcut : replacementShortcuts) {
-                shortcut.applyVertexPermutation(delayUpdateData.internalToOriginal);
-            }
-            mergeShortcutsIntoDelayData(delayData, replacementShortcuts);
-        }
+        addReplacementShortcuts(replacementShortcuts);
         statistics.mergeTime.emplace_back(phaseTimer.elapsedMicroseconds());
-        statistics.numQueryShortcuts.emplace_back(delayUpdateData.tripData.stopEventGraph.numEdges());
+        statistics.numQueryShortcuts.emplace_back(delayUpdateData.tripData.stopEventGraph.numEdges() + replacementShortcuts.size());
         statistics.finishTimes.emplace_back(getLogTime());
         statistics.finalize();
         updateLog.emplace_back(statistics.finishTimes.back(), updates, replacementShortcuts);
@@ -277,11 +224,36 @@ private:
         logTimer.advance(static_cast<double>(targetTime) * 1000000);
     }
 
+    // The replacement shortcuts are only added to the side buffer of the DelayData, which is included when the next
+    // update filters the shortcuts. Once the buffer exceeds the merge threshold, it is merged into the shortcut graph
+    // in the background, and the merged graph is installed by the first update after the merge has finished.
+    inline void addReplacementShortcuts(std::vector<ShortcutInfo>& replacementShortcuts) noexcept {
+        for (ShortcutInfo& shortcut : replacementShortcuts) {
+            shortcut.applyVertexPermutation(delayUpdateData.internalToOriginal);
+        }
+        delayData.addReplacementShortcuts(replacementShortcuts);
+        if (shortcutMerge.valid()) {
+            if (shortcutMerge.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+            delayData.applyShortcutGraphMerge(shortcutMerge.get());
+        }
+        if (delayData.numberOfReplacementShortcuts() < mergeThreshold) return;
+        shortcutMerge = std::async(std::launch::async, [this, shortcuts = delayData.getReplacementShortcuts()]() mutable {
+            return delayData.mergeShortcutGraph(std::move(shortcuts));
+        });
+    }
+
+    inline void finishShortcutMerge() noexcept {
+        if (!shortcutMerge.valid()) return;
+        delayData.applyShortcutGraphMerge(shortcutMerge.get());
+    }
+
 private:
     DelayData& delayData;
     DelayUpdateData delayUpdateData;
     DelayInfo delayInfo;
     ReplacementSearchBuilder builder;
+    size_t mergeThreshold;
+    std::future<ShortcutGraphMerge> shortcutMerge;
     UpdateStatistics statistics;
     std::vector<UpdateLogEntry> updateLog;
     Timer logTimer;
@@ -387,10 +359,11 @@ private:
 
 class DelayUpdateSimulator {
 public:
-    DelayUpdateSimulator(DelayData& delayData, const std::string& updateLogFile) :
+    DelayUpdateSimulator(DelayData& delayData, const std::string& updateLogFile, const size_t mergeThreshold = 1000) :
         delayData(delayData),
-        queryData(delayData.createQueryData()),
-        nextLogEntry(0) {
+        nextLogEntry(0),
+        mergeThreshold(mergeThreshold) {
+        queryDataVersions.publish(delayData.createQueryData());
         readLog(updateLogFile);
     }
 
@@ -411,6 +384,10 @@ public:
         }
     }
 
+    inline bool hasNextUpdate() const noexcept {
+        return nextLogEntry < updateLog.size();
+    }
+
     inline int nextUpdateFinishTime() const noexcept {
         AssertMsg(nextLogEntry < updateLog.size(), "No update log entries left!");
         return updateLog[nextLogEntry].finishTime;
@@ -424,8 +401,15 @@ public:
         return delayData;
     }
 
+    // The returned query data remains valid until the next update is applied.
     inline const DelayQueryData& getQueryData() const noexcept {
-        return queryData;
+        return *queryDataVersions.acquire();
+    }
+
+    // Every update publishes a new version of the query data, so readers on other threads can keep querying the
+    // version they have acquired while the next update is being applied.
+    inline const DelayQueryDataVersions& getQueryDataVersions() const noexcept {
+        return queryDataVersions;
     }
 
 private:
@@ -435,16 +419,16 @@ private:
 
     inline void applyUpdate(UpdateLogEntry& logEntry, const bool allowDepartureDelays) noexcept {
         delayData.applyDelayUpdates(logEntry.updates, allowDepartureDelays);
-        if (!logEntry.replacementShortcuts.empty()) {
-            mergeShortcutsIntoDelayData(delayData, logEntry.replacementShortcuts);
-        }
-        delayData.refreshQueryData(queryData);
+        delayData.addReplacementShortcuts(logEntry.replacementShortcuts);
+        if (delayData.numberOfReplacementShortcuts() >= mergeThreshold) delayData.mergeReplacementShortcuts();
+        queryDataVersions.publish(delayData.createQueryData());
     }
 
     DelayData& delayData;
-    DelayQueryData queryData;
+    DelayQueryDataVersions queryDataVersions;
     std::vector<UpdateLogEntry> updateLog;
     size_t nextLogEntry;
+    size_t mergeThreshold;
 };
 
 }
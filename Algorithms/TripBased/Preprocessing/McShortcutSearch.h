@@ -17,6 +17,8 @@
 #include "../../../DataStructures/TripBased/Data.h"
 #include "../../../DataStructures/TripBased/Shortcut.h"
 
+#include "../../RAPTOR/ULTRA/Station.h"
+
 namespace TripBased {
 
 template<bool DEBUG = false, bool USE_ARRIVAL_KEY = true, bool FULL_ROUTE_SCANS = false>
@@ -444,23 +446,13 @@ public:
         }
     };
 
-    struct Station {
-        Station() : representative(noStop) {}
-        StopId representative;
-        std::vector<StopId> stops;
-        inline void add(const StopId stop) noexcept {
-            if (representative > stop) {
-                representative = stop;
-            }
-            stops.emplace_back(stop);
-        }
-    };
+    using Station = RAPTOR::ULTRA::Station;
 
 public:
-    McShortcutSearch(const Data& tripData, const int intermediateWitnessTransferLimit, const int finalWitnessTransferLimit) :
+    McShortcutSearch(const Data& tripData, const std::vector<Station>& stationOfStop, const int intermediateWitnessTransferLimit, const int finalWitnessTransferLimit) :
         tripData(tripData),
         data(tripData.raptorData),
-        stationOfStop(data.numberOfStops()),
+        stationOfStop(stationOfStop),
         sourceStation(),
         sourceDepartureTime(0),
         shortcutCandidatesInQueue(0),
@@ -474,15 +466,6 @@ public:
         earliestDepartureTime(data.getMinDepartureTime()),
         timestamp(0) {
         AssertMsg(data.hasImplicitBufferTimes(), "Shortcut search requires implicit departure buffer times!");
-        Dijkstra<TransferGraph, false> dijkstra(data.transferGraph);
-        for (const StopId stop : data.stops()) {
-            dijkstra.run(stop, noVertex, [&](const Vertex u) {
-                if (!data.isStop(u)) return;
-                stationOfStop[stop].add(StopId(u));
-            }, NoOperation, [&](const Vertex, const Edge edge) {
-                return data.transferGraph.get(TravelTime, edge) > 0;
-            });
-        }
     }
 
     inline void run(const StopId source, const int minTime, const int maxTime) noexcept {
@@ -995,7 +978,7 @@ private:
 private:
     const Data& tripData;
     const RAPTOR::Data& data;
-    std::vector<Station> stationOfStop;
+    const std::vector<Station>& stationOfStop;
 
     Station sourceStation;
     int sourceDepartureTime;
@@ -32,13 +32,14 @@ public:
 
         std::vector<Shortcut> shortcuts;
 
+        const std::vector<RAPTOR::ULTRA::Station> stationOfStop = RAPTOR::ULTRA::computeStationOfStop(data.raptorData, threadPinning);
         Progress progress(data.numberOfStops(), verbose);
         omp_set_num_threads(threadPinning.numberOfThreads);
         #pragma omp parallel
         {
             threadPinning.pinThread();
 
-            MultimodalMcShortcutSearch<Debug, TimeFactor> shortcutSearch(data, transitiveTransferGraph, intermediateWitnessTransferLimit, finalWitnessTransferLimit);
+            MultimodalMcShortcutSearch<Debug, TimeFactor> shortcutSearch(data, stationOfStop, transitiveTransferGraph, intermediateWitnessTransferLimit, finalWitnessTransferLimit);
 
             #pragma omp for schedule(dynamic)
             for (size_t i = 0; i < data.numberOfStops(); i++) {
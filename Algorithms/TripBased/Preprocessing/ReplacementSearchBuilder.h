@@ -8,35 +8,6 @@
 
 namespace TripBased {
 
-struct ShortcutInfo {
-    ShortcutInfo(const Vertex from = noVertex, const Vertex to = noVertex, const int travelTime = INFTY) :
-        from(from),
-        to(to),
-        travelTime(travelTime) {
-    }
-
-    inline void applyVertexPermutation(const Permutation& permutation) noexcept {
-        from = permutation.permutate(from);
-        to = permutation.permutate(to);
-    }
-
-    inline bool operator<(const ShortcutInfo& other) noexcept {
-        return std::tie(from, to) < std::tie(other.from, other.to);
-    }
-
-    inline void serialize(IO::Serialization& serialize) const noexcept {
-        serialize(from, to, travelTime);
-    }
-
-    inline void deserialize(IO::Deserialization& deserialize) noexcept {
-        deserialize(from, to, travelTime);
-    }
-
-    Vertex from;
-    Vertex to;
-    int travelTime;
-};
-
 class ReplacementSearchBuilder {
 public:
     ReplacementSearchBuilder(const DelayUpdateData& data, const ThreadPinning& threadPinning, const int targetSlack) :
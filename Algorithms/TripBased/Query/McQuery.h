@@ -1,6 +1,7 @@
 #pragma once
 
 #include "WalkingDistanceData.h"
+#include "ReachedIndex.h"
 
 #include "../../CH/Query/BucketQuery.h"
 
@@ -208,7 +209,7 @@ private:
                     const int walkingDistance = walkingDistanceData(j);
                     if (walkingDistance < label.walkingDistance) label.end = j;
                     else if (walkingDistance == label.walkingDistance && offsets[j] != 0) {
-                        const u_int8_t offset = offsets[j];
+                        const ReachedIndex::IndexType offset = offsets[j];
                         for (; j < label.end; j++) {
                             if (walkingDistanceData(StopEventId(j - offset)) == label.walkingDistance) label.end = j;
                         }
@@ -339,12 +340,12 @@ private:
     WalkingDistanceData walkingDistanceData;
 
     std::vector<TargetBag> targetBags;
-    TargetBag bestTargetBag;
+    RAPTOR::ParetoBag bestTargetBag;
 
     std::vector<TripInfo> tripInfo;
     std::vector<EdgeLabel> edgeLabels;
     std::vector<RouteLabel> routeLabels;
-    std::vector<u_int8_t> offsets;
+    std::vector<ReachedIndex::IndexType> offsets;
 
     Vertex sourceVertex;
     Vertex targetVertex;
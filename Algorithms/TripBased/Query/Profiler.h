@@ -4,6 +4,7 @@
 
 #include "../../../Helpers/String/String.h"
 #include "../../../Helpers/Timer.h"
+#include "../../../Helpers/Histogram.h"
 
 namespace TripBased {
 
@@ -69,7 +70,12 @@ public:
         totalTime(0.0),
         phaseTime(NUM_PHASES, 0.0),
         metricValue(NUM_METRICS, 0),
-        numQueries(0) {
+        numQueries(0),
+        queryPhaseTime(NUM_PHASES, 0.0),
+        queryMetricValue(NUM_METRICS, 0),
+        totalTimeHistogram(Histogram::TimeResolution),
+        phaseHistograms(NUM_PHASES, Histogram(Histogram::TimeResolution)),
+        metricHistograms(NUM_METRICS) {
     }
 
     inline void registerPhases(const std::initializer_list<Phase>& phaseList) noexcept {
@@ -85,11 +91,23 @@ public:
     }
 
     inline void start() noexcept {
+        std::fill(queryPhaseTime.begin(), queryPhaseTime.end(), 0.0);
+        std::fill(queryMetricValue.begin(), queryMetricValue.end(), 0);
         totalTimer.restart();
     }
 
     inline void done() noexcept {
-        totalTime += totalTimer.elapsedMicroseconds();
+        const double queryTime = totalTimer.elapsedMicroseconds();
+        totalTime += queryTime;
+        totalTimeHistogram.add(queryTime);
+        for (size_t i = 0; i < NUM_PHASES; i++) {
+            phaseTime[i] += queryPhaseTime[i];
+            phaseHistograms[i].add(queryPhaseTime[i]);
+        }
+        for (size_t i = 0; i < NUM_METRICS; i++) {
+            metricValue[i] += queryMetricValue[i];
+            metricHistograms[i].add(uint64_t(queryMetricValue[i]));
+        }
         numQueries++;
     }
 
@@ -98,11 +116,11 @@ public:
     }
 
     inline void donePhase(const Phase phase) noexcept {
-        phaseTime[phase] += phaseTimer.elapsedMicroseconds();
+        queryPhaseTime[phase] += phaseTimer.elapsedMicroseconds();
     }
 
     inline void countMetric(const Metric metric) noexcept {
-        metricValue[metric]++;
+        queryMetricValue[metric]++;
     }
 
     inline double getTotalTime() const noexcept {
@@ -125,6 +143,44 @@ public:
             std::cout << PhaseNames[phase] << ": " << String::musToString(phaseTime[phase] / static_cast<double>(numQueries)) << std::endl;
         }
         std::cout << "Total time: " << String::musToString(totalTime / numQueries) << std::endl;
+        printPercentiles();
+    }
+
+    inline void printPercentiles() const noexcept {
+        Histogram::printHeader("Per query");
+        forEachStatistic([&](const std::string& name, const bool isTime, const Histogram& histogram) {
+            histogram.print(name, isTime);
+        });
+    }
+
+    template<typename FUNCTION>
+    inline void forEachStatistic(const FUNCTION& function) const noexcept {
+        function("Total time", true, totalTimeHistogram);
+        for (const Phase phase : phases) {
+            function(PhaseNames[phase], true, phaseHistograms[phase]);
+        }
+        for (const Metric metric : metrics) {
+            function(MetricNames[metric], false, metricHistograms[metric]);
+        }
+    }
+
+    inline AggregateProfiler& operator+=(const AggregateProfiler& other) noexcept {
+        totalTime += other.totalTime;
+        for (size_t i = 0; i < NUM_PHASES; i++) {
+            phaseTime[i] += other.phaseTime[i];
+        }
+        for (size_t i = 0; i < NUM_METRICS; i++) {
+            metricValue[i] += other.metricValue[i];
+        }
+        numQueries += other.numQueries;
+        totalTimeHistogram += other.totalTimeHistogram;
+        for (size_t i = 0; i < NUM_PHASES; i++) {
+            phaseHistograms[i] += other.phaseHistograms[i];
+        }
+        for (size_t i = 0; i < NUM_METRICS; i++) {
+            metricHistograms[i] += other.metricHistograms[i];
+        }
+        return *this;
     }
 
 private:
@@ -136,6 +192,11 @@ private:
     std::vector<double> phaseTime;
     std::vector<long long> metricValue;
     size_t numQueries;
+    std::vector<double> queryPhaseTime;
+    std::vector<long long> queryMetricValue;
+    Histogram totalTimeHistogram;
+    std::vector<Histogram> phaseHistograms;
+    std::vector<Histogram> metricHistograms;
 };
 
 }
@@ -1,33 +1,46 @@
 #pragma once
 
 #include <algorithm>
+#include <limits>
 
 #include "../../../DataStructures/TripBased/Data.h"
 
 namespace TripBased {
 
-class ReachedIndex {
+// Stores for every trip the first stop index at which it has been reached. Since the updates are propagated to all
+// later trips of the same route, only the routes that have been touched since the last clear() need to be reset.
+// The stop indices are stored as INDEX_TYPE, which must be able to hold the number of stops of every trip.
+template<typename INDEX_TYPE>
+class ReachedIndexImplementation {
 
 public:
-    ReachedIndex(const Data& data) :
+    using IndexType = INDEX_TYPE;
+    using Type = ReachedIndexImplementation<IndexType>;
+
+public:
+    ReachedIndexImplementation(const Data& data) :
         data(data),
         labels(data.numberOfTrips(), -1),
-        defaultLabels(data.numberOfTrips(), -1) {
+        defaultLabels(data.numberOfTrips(), -1),
+        routeTouched(data.numberOfRoutes(), false) {
         for (const TripId trip : data.trips()) {
-            if (data.numberOfStopsInTrip(trip) > 255) warning("Trip ", trip, " has ", data.numberOfStopsInTrip(trip), " stops!");
+            if (data.numberOfStopsInTrip(trip) > std::numeric_limits<IndexType>::max()) warning("Trip ", trip, " has ", data.numberOfStopsInTrip(trip), " stops!");
             defaultLabels[trip] = data.numberOfStopsInTrip(trip);
         }
+        labels = defaultLabels;
     }
 
 public:
     inline void clear() noexcept {
-        labels = defaultLabels;
+        for (const RouteId route : touchedRoutes) {
+            resetRoute(route);
+            routeTouched[route] = false;
+        }
+        touchedRoutes.clear();
     }
 
     inline void clear(const RouteId route) noexcept {
-        const TripId start = data.firstTripOfRoute[route];
-        const TripId end = data.firstTripOfRoute[route + 1];
-        std::copy_n(defaultLabels.begin() + start, end - start, labels.begin() + start);
+        resetRoute(route);
     }
 
     inline StopIndex operator()(const TripId trip) const noexcept {
@@ -35,13 +48,15 @@ public:
         return StopIndex(labels[trip]);
     }
 
-    inline bool alreadyReached(const TripId trip, const u_int8_t index) const noexcept {
+    inline bool alreadyReached(const TripId trip, const IndexType index) const noexcept {
         return labels[trip] <= index;
     }
 
     inline void update(const TripId trip, const StopIndex index) noexcept {
         AssertMsg(trip < labels.size(), "Trip " << trip << " is out of bounds!");
-        const TripId routeEnd = data.firstTripOfRoute[data.routeOfTrip[trip] + 1];
+        const RouteId route = data.routeOfTrip[trip];
+        touch(route);
+        const TripId routeEnd = data.firstTripOfRoute[route + 1];
         for (TripId i = trip; i < routeEnd; i++) {
             if (labels[i] <= index) break;
             labels[i] = index;
@@ -51,16 +66,40 @@ public:
     inline void updateRaw(const TripId trip, const TripId tripEnd, const StopIndex index) noexcept {
         AssertMsg(trip < labels.size(), "Trip " << trip << " is out of bounds!");
         AssertMsg(tripEnd <= data.firstTripOfRoute[data.routeOfTrip[trip] + 1], "Trip end" << tripEnd << " is out of bounds!");
+        touch(data.routeOfTrip[trip]);
         std::fill(labels.begin() + trip, labels.begin() + tripEnd, index);
     }
 
+private:
+    inline void touch(const RouteId route) noexcept {
+        if (routeTouched[route]) return;
+        routeTouched[route] = true;
+        touchedRoutes.emplace_back(route);
+    }
+
+    inline void resetRoute(const RouteId route) noexcept {
+        const TripId start = data.firstTripOfRoute[route];
+        const TripId end = data.firstTripOfRoute[route + 1];
+        std::copy_n(defaultLabels.begin() + start, end - start, labels.begin() + start);
+    }
+
 private:
     const Data& data;
 
-    std::vector<u_int8_t> labels;
+    std::vector<IndexType> labels;
 
-    std::vector<u_int8_t> defaultLabels;
+    std::vector<IndexType> defaultLabels;
+
+    std::vector<bool> routeTouched;
+    std::vector<RouteId> touchedRoutes;
 
 };
 
+// Trips with more than 255 stops require the 16-bit variant, which is enabled by compiling with -DTB_WIDE_REACHED_INDEX.
+#ifdef TB_WIDE_REACHED_INDEX
+using ReachedIndex = ReachedIndexImplementation<u_int16_t>;
+#else
+using ReachedIndex = ReachedIndexImplementation<u_int8_t>;
+#endif
+
 }
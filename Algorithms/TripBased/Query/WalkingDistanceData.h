@@ -4,17 +4,26 @@
 
 namespace TripBased {
 
+// Stores for every stop event the minimal walking distance with which it has been reached. Updates are propagated to
+// all later trips of the same route, so only the routes that have been touched since the last clear() need to be reset.
 class WalkingDistanceData {
 
 public:
     WalkingDistanceData(const Data& data) :
         data(data),
-        labels(data.numberOfStopEvents(), INFTY) {
+        labels(data.numberOfStopEvents(), INFTY),
+        routeTouched(data.numberOfRoutes(), false) {
     }
 
 public:
     inline void clear() noexcept {
-        std::fill(labels.begin(), labels.end(), INFTY);
+        for (const RouteId route : touchedRoutes) {
+            const StopEventId start = data.firstStopEventOfTrip[data.firstTripOfRoute[route]];
+            const StopEventId end = data.firstStopEventOfTrip[data.firstTripOfRoute[route + 1]];
+            std::fill(labels.begin() + start, labels.begin() + end, INFTY);
+            routeTouched[route] = false;
+        }
+        touchedRoutes.clear();
     }
 
     inline int operator()(const StopEventId stopEvent) const noexcept {
@@ -30,6 +39,11 @@ public:
     }
 
     inline void update(const StopEventId stopEvent, const StopEventId tripEnd, const StopEventId routeEnd, const StopIndex tripLength, const int walkingDistance) noexcept {
+        const RouteId route = data.routeOfTrip[data.tripOfStopEvent[stopEvent]];
+        if (!routeTouched[route]) {
+            routeTouched[route] = true;
+            touchedRoutes.emplace_back(route);
+        }
         StopEventId currentStart = stopEvent;
         StopEventId currentEnd = tripEnd;
         for (; currentStart < routeEnd; currentStart += tripLength, currentEnd += tripLength) {
@@ -45,6 +59,9 @@ private:
 
     std::vector<int> labels;
 
+    std::vector<bool> routeTouched;
+    std::vector<RouteId> touchedRoutes;
+
 };
 
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 #include "../../Algorithms/CH/CH.h"
@@ -79,6 +80,7 @@ struct SweepGraph {
         for (const Edge edge : graph.edges()) {
             toVertex[edge] = internalToExternal(graph.get(ToVertex, edge));
         }
+        computeLevels();
     }
 
     inline Vertex externalToInternal(const Vertex vertex) const noexcept {
@@ -89,10 +91,43 @@ struct SweepGraph {
         return Vertex(order[vertex]);
     }
 
+    inline size_t numberOfLevels() const noexcept {
+        return levelBegin.size() - 1;
+    }
+
+    // The level of a vertex is the length of the longest edge path to it in sweep order. Vertices of the same level
+    // do not depend on each other, so a sweep can process each level in parallel.
+    inline void computeLevels() noexcept {
+        std::vector<size_t> levelOf(graph.numVertices(), 0);
+        size_t maxLevel = 0;
+        for (const Vertex vertex : graph.vertices()) {
+            for (const Edge edge : graph.edgesFrom(vertex)) {
+                const Vertex from = graph.get(ToVertex, edge);
+                AssertMsg(from < vertex, "Sweep graph edge from " << vertex << " to " << from << " is not in sweep order!");
+                levelOf[vertex] = std::max(levelOf[vertex], levelOf[from] + 1);
+            }
+            maxLevel = std::max(maxLevel, levelOf[vertex]);
+        }
+        levelBegin.assign(graph.numVertices() > 0 ? maxLevel + 2 : 1, 0);
+        for (const Vertex vertex : graph.vertices()) {
+            levelBegin[levelOf[vertex] + 1]++;
+        }
+        for (size_t level = 1; level < levelBegin.size(); level++) {
+            levelBegin[level] += levelBegin[level - 1];
+        }
+        std::vector<size_t> nextIndex(levelBegin.begin(), levelBegin.end() - 1);
+        verticesByLevel.resize(graph.numVertices());
+        for (const Vertex vertex : graph.vertices()) {
+            verticesByLevel[nextIndex[levelOf[vertex]]++] = vertex;
+        }
+    }
+
     CHGraph graph;
     Order order;
     Permutation permutation;
     std::vector<Vertex> toVertex;
+    std::vector<size_t> levelBegin;
+    std::vector<Vertex> verticesByLevel;
 };
 
 struct CompactSweepGraph {
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <iostream>
+
+#include "../../../Helpers/Types.h"
+
+namespace CSA {
+
+// Entry of a departure time profile: leaving at departureTime, the target can be reached at arrivalTime.
+class ProfileEntry {
+
+public:
+    ProfileEntry(const int departureTime = never, const int arrivalTime = never) :
+        departureTime(departureTime),
+        arrivalTime(arrivalTime) {
+    }
+
+    inline int travelTime() const noexcept {
+        return arrivalTime - departureTime;
+    }
+
+    inline bool operator==(const ProfileEntry& other) const noexcept {
+        return (departureTime == other.departureTime) && (arrivalTime == other.arrivalTime);
+    }
+
+    inline bool operator!=(const ProfileEntry& other) const noexcept {
+        return !(*this == other);
+    }
+
+    inline bool dominates(const ProfileEntry& other) const noexcept {
+        return departureTime >= other.departureTime && arrivalTime <= other.arrivalTime;
+    }
+
+    inline friend std::ostream& operator<<(std::ostream& out, const ProfileEntry& entry) noexcept {
+        return out << "departureTime: " << entry.departureTime << ", arrivalTime: " << entry.arrivalTime;
+    }
+
+public:
+    int departureTime;
+    int arrivalTime;
+
+};
+
+}
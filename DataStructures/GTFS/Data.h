@@ -6,6 +6,9 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <unordered_map>
+
+#include <omp.h>
 
 #include "Entities/Agency.h"
 #include "Entities/Calendar.h"
@@ -43,7 +46,8 @@ public:
         return data;
     }
 
-    inline static Data FromGTFS(const std::string& fileNameBase, const bool verbose = true) noexcept {
+    // Stops and trips are read before the stop times, whose trip and stop IDs are resolved to indices while parsing.
+    inline static Data FromGTFS(const std::string& fileNameBase, const bool verbose = true, const size_t numberOfThreads = 1) noexcept {
         Data data;
         data.readAgencies(fileNameBase + "agency.txt", verbose);
         data.readCalendars(fileNameBase + "calendar.txt", verbose);
@@ -51,9 +55,9 @@ public:
         data.readFrequencies(fileNameBase + "frequencies.txt", verbose);
         data.readRoutes(fileNameBase + "routes.txt", verbose);
         data.readStops(fileNameBase + "stops.txt", verbose);
-        data.readStopTimes(fileNameBase + "stop_times.txt", verbose);
-        data.readTransfers(fileNameBase + "transfers.txt", verbose);
         data.readTrips(fileNameBase + "trips.txt", verbose);
+        data.readStopTimes(fileNameBase + "stop_times.txt", numberOfThreads, verbose);
+        data.readTransfers(fileNameBase + "transfers.txt", verbose);
         return data;
     }
 
@@ -160,24 +164,73 @@ protected:
         }, verbose);
     }
 
-    inline void readStopTimes(const std::string& fileName, const bool verbose = true) {
+    // The file is split into chunks of lines, which are parsed in parallel. Stop times whose trip or stop is unknown
+    // are dropped. Afterwards, the stop times are grouped by trip and sorted by stop sequence.
+    inline void readStopTimes(const std::string& fileName, const size_t numberOfThreads = 1, const bool verbose = true) {
         IO::readFile(fileName, "Stop Times", [&](){
+            const std::unordered_map<std::string, int> tripIndices = tripIds();
+            const std::unordered_map<std::string, int> stopIndices = stopIds();
+            const std::vector<long> chunks = IO::splitIntoLineChunks(fileName, numberOfThreads * ChunksPerThread);
+            StopTimeReader header(fileName, 0, chunks[0]);
+            header.readHeader(ReadMode, "trip_id", "arrival_time", "departure_time", "stop_id", "stop_sequence");
+            std::vector<std::vector<StopTime>> stopTimesOfChunk(chunks.size() - 1);
             int count = 0;
-            IO::CSVReader<5, IO::TrimChars<>, IO::DoubleQuoteEscape<',','"'>> in(fileName);
-            in.readHeader(ReadMode, "trip_id", "arrival_time", "departure_time", "stop_id", "stop_sequence");
-            StopTime stopTime;
-            std::string arrivalTime;
-            std::string departureTime;
-            while (in.readRow(stopTime.tripId, arrivalTime, departureTime, stopTime.stopId, stopTime.stopSequence)) {
-                stopTime.arrivalTime = String::parseSeconds(arrivalTime);
-                stopTime.departureTime = String::parseSeconds(departureTime);
-                if (stopTime.validate()) stopTimes.push_back(stopTime);
-                count++;
+            omp_set_num_threads(numberOfThreads);
+            #pragma omp parallel for schedule(dynamic, 1) reduction(+ : count)
+            for (size_t i = 0; i < stopTimesOfChunk.size(); i++) {
+                StopTimeReader in(fileName, chunks[i], chunks[i + 1]);
+                in.useHeaderOf(header);
+                StopTime stopTime;
+                std::string tripId;
+                std::string previousTripId;
+                std::string arrivalTime;
+                std::string departureTime;
+                std::string stopId;
+                while (in.readRow(tripId, arrivalTime, departureTime, stopId, stopTime.stopSequence)) {
+                    // Stop times are usually listed trip by trip, so the trip rarely changes between rows.
+                    if (tripId != previousTripId) {
+                        const auto trip = tripIndices.find(tripId);
+                        stopTime.tripIndex = (trip == tripIndices.end()) ? -1 : trip->second;
+                        previousTripId = tripId;
+                    }
+                    const auto stop = stopIndices.find(stopId);
+                    stopTime.stopIndex = (stop == stopIndices.end()) ? -1 : stop->second;
+                    stopTime.arrivalTime = String::parseSeconds(arrivalTime);
+                    stopTime.departureTime = String::parseSeconds(departureTime);
+                    if (stopTime.validate()) stopTimesOfChunk[i].emplace_back(stopTime);
+                    count++;
+                }
             }
+            groupStopTimesByTrip(stopTimesOfChunk);
             return count;
         }, verbose);
     }
 
+    inline void groupStopTimesByTrip(std::vector<std::vector<StopTime>>& stopTimesOfChunk) noexcept {
+        std::vector<size_t> nextStopTimeOfTrip(trips.size() + 1, 0);
+        for (const std::vector<StopTime>& chunk : stopTimesOfChunk) {
+            for (const StopTime& stopTime : chunk) {
+                nextStopTimeOfTrip[stopTime.tripIndex + 1]++;
+            }
+        }
+        for (size_t i = 1; i < nextStopTimeOfTrip.size(); i++) {
+            nextStopTimeOfTrip[i] += nextStopTimeOfTrip[i - 1];
+        }
+        stopTimes.clear();
+        stopTimes.resize(nextStopTimeOfTrip.back());
+        for (std::vector<StopTime>& chunk : stopTimesOfChunk) {
+            for (const StopTime& stopTime : chunk) {
+                stopTimes[nextStopTimeOfTrip[stopTime.tripIndex]++] = stopTime;
+            }
+            std::vector<StopTime>().swap(chunk);
+        }
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (size_t i = 0; i < trips.size(); i++) {
+            const size_t begin = (i == 0) ? 0 : nextStopTimeOfTrip[i - 1];
+            std::sort(stopTimes.begin() + begin, stopTimes.begin() + nextStopTimeOfTrip[i]);
+        }
+    }
+
     inline void readTransfers(const std::string& fileName, const bool verbose = true) {
         IO::readFile(fileName, "Transfers", [&](){
             int count = 0;
@@ -269,26 +322,36 @@ public:
         return ids;
     }
 
-    inline Map<std::string, int> stopIds() const noexcept {
-        Map<std::string, int> ids;
+    inline std::unordered_map<std::string, int> stopIds() const noexcept {
+        std::unordered_map<std::string, int> ids;
+        ids.reserve(stops.size());
         for (size_t i = 0; i < stops.size(); i++) {
-            const Stop& stop = stops[i];
-            if (ids.contains(stop.stopId)) continue;
-            ids.insert(stop.stopId, i);
+            ids.emplace(stops[i].stopId, i);
         }
         return ids;
     }
 
-    inline Map<std::string, int> tripIds() const noexcept {
-        Map<std::string, int> ids;
+    inline std::unordered_map<std::string, int> tripIds() const noexcept {
+        std::unordered_map<std::string, int> ids;
+        ids.reserve(trips.size());
         for (size_t i = 0; i < trips.size(); i++) {
-            const Trip& trip = trips[i];
-            if (ids.contains(trip.tripId)) continue;
-            ids.insert(trip.tripId, i);
+            ids.emplace(trips[i].tripId, i);
         }
         return ids;
     }
 
+    // Stop times are grouped by trip, the stop times of trip i are [result[i], result[i + 1]).
+    inline std::vector<size_t> firstStopTimeOfTrip() const noexcept {
+        std::vector<size_t> result(trips.size() + 1, 0);
+        for (const StopTime& stopTime : stopTimes) {
+            result[stopTime.tripIndex + 1]++;
+        }
+        for (size_t i = 1; i < result.size(); i++) {
+            result[i] += result[i - 1];
+        }
+        return result;
+    }
+
     inline Map<std::string, std::vector<int>> frequencyIds() const noexcept {
         Map<std::string, std::vector<int>> ids;
         for (size_t i = 0; i < frequencies.size(); i++) {
@@ -352,6 +415,8 @@ public:
 
 protected:
     static constexpr IO::IgnoreColumn ReadMode = IO::IGNORE_EXTRA_COLUMN | IO::IGNORE_MISSING_COLUMN;
+    static constexpr size_t ChunksPerThread = 4;
+    using StopTimeReader = IO::CSVReader<5, IO::TrimChars<>, IO::DoubleQuoteEscape<',','"'>>;
 
 };
 
@@ -8,14 +8,16 @@
 
 namespace GTFS {
 
+// The trip and the stop are stored as indices into GTFS::Data::trips and GTFS::Data::stops, which are resolved
+// while parsing, so that a stop time does not own any strings.
 class StopTime {
 
 public:
-    StopTime(const std::string& tripId = "", const int arrivalTime = -1, const int departureTime = -2, const std::string& stopId = "", const int stopSequence = -1) :
-        tripId(tripId),
+    StopTime(const int tripIndex = -1, const int arrivalTime = -1, const int departureTime = -2, const int stopIndex = -1, const int stopSequence = -1) :
+        tripIndex(tripIndex),
         arrivalTime(arrivalTime),
         departureTime(departureTime),
-        stopId(stopId),
+        stopIndex(stopIndex),
         stopSequence(stopSequence) {
     }
     StopTime(IO::Deserialization& deserialize) {
@@ -23,33 +25,33 @@ public:
     }
 
     inline bool validate() noexcept {
-        return (!tripId.empty()) && (!stopId.empty()) && (arrivalTime <= departureTime);
+        return (tripIndex >= 0) && (stopIndex >= 0) && (arrivalTime <= departureTime);
     }
 
     inline bool operator<(const StopTime& s) const noexcept {
-        return (tripId < s.tripId) || ((tripId == s.tripId) && (
+        return (tripIndex < s.tripIndex) || ((tripIndex == s.tripIndex) && (
                (stopSequence < s.stopSequence) || ((stopSequence == s.stopSequence) && (
                (arrivalTime < s.arrivalTime) || ((arrivalTime == s.arrivalTime) && (
                (departureTime < s.departureTime)))))));
     }
 
     friend std::ostream& operator<<(std::ostream& out, const StopTime& s) {
-        return out << "StopTime{" << s.tripId << ", " << s.arrivalTime  << ", " << s.departureTime << ", " << s.stopId  << ", " << s.stopSequence << "}";
+        return out << "StopTime{" << s.tripIndex << ", " << s.arrivalTime  << ", " << s.departureTime << ", " << s.stopIndex  << ", " << s.stopSequence << "}";
     }
 
     inline void serialize(IO::Serialization& serialize) const noexcept {
-        serialize(tripId, arrivalTime, departureTime, stopId, stopSequence);
+        serialize(tripIndex, arrivalTime, departureTime, stopIndex, stopSequence);
     }
 
     inline void deserialize(IO::Deserialization& deserialize) noexcept {
-        deserialize(tripId, arrivalTime, departureTime, stopId, stopSequence);
+        deserialize(tripIndex, arrivalTime, departureTime, stopIndex, stopSequence);
     }
 
 public:
-    std::string tripId{""};
+    int tripIndex{-1};
     int arrivalTime{-1};
     int departureTime{-2};
-    std::string stopId{""};
+    int stopIndex{-1};
     int stopSequence{-1};
 
 };
@@ -5,6 +5,9 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <limits>
+
+#include <omp.h>
 
 #include "Entities/Stop.h"
 #include "Entities/StopEvent.h"
@@ -125,6 +128,19 @@ public:
 
 class Data {
 
+private:
+    struct DirectTransfer {
+        DirectTransfer(const Vertex from, const Vertex to, const int travelTime) :
+            from(from),
+            to(to),
+            travelTime(travelTime) {
+        }
+
+        Vertex from;
+        Vertex to;
+        int travelTime;
+    };
+
 public:
     Data() {}
 
@@ -143,27 +159,26 @@ public:
         Data data;
         Map<std::string, std::vector<int>> calendars = gtfs.unrollCalendarDates(startDate, endDate, ignoreDaysOfOperation);
         Map<std::string, int> routeIds = gtfs.routeIds();
-        Map<std::string, int> stopIds = gtfs.stopIds();
-        Map<std::string, int> tripIds = gtfs.tripIds();
         Map<std::string, std::vector<int>> frequencyIds = gtfs.frequencyIds();
-        Map<std::string, std::vector<GTFS::StopTime>> stopTimeTrips;
-        for (const GTFS::Trip& trip : gtfs.trips) {
-            if (stopTimeTrips.contains(trip.tripId)) continue;
+        const std::unordered_map<std::string, int> tripIds = gtfs.tripIds();
+        const std::vector<size_t> firstStopTimeOfTrip = gtfs.firstStopTimeOfTrip();
+        std::vector<int> stopIds = Vector::id<int>(gtfs.stops.size());
+        std::vector<int> tripOrder;
+        for (size_t i = 0; i < gtfs.trips.size(); i++) {
+            const GTFS::Trip& trip = gtfs.trips[i];
+            if (tripIds.at(trip.tripId) != int(i)) continue;
             if (!routeIds.contains(trip.routeId)) continue;
             if (!calendars.contains(trip.serviceId)) continue;
-            stopTimeTrips.insert(trip.tripId, std::vector<GTFS::StopTime>());
-        }
-        for (const GTFS::StopTime& stopTime : gtfs.stopTimes) {
-            if (!stopIds.contains(stopTime.stopId)) continue;
-            if (!stopTimeTrips.contains(stopTime.tripId)) continue;
-            stopTimeTrips[stopTime.tripId].emplace_back(stopTime);
+            tripOrder.emplace_back(i);
         }
+        std::sort(tripOrder.begin(), tripOrder.end(), [&](const int a, const int b) {
+            return gtfs.trips[a].tripId < gtfs.trips[b].tripId;
+        });
         int timeTravelTrips = 0;
         int emptyTrips = 0;
-        for (const auto& stopTimeTrip : stopTimeTrips) {
-            const std::string& tripId = stopTimeTrip.first;
-            std::vector<GTFS::StopTime>& stopTimes = stopTimeTrips[tripId];
-            std::sort(stopTimes.begin(), stopTimes.end());
+        std::vector<GTFS::StopTime> stopTimes;
+        for (const int tripIndex : tripOrder) {
+            stopTimes.assign(gtfs.stopTimes.begin() + firstStopTimeOfTrip[tripIndex], gtfs.stopTimes.begin() + firstStopTimeOfTrip[tripIndex + 1]);
             int offset = 0;
             for (size_t i = 1; i < stopTimes.size(); i++) {
                 if (stopTimes[i - 1].departureTime == stopTimes[i].arrivalTime + offset) offset++;
@@ -178,13 +193,13 @@ public:
                 emptyTrips++;
                 continue;
             }
-            const GTFS::Trip& trip = gtfs.trips[tripIds[tripId]];
+            const GTFS::Trip& trip = gtfs.trips[tripIndex];
             const GTFS::Route& route = gtfs.routes[routeIds[trip.routeId]];
             for (const int day : calendars[trip.serviceId]) {
                 const int seconds = day * 24 * 60 * 60;
-                if (frequencyIds.contains(tripId)) {
+                if (frequencyIds.contains(trip.tripId)) {
                     if (ignoreFrequencies) continue;
-                    for (const int i : frequencyIds[tripId]) {
+                    for (const int i : frequencyIds[trip.tripId]) {
                         const GTFS::Frequency& frequency = gtfs.frequencies[i];
                         for (int time = frequency.startTime; time <= frequency.endTime; time += frequency.headwaySecs) {
                             data.buildTrip(gtfs, stopIds, stopTimes, seconds - stopTimes[0].departureTime + time, trip.name, route.name, route.type);
@@ -202,11 +217,14 @@ public:
         for (const StopId stop : data.stopIds()) {
             data.transferGraph.set(Coordinates, stop, data.stops[stop].coordinates);
         }
+        const std::unordered_map<std::string, int> stopIndices = gtfs.stopIds();
         for (const GTFS::Transfer& transfer : gtfs.transfers) {
-            if (!stopIds.contains(transfer.fromStopId)) continue;
-            if (!stopIds.contains(transfer.toStopId)) continue;
-            const StopId fromStopId = StopId(-(stopIds[transfer.fromStopId] + 1));
-            const StopId toStopId = StopId(-(stopIds[transfer.toStopId] + 1));
+            const auto from = stopIndices.find(transfer.fromStopId);
+            const auto to = stopIndices.find(transfer.toStopId);
+            if (from == stopIndices.end()) continue;
+            if (to == stopIndices.end()) continue;
+            const StopId fromStopId = StopId(-(stopIds[from->second] + 1));
+            const StopId toStopId = StopId(-(stopIds[to->second] + 1));
             if (!data.transferGraph.isVertex(fromStopId)) continue;
             if (!data.transferGraph.isVertex(toStopId)) continue;
             if (fromStopId == toStopId) {
@@ -294,11 +312,42 @@ public:
     }
 
 protected:
-    inline void buildTrip(const GTFS::Data& gtfs, Map<std::string, int>& stopIds, const std::vector<GTFS::StopTime>& stopTimes, const int offset, const std::string& tripName, const std::string& routeName, const int type) {
+    // Runs one Dijkstra search per stop on the transfer graph and connects the stop in both directions to every stop
+    // with a smaller ID that is reached within maxTravelTime. The searches run in parallel, each thread collects its
+    // edges separately, and the edges are added to the graph afterwards.
+    inline void addDirectTransfers(TransferGraph& graph, const double maxTravelTime, const bool verbose, const size_t numberOfThreads) const noexcept {
+        std::vector<std::vector<DirectTransfer>> threadTransfers(numberOfThreads);
+        Progress progress(stops.size(), verbose);
+        omp_set_num_threads(numberOfThreads);
+        #pragma omp parallel
+        {
+            Dijkstra<TransferGraph, false> dijkstra(transferGraph, transferGraph[TravelTime]);
+            std::vector<DirectTransfer>& transfers = threadTransfers[omp_get_thread_num()];
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t i = 0; i < stops.size(); i++) {
+                const StopId stop(i);
+                dijkstra.run(stop, noVertex, [&](const Vertex u) {
+                    if (u >= stop) return;
+                    transfers.emplace_back(stop, u, dijkstra.getDistance(u));
+                }, [&]() {
+                    return dijkstra.getDistance(dijkstra.getQFront()) > maxTravelTime;
+                });
+                progress++;
+            }
+        }
+        for (const std::vector<DirectTransfer>& transfers : threadTransfers) {
+            for (const DirectTransfer& transfer : transfers) {
+                graph.addEdge(transfer.from, transfer.to).set(TravelTime, transfer.travelTime);
+                graph.addEdge(transfer.to, transfer.from).set(TravelTime, transfer.travelTime);
+            }
+        }
+    }
+
+    inline void buildTrip(const GTFS::Data& gtfs, std::vector<int>& stopIds, const std::vector<GTFS::StopTime>& stopTimes, const int offset, const std::string& tripName, const std::string& routeName, const int type) {
         trips.emplace_back(tripName, routeName, type);
         Trip& trip = trips.back();
         for (const GTFS::StopTime& stopTime : stopTimes) {
-            int& stopId = stopIds[stopTime.stopId];
+            int& stopId = stopIds[stopTime.stopIndex];
             if (stopId >= 0) {
                 stops.emplace_back(gtfs.stops[stopId]);
                 stopId = -stops.size();
@@ -534,45 +583,55 @@ public:
         validate();
     }
 
-    inline void makeDirectTransfers(const double maxTransferTravelTime, const bool verbose = false) noexcept {
+    inline void makeDirectTransfers(const double maxTransferTravelTime, const bool verbose = false, const size_t numberOfThreads = 1) noexcept {
         TransferGraph graph;
         graph.addVertices(stops.size());
-        Dijkstra<TransferGraph, false> dijkstra(transferGraph, transferGraph[TravelTime]);
-        Progress progress(stops.size(), verbose);
         for (const StopId stop : stopIds()) {
             graph.set(Coordinates, stop, stops[stop].coordinates);
-            dijkstra.run(stop, noVertex, [&](const Vertex u) {
-                if (u >= stop) return;
-                const int travelTime = dijkstra.getDistance(u);
-                graph.addEdge(stop, u).set(TravelTime, travelTime);
-                graph.addEdge(u, stop).set(TravelTime, travelTime);
-            }, [&]() {
-                return dijkstra.getDistance(dijkstra.getQFront()) > maxTransferTravelTime;
-            });
-            progress++;
         }
+        addDirectTransfers(graph, maxTransferTravelTime, verbose, numberOfThreads);
         graph.packEdges();
         Graph::move(std::move(graph), transferGraph);
         validate();
         if (verbose) std::cout << " done." << std::endl;
     }
 
-    inline void makeDirectTransfersByGeoDistance(const double maxDistance, const double speedInKMH, const bool verbose = false) noexcept {
+    inline void makeDirectTransfersByGeoDistance(const double maxDistance, const double speedInKMH, const bool verbose = false, const size_t numberOfThreads = 1) noexcept {
         TransferGraph graph;
         graph.addVertices(stops.size());
-        Progress progress(stops.size(), verbose);
-        for (const StopId from : stopIds()) {
-            graph.set(Coordinates, from, stops[from].coordinates);
-            for (const StopId to : stopIds()) {
-                const Geometry::Point& a = transferGraph.get(Coordinates, from);
-                const Geometry::Point& b = graph.get(Coordinates, to);
-                const double distance = Geometry::geoDistanceInCM(a, b);
-                if (distance <= maxDistance) {
-                    const int travelTime = (distance / speedInKMH) * 0.036;
-                    graph.addEdge(from, to).set(TravelTime, travelTime);
+        std::vector<Geometry::Point> coordinates;
+        for (const StopId stop : stopIds()) {
+            graph.set(Coordinates, stop, stops[stop].coordinates);
+            coordinates.emplace_back(stops[stop].coordinates);
+        }
+        if (!coordinates.empty()) {
+            const CoordinateTree<Geometry::GeoMetric> coordinateTree(Geometry::GeoMetric(), coordinates);
+            std::vector<std::vector<DirectTransfer>> threadTransfers(numberOfThreads);
+            Progress progress(stops.size(), verbose);
+            omp_set_num_threads(numberOfThreads);
+            #pragma omp parallel
+            {
+                // The queries of a CoordinateTree are not thread-safe, so every thread uses its own copy.
+                const CoordinateTree<Geometry::GeoMetric> ct(coordinateTree);
+                std::vector<DirectTransfer>& transfers = threadTransfers[omp_get_thread_num()];
+                #pragma omp for schedule(dynamic, 64)
+                for (size_t i = 0; i < stops.size(); i++) {
+                    const StopId from(i);
+                    for (const Vertex to : ct.getNeighbors(coordinates[from], maxDistance)) {
+                        if (to == from) continue;
+                        const double distance = Geometry::geoDistanceInCM(coordinates[from], coordinates[to]);
+                        if (distance > maxDistance) continue;
+                        const int travelTime = (distance / speedInKMH) * 0.036;
+                        transfers.emplace_back(from, to, travelTime);
+                    }
+                    progress++;
+                }
+            }
+            for (const std::vector<DirectTransfer>& transfers : threadTransfers) {
+                for (const DirectTransfer& transfer : transfers) {
+                    graph.addEdge(transfer.from, transfer.to).set(TravelTime, transfer.travelTime);
                 }
             }
-            progress++;
         }
         graph.packEdges();
         Graph::move(std::move(graph), transferGraph);
@@ -580,7 +639,7 @@ public:
         if (verbose) std::cout << " done." << std::endl;
     }
 
-    inline void makeTransitiveStopGraph(const bool verbose = false) noexcept {
+    inline void makeTransitiveStopGraph(const bool verbose = false, const size_t numberOfThreads = 1) noexcept {
         TransferGraph graph;
         graph.addVertices(transferGraph.numVertices());
         for (const Vertex from : transferGraph.vertices()) {
@@ -591,18 +650,10 @@ public:
             }
         }
         transferGraph.deleteVertices([&](const Vertex vertex){return vertex >= stops.size();});
-        Dijkstra<TransferGraph, false> dijkstra(transferGraph, transferGraph[TravelTime]);
-        Progress progress(stops.size(), verbose);
         for (const StopId stop : stopIds()) {
             graph.set(Coordinates, stop, stops[stop].coordinates);
-            dijkstra.run(stop, noVertex, [&](const Vertex u) {
-                if (u >= stop) return;
-                const int travelTime = dijkstra.getDistance(u);
-                graph.addEdge(stop, u).set(TravelTime, travelTime);
-                graph.addEdge(u, stop).set(TravelTime, travelTime);
-            });
-            progress++;
         }
+        addDirectTransfers(graph, std::numeric_limits<double>::max(), verbose, numberOfThreads);
         graph.packEdges();
         Graph::move(std::move(graph), transferGraph);
         validate();
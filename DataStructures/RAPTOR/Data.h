@@ -13,6 +13,7 @@
 #include "Entities/RouteSegment.h"
 #include "Entities/Journey.h"
 #include "Entities/TripIterator.h"
+#include "Entities/TripSearch.h"
 
 #include "../Intermediate/Data.h"
 #include "../Container/Map.h"
@@ -95,6 +96,7 @@ public:
         data.firstRouteSegmentOfStop.emplace_back(data.routeSegments.size());
         Intermediate::TransferGraph transferGraph = inter.transferGraph;
         Graph::move(std::move(transferGraph), data.transferGraph);
+        data.buildDepartureTimes();
         return data;
     }
 
@@ -230,6 +232,28 @@ public:
         return TripIterator(numberOfStopsInRoute(route), stopArrayOfRoute(route), firstTripOfRoute(route), stopIndex, lastTripOfRoute(route));
     }
 
+    // The departure times of the route are stored column by column: the departure times of all trips at stop index i
+    // start at offset i * numberOfTripsInRoute(route) from the returned pointer.
+    inline const int* departureTimesOfRoute(const RouteId route) const noexcept {
+        AssertMsg(isRoute(route), "The id " << route << " does not represent a route!");
+        AssertMsg(departureTimes.size() == stopEvents.size(), "The departure times have not been built for the current stop events!");
+        return &(departureTimes[firstStopEventOfRoute[route]]);
+    }
+
+    inline void buildDepartureTimes() noexcept {
+        departureTimes.resize(stopEvents.size());
+        for (const RouteId route : routes()) {
+            const size_t firstStopEvent = firstStopEventOfRoute[route];
+            const size_t tripSize = numberOfStopsInRoute(route);
+            const size_t numberOfTrips = numberOfTripsInRoute(route);
+            for (size_t trip = 0; trip < numberOfTrips; trip++) {
+                for (size_t stopIndex = 0; stopIndex < tripSize; stopIndex++) {
+                    departureTimes[firstStopEvent + (stopIndex * numberOfTrips) + trip] = stopEvents[firstStopEvent + (trip * tripSize) + stopIndex].departureTime;
+                }
+            }
+        }
+    }
+
     inline TripIterator getTripIterator(const RouteSegment& route) const noexcept {
         return getTripIterator(route.routeId, route.stopIndex);
     }
@@ -268,6 +292,7 @@ private:
                 }
             }
         }
+        buildDepartureTimes();
     }
 
 public:
@@ -485,6 +510,7 @@ public:
         result.transferGraph.revert();
         result.implicitDepartureBufferTimes = implicitArrivalBufferTimes;
         result.implicitArrivalBufferTimes = implicitDepartureBufferTimes;
+        result.buildDepartureTimes();
         return result;
     }
 
@@ -782,6 +808,7 @@ public:
     inline void deserialize(const std::string& fileName) noexcept {
         IO::deserialize(fileName, firstRouteSegmentOfStop, firstStopIdOfRoute, firstStopEventOfRoute, routeSegments, stopIds, stopEvents, stopData, routeData, implicitDepartureBufferTimes, implicitArrivalBufferTimes);
         transferGraph.readBinary(fileName + ".graph");
+        buildDepartureTimes();
     }
 
     inline void writeCSV(const std::string& fileBaseName) const noexcept {
@@ -881,6 +908,7 @@ public:
         result += Vector::byteSize(routeSegments);
         result += Vector::byteSize(stopIds);
         result += Vector::byteSize(stopEvents);
+        result += Vector::byteSize(departureTimes);
         result += Vector::byteSize(stopData);
         result += Vector::byteSize(routeData);
         result += transferGraph.byteSize();
@@ -970,6 +998,7 @@ public:
 
         newFirstStopEventOfRoute.swap(firstStopEventOfRoute);
         stopEventOrder.order(stopEvents);
+        buildDepartureTimes();
 
         return stopEventOrder;
     }
@@ -1017,6 +1046,8 @@ public:
 
     std::vector<StopId> stopIds;
     std::vector<StopEvent> stopEvents;
+    // Not serialized, rebuilt from stopEvents by buildDepartureTimes() whenever they change.
+    std::vector<int> departureTimes;
 
     std::vector<Stop> stopData;
     std::vector<Route> routeData;
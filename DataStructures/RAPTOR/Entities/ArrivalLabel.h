@@ -46,6 +46,43 @@ public:
 
 };
 
+// Entry of a departure time profile: a journey that departs at departureTime and arrives at arrivalTime using numberOfTrips trips.
+class ProfileLabel {
+
+public:
+    ProfileLabel(const int departureTime = never, const int arrivalTime = never, const size_t numberOfTrips = -1) :
+        departureTime(departureTime),
+        arrivalTime(arrivalTime),
+        numberOfTrips(numberOfTrips) {
+    }
+
+    inline int travelTime() const noexcept {
+        return arrivalTime - departureTime;
+    }
+
+    inline bool operator==(const ProfileLabel& other) const noexcept {
+        return (departureTime == other.departureTime) && (arrivalTime == other.arrivalTime) && (numberOfTrips == other.numberOfTrips);
+    }
+
+    inline bool operator!=(const ProfileLabel& other) const noexcept {
+        return !(*this == other);
+    }
+
+    inline bool dominates(const ProfileLabel& other) const noexcept {
+        return departureTime >= other.departureTime && arrivalTime <= other.arrivalTime && numberOfTrips <= other.numberOfTrips;
+    }
+
+    inline friend std::ostream& operator<<(std::ostream& out, const ProfileLabel& label) noexcept {
+        return out << "departureTime: " << label.departureTime << ", arrivalTime: " << label.arrivalTime << ", numberOfTrips: " << label.numberOfTrips;
+    }
+
+public:
+    int departureTime;
+    int arrivalTime;
+    size_t numberOfTrips;
+
+};
+
 struct WalkingParetoLabel {
     inline static constexpr int NumberOfCriteria = 3;
 
@@ -1,6 +1,12 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #include "../../../Helpers/Assert.h"
 #include "../../Container/ExternalKHeap.h"
@@ -135,6 +141,160 @@ struct Bag {
     std::vector<Label> labels;
 };
 
+// Pareto set of (arrival time, walking distance) pairs for bags that are only used for dominance tests (e.g., the best
+// bags used for pruning), which are the hot spot of the multicriteria algorithms. The labels are stored in blocks of
+// eight arrival times followed by their eight walking distances, so a small bag fits into a single cache line and
+// each block is compared against a new label with a few AVX2 instructions (with a scalar fallback).
+class ParetoBag {
+
+public:
+    inline static constexpr size_t BlockSize = 8;
+
+public:
+    ParetoBag() : numberOfLabels(0) {}
+
+    template<typename LABEL>
+    inline bool dominates(const LABEL& label) const noexcept {
+        return dominates(label.arrivalTime, label.walkingDistance);
+    }
+
+    template<typename OTHER_LABEL>
+    inline bool dominates(const Bag<OTHER_LABEL>& other) const noexcept {
+        for (const OTHER_LABEL& label : other.labels) {
+            if (!dominates(label)) return false;
+        }
+        return true;
+    }
+
+    inline bool dominates(const int arrivalTime, const int walkingDistance) const noexcept {
+#ifdef __AVX2__
+        for (size_t block = 0; block * BlockSize < numberOfLabels; block++) {
+            uint32_t dominating;
+            uint32_t dominated;
+            compareBlock(block, arrivalTime, walkingDistance, dominating, dominated);
+            if (dominating) return true;
+        }
+#else
+        for (size_t i = 0; i < numberOfLabels; i++) {
+            if (arrivalTimeAt(i) <= arrivalTime && walkingDistanceAt(i) <= walkingDistance) return true;
+        }
+#endif
+        return false;
+    }
+
+    template<typename LABEL>
+    inline bool merge(const LABEL& label) noexcept {
+        return merge(label.arrivalTime, label.walkingDistance);
+    }
+
+    inline bool merge(const int arrivalTime, const int walkingDistance) noexcept {
+        size_t firstDominated = numberOfLabels;
+#ifdef __AVX2__
+        for (size_t block = 0; block * BlockSize < numberOfLabels; block++) {
+            uint32_t dominating;
+            uint32_t dominated;
+            compareBlock(block, arrivalTime, walkingDistance, dominating, dominated);
+            if (dominating) return false;
+            if ((firstDominated == numberOfLabels) && dominated) {
+                firstDominated = block * BlockSize + __builtin_ctz(dominated);
+            }
+        }
+#else
+        for (size_t i = 0; i < numberOfLabels; i++) {
+            if (arrivalTimeAt(i) <= arrivalTime && walkingDistanceAt(i) <= walkingDistance) return false;
+            if ((firstDominated == numberOfLabels) && (arrivalTime <= arrivalTimeAt(i)) && (walkingDistance <= walkingDistanceAt(i))) {
+                firstDominated = i;
+            }
+        }
+#endif
+        size_t newSize = firstDominated;
+        for (size_t i = firstDominated; i < numberOfLabels; i++) {
+            if (arrivalTime <= arrivalTimeAt(i) && walkingDistance <= walkingDistanceAt(i)) continue;
+            arrivalTimeAt(newSize) = arrivalTimeAt(i);
+            walkingDistanceAt(newSize) = walkingDistanceAt(i);
+            newSize++;
+        }
+        numberOfLabels = newSize;
+        if (numberOfLabels == capacity()) {
+            values.resize(values.size() + 2 * BlockSize, 0);
+        }
+        arrivalTimeAt(numberOfLabels) = arrivalTime;
+        walkingDistanceAt(numberOfLabels) = walkingDistance;
+        numberOfLabels++;
+        return true;
+    }
+
+    inline size_t size() const noexcept {
+        return numberOfLabels;
+    }
+
+    inline bool empty() const noexcept {
+        return numberOfLabels == 0;
+    }
+
+    inline int arrivalTime(const size_t i) const noexcept {
+        AssertMsg(i < numberOfLabels, "Index " << i << " is out of range!");
+        return arrivalTimeAt(i);
+    }
+
+    inline int walkingDistance(const size_t i) const noexcept {
+        AssertMsg(i < numberOfLabels, "Index " << i << " is out of range!");
+        return walkingDistanceAt(i);
+    }
+
+    inline void clear() noexcept {
+        numberOfLabels = 0;
+    }
+
+private:
+    inline static size_t offset(const size_t i) noexcept {
+        return (i / BlockSize) * 2 * BlockSize + (i % BlockSize);
+    }
+
+    inline int& arrivalTimeAt(const size_t i) noexcept {
+        return values[offset(i)];
+    }
+
+    inline int arrivalTimeAt(const size_t i) const noexcept {
+        return values[offset(i)];
+    }
+
+    inline int& walkingDistanceAt(const size_t i) noexcept {
+        return values[offset(i) + BlockSize];
+    }
+
+    inline int walkingDistanceAt(const size_t i) const noexcept {
+        return values[offset(i) + BlockSize];
+    }
+
+    inline size_t capacity() const noexcept {
+        return values.size() / 2;
+    }
+
+#ifdef __AVX2__
+    // Bit i of dominating is set if label i of the block dominates the given label, bit i of dominated is set if the
+    // given label dominates label i of the block. Lanes beyond the size of the bag are never set.
+    inline void compareBlock(const size_t block, const int arrivalTime, const int walkingDistance, uint32_t& dominating, uint32_t& dominated) const noexcept {
+        const int* arrivalTimes = &values[block * 2 * BlockSize];
+        const int* walkingDistances = arrivalTimes + BlockSize;
+        const size_t lanes = std::min(BlockSize, numberOfLabels - block * BlockSize);
+        const __m256i blockArrivalTimes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(arrivalTimes));
+        const __m256i blockWalkingDistances = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(walkingDistances));
+        const __m256i arrivalTimeVector = _mm256_set1_epi32(arrivalTime);
+        const __m256i walkingDistanceVector = _mm256_set1_epi32(walkingDistance);
+        const __m256i blockIsWorse = _mm256_or_si256(_mm256_cmpgt_epi32(blockArrivalTimes, arrivalTimeVector), _mm256_cmpgt_epi32(blockWalkingDistances, walkingDistanceVector));
+        const __m256i blockIsBetter = _mm256_or_si256(_mm256_cmpgt_epi32(arrivalTimeVector, blockArrivalTimes), _mm256_cmpgt_epi32(walkingDistanceVector, blockWalkingDistances));
+        const uint32_t validLanes = (uint32_t(1) << lanes) - 1;
+        dominating = ~static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(blockIsWorse))) & validLanes;
+        dominated = ~static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(blockIsBetter))) & validLanes;
+    }
+#endif
+
+private:
+    std::vector<int> values;
+    size_t numberOfLabels;
+};
+
 template<typename ROUTE_LABEL>
 struct RouteBag {
     using RouteLabel = ROUTE_LABEL;
@@ -166,9 +326,75 @@ struct RouteBag {
         return labels[i];
     }
 
+    inline void clear() noexcept {
+        labels.clear();
+    }
+
     std::vector<RouteLabel> labels;
 };
 
+// Stores the bags of all rounds of a multicriteria query. Clearing keeps the rounds and the label memory of their
+// bags, so after a few queries, a query only allocates memory if it needs more labels at a stop than all previous ones.
+template<typename BAG>
+class BagRounds {
+
+public:
+    using BagType = BAG;
+    using Round = std::vector<BagType>;
+
+public:
+    BagRounds() : numberOfRounds(0) {}
+
+    inline size_t size() const noexcept {
+        return numberOfRounds;
+    }
+
+    inline bool empty() const noexcept {
+        return numberOfRounds == 0;
+    }
+
+    inline Round& operator[](const size_t i) noexcept {
+        AssertMsg(i < numberOfRounds, "Round " << i << " does not exist!");
+        return rounds[i];
+    }
+
+    inline const Round& operator[](const size_t i) const noexcept {
+        AssertMsg(i < numberOfRounds, "Round " << i << " does not exist!");
+        return rounds[i];
+    }
+
+    inline Round& back() noexcept {
+        AssertMsg(numberOfRounds > 0, "Cannot return last round, because no round exists!");
+        return rounds[numberOfRounds - 1];
+    }
+
+    inline Round& addRound(const size_t numberOfBags) noexcept {
+        if (numberOfRounds == rounds.size()) {
+            rounds.emplace_back(numberOfBags);
+        }
+        AssertMsg(rounds[numberOfRounds].size() == numberOfBags, "Round has " << rounds[numberOfRounds].size() << " bags, but should have " << numberOfBags << "!");
+        return rounds[numberOfRounds++];
+    }
+
+    inline void clear() noexcept {
+        for (size_t i = 0; i < numberOfRounds; i++) {
+            for (BagType& bag : rounds[i]) {
+                bag.clear();
+            }
+        }
+        numberOfRounds = 0;
+    }
+
+    inline void reset() noexcept {
+        std::vector<Round>().swap(rounds);
+        numberOfRounds = 0;
+    }
+
+private:
+    std::vector<Round> rounds;
+    size_t numberOfRounds;
+};
+
 template<typename DIJKSTRA_LABEL>
 class DijkstraBag : public ExternalKHeapElement {
 public:
@@ -257,6 +483,12 @@ public:
         return true;
     }
 
+    inline void clear() noexcept {
+        AssertMsg(!isOnHeap(), "Trying to clear a bag that is still on the heap!");
+        labels.clear();
+        heapSize = 0;
+    }
+
     inline void initialize(const DijkstraLabel& label) noexcept {
         AssertMsg(labels.empty(), "Trying to initialize non-empty bag!");
         AssertMsg(heapSize == 0, "Trying to initialize non-empty bag!");
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace RAPTOR {
+
+// The trip searches operate on a column of departure times, i.e., the departure times of all trips of a route at a
+// single stop index, ordered by trip. They return the same trip as the corresponding linear scan, even if the trips of
+// the route overtake each other. With AVX2, eight trips are compared at once.
+
+// Returns the earliest trip t <= endTrip such that all trips t, ..., endTrip - 1 depart no earlier than time, i.e., the
+// trip at which a backward scan starting at endTrip stops.
+inline size_t findEarliestTripBackward(const int* departureTimes, size_t endTrip, const int time) noexcept {
+    if ((endTrip == 0) || (departureTimes[endTrip - 1] < time)) return endTrip;
+    endTrip--;
+#ifdef __AVX2__
+    const __m256i timeVector = _mm256_set1_epi32(time);
+    while (endTrip >= 8) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(departureTimes + endTrip - 8));
+        const uint32_t departsEarlier = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(timeVector, block)));
+        if (departsEarlier) return endTrip - 8 + (32 - __builtin_clz(departsEarlier));
+        endTrip -= 8;
+    }
+#endif
+    while ((endTrip > 0) && (departureTimes[endTrip - 1] >= time)) {
+        endTrip--;
+    }
+    return endTrip;
+}
+
+// Returns the first trip t with beginTrip <= t < endTrip that departs no earlier than time, or endTrip if there is none,
+// i.e., the trip at which a forward scan starting at beginTrip stops.
+inline size_t findEarliestTripForward(const int* departureTimes, size_t beginTrip, const size_t endTrip, const int time) noexcept {
+#ifdef __AVX2__
+    const __m256i timeVector = _mm256_set1_epi32(time);
+    while (beginTrip + 8 <= endTrip) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(departureTimes + beginTrip));
+        const uint32_t departsEarlier = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(timeVector, block)));
+        if (departsEarlier != 0xFF) return beginTrip + __builtin_ctz(~departsEarlier);
+        beginTrip += 8;
+    }
+#endif
+    while ((beginTrip < endTrip) && (departureTimes[beginTrip] < time)) {
+        beginTrip++;
+    }
+    return beginTrip;
+}
+
+}
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
 #include "Data.h"
 #include "Delay.h"
 #include "DelayUpdateData.h"
@@ -9,8 +14,26 @@
 
 namespace TripBased {
 
+// The shortcut graph with a set of replacement shortcuts merged into it. Building it only reads the shortcut graph of
+// the DelayData, so it can be done in the background while further delay updates are processed.
+struct ShortcutGraphMerge {
+    std::vector<ShortcutInfo> shortcuts;
+    DelayGraph stopEventGraph;
+    std::vector<Edge> newEdgeOfOldEdge;
+    std::vector<std::pair<Vertex, Edge>> mergedEdges;
+    std::vector<std::pair<Vertex, Edge>> incomingShortcuts;
+    std::vector<size_t> firstIncomingShortcut;
+};
+
 class DelayData {
 
+private:
+    enum ShortcutState : u_int8_t {
+        Discarded,
+        Feasible,
+        Infeasible
+    };
+
 public:
     DelayData(const RAPTOR::Data& raptorData, const TransferGraph& shortcuts, const int maxArrivalDelay, const int maxDepartureDelay) :
         DelayData(raptorData, maxArrivalDelay, maxDepartureDelay) {
@@ -50,7 +73,11 @@ public:
 
     inline void serialize(const std::string& fileName) const noexcept {
         data.serialize(fileName + ".tripBased");
-        stopEventGraph.writeBinary(fileName + ".delayGraph");
+        if (replacementShortcuts.empty()) {
+            stopEventGraph.writeBinary(fileName + ".delayGraph");
+        } else {
+            mergeShortcutGraph(replacementShortcuts).stopEventGraph.writeBinary(fileName + ".delayGraph");
+        }
         IO::serialize(fileName, maxArrivalDelay, maxDepartureDelay);
     }
 
@@ -58,6 +85,8 @@ public:
         data.deserialize(fileName + ".tripBased");
         stopEventGraph.readBinary(fileName + ".delayGraph");
         IO::deserialize(fileName, maxArrivalDelay, maxDepartureDelay);
+        replacementShortcuts.clear();
+        shortcutState.clear();
     }
 
     inline int delayedArrivalTime(const StopEventId stopEvent) const noexcept {
@@ -97,28 +126,118 @@ public:
         std::cout << "   Infeasible Shortcuts:       " << std::setw(12) << String::prettyInt(infeasibleEdges) << std::endl;
         std::cout << "   Min Origin Delay Shortcuts: " << std::setw(12) << String::prettyInt(minOriginDelayEdges) << std::endl;
         std::cout << "   Max Origin Delay Shortcuts: " << std::setw(12) << String::prettyInt(maxOriginDelayEdges) << std::endl;
+        std::cout << "   Unmerged Replacements:      " << std::setw(12) << String::prettyInt(replacementShortcuts.size()) << std::endl;
     }
 
-    inline DelayUpdateData createUpdateData(const RAPTOR::BucketCHInitialTransfers& initialTransfers) const noexcept {
+    inline DelayUpdateData createUpdateData(const RAPTOR::BucketCHInitialTransfers& initialTransfers) noexcept {
         DelayUpdateData result(initialTransfers);
         refreshUpdateData(result);
         return result;
     }
 
-    inline void refreshUpdateData(DelayUpdateData& updateData) const noexcept {
+    inline void refreshUpdateData(DelayUpdateData& updateData) noexcept {
         updateData.update(getDelayedRaptorData(), filterShortcutGraph());
     }
 
-    inline DelayQueryData createQueryData() const noexcept {
+    inline DelayQueryData createQueryData() noexcept {
         DelayQueryData result;
         refreshQueryData(result);
         return result;
     }
 
-    inline void refreshQueryData(DelayQueryData& queryData) const noexcept {
+    inline void refreshQueryData(DelayQueryData& queryData) noexcept {
         queryData.update(getDelayedRaptorData(), filterShortcutGraph());
     }
 
+    // Replacement shortcuts are kept in a sorted side buffer, which is included by the filtering, until they are
+    // merged into the shortcut graph. A replacement for an existing shortcut resets its origin delay bounds.
+    inline void addReplacementShortcuts(std::vector<ShortcutInfo>& shortcuts) noexcept {
+        if (shortcuts.empty()) return;
+        std::sort(shortcuts.begin(), shortcuts.end());
+        std::vector<ShortcutInfo> newReplacementShortcuts;
+        newReplacementShortcuts.reserve(replacementShortcuts.size() + shortcuts.size());
+        std::set_union(replacementShortcuts.begin(), replacementShortcuts.end(), shortcuts.begin(), shortcuts.end(), std::back_inserter(newReplacementShortcuts));
+        replacementShortcuts.swap(newReplacementShortcuts);
+    }
+
+    inline const std::vector<ShortcutInfo>& getReplacementShortcuts() const noexcept {
+        return replacementShortcuts;
+    }
+
+    inline size_t numberOfReplacementShortcuts() const noexcept {
+        return replacementShortcuts.size();
+    }
+
+    // Only reads the shortcut graph, so this may run concurrently with delay updates and filtering, but not with
+    // applyShortcutGraphMerge().
+    inline ShortcutGraphMerge mergeShortcutGraph(std::vector<ShortcutInfo> shortcuts) const noexcept {
+        ShortcutGraphMerge merge;
+        merge.shortcuts = std::move(shortcuts);
+        const std::vector<ShortcutInfo>& newShortcuts = merge.shortcuts;
+        DelayGraph& graph = merge.stopEventGraph;
+        graph.reserve(stopEventGraph.numVertices(), stopEventGraph.numEdges() + newShortcuts.size());
+        merge.newEdgeOfOldEdge.resize(stopEventGraph.numEdges(), noEdge);
+        size_t j = 0;
+        for (const Vertex from : stopEventGraph.vertices()) {
+            graph.addVertex();
+            Edge i = stopEventGraph.beginEdgeFrom(from);
+            while (i < stopEventGraph.endEdgeFrom(from) && j < newShortcuts.size() && newShortcuts[j].from == from) {
+                const Vertex iTo = stopEventGraph.get(ToVertex, i);
+                const Vertex jTo = newShortcuts[j].to;
+                if (iTo == jTo) {
+                    const Edge edge = graph.addEdge(from, iTo, stopEventGraph.edgeRecord(i));
+                    graph.set(MinOriginDelay, edge, 0);
+                    graph.set(MaxOriginDelay, edge, INFTY);
+                    merge.newEdgeOfOldEdge[i] = edge;
+                    merge.mergedEdges.emplace_back(from, edge);
+                    i++;
+                    j++;
+                } else if (iTo < jTo) {
+                    merge.newEdgeOfOldEdge[i] = graph.addEdge(from, iTo, stopEventGraph.edgeRecord(i));
+                    i++;
+                } else {
+                    merge.mergedEdges.emplace_back(from, addReplacementEdge(graph, newShortcuts[j]));
+                    j++;
+                }
+            }
+            for (; i < stopEventGraph.endEdgeFrom(from); i++) {
+                merge.newEdgeOfOldEdge[i] = graph.addEdge(from, stopEventGraph.get(ToVertex, i), stopEventGraph.edgeRecord(i));
+            }
+            for (; j < newShortcuts.size() && newShortcuts[j].from == from; j++) {
+                merge.mergedEdges.emplace_back(from, addReplacementEdge(graph, newShortcuts[j]));
+            }
+        }
+        buildIncomingShortcuts(graph, merge.incomingShortcuts, merge.firstIncomingShortcut);
+        return merge;
+    }
+
+    // Replaces the shortcut graph with the merged one. The filter states of the old shortcuts are carried over, only
+    // the merged shortcuts are evaluated again.
+    inline void applyShortcutGraphMerge(ShortcutGraphMerge&& merge) noexcept {
+        AssertMsg(merge.newEdgeOfOldEdge.size() == stopEventGraph.numEdges(), "The shortcut graph has changed since the merge was started!");
+        updateShortcutStates();
+        std::vector<u_int8_t> newShortcutState(merge.stopEventGraph.numEdges(), Discarded);
+        for (const Edge edge : stopEventGraph.edges()) {
+            newShortcutState[merge.newEdgeOfOldEdge[edge]] = shortcutState[edge];
+        }
+        Graph::move(std::move(merge.stopEventGraph), stopEventGraph);
+        shortcutState.swap(newShortcutState);
+        incomingShortcuts.swap(merge.incomingShortcuts);
+        firstIncomingShortcut.swap(merge.firstIncomingShortcut);
+        for (const auto& [fromStopEvent, shortcut] : merge.mergedEdges) {
+            shortcutState[shortcut] = getShortcutState(fromStopEvent, shortcut);
+            markFilterChanged(fromStopEvent);
+        }
+        std::vector<ShortcutInfo> remainingShortcuts;
+        std::set_difference(replacementShortcuts.begin(), replacementShortcuts.end(), merge.shortcuts.begin(), merge.shortcuts.end(), std::back_inserter(remainingShortcuts));
+        replacementShortcuts.swap(remainingShortcuts);
+    }
+
+    inline void mergeReplacementShortcuts() noexcept {
+        if (replacementShortcuts.empty()) return;
+        applyShortcutGraphMerge(mergeShortcutGraph(replacementShortcuts));
+    }
+
     inline void delayTripFromEvent(const TripId trip, const StopIndex index, const int delay, const bool allowOvertaking, const bool ignoreMaxDelay) noexcept {
         const StopEventId startingEvent = StopEventId(data.firstStopEventOfTrip[trip] + index);
         const bool hasNextTrip = (data.routeOfTrip[trip] == data.routeOfTrip[trip + 1]);
@@ -191,31 +310,154 @@ private:
             delayedData.stopEvents[event].arrivalTime += arrivalDelay[event];
             delayedData.stopEvents[event].departureTime += departureDelay[event];
         }
+        delayedData.buildDepartureTimes();
         return delayedData;
     }
 
-    inline std::pair<TransferGraph, TransferGraph> filterShortcutGraph() const noexcept {
+    // Splits the shortcuts into the feasible ones used by the queries and the infeasible ones. The state of each
+    // shortcut is cached, and only the shortcuts incident to stop events whose delays have changed are evaluated again.
+    // The result is kept as well: Only the stop events whose shortcut states have changed or which have replacement
+    // shortcuts are filtered again, the shortcuts of all others are copied from the previous result.
+    inline const std::pair<TransferGraph, TransferGraph>& filterShortcutGraph() noexcept {
+        updateShortcutStates();
+        for (const ShortcutInfo& shortcut : replacementShortcuts) {
+            markFilterChanged(shortcut.from);
+        }
+        const bool hasPreviousResult = (filteredShortcuts.first.numVertices() == stopEventGraph.numVertices());
+        if (hasPreviousResult && changedStopEvents.empty()) return filteredShortcuts;
+        const TransferGraph& previousResult = filteredShortcuts.first;
+        const TransferGraph& previousInfeasibleShortcuts = filteredShortcuts.second;
         TransferGraph result;
         TransferGraph infeasibleShortcuts;
-        result.reserve(stopEventGraph.numVertices(), stopEventGraph.numEdges());
-        infeasibleShortcuts.reserve(stopEventGraph.numVertices(), stopEventGraph.numEdges());
+        result.reserve(stopEventGraph.numVertices(), previousResult.numEdges() + replacementShortcuts.size());
+        infeasibleShortcuts.reserve(stopEventGraph.numVertices(), previousInfeasibleShortcuts.numEdges() + replacementShortcuts.size());
+        size_t j = 0;
         for (const Vertex fromStopEvent : stopEventGraph.vertices()) {
             result.addVertex();
             infeasibleShortcuts.addVertex();
+            if (hasPreviousResult && !filterChanged[fromStopEvent]) {
+                copyShortcuts(previousResult, result, fromStopEvent);
+                copyShortcuts(previousInfeasibleShortcuts, infeasibleShortcuts, fromStopEvent);
+                continue;
+            }
             for (const Edge shortcut : stopEventGraph.edgesFrom(fromStopEvent)) {
-                if (stopEventGraph.get(MinOriginDelay, shortcut) > arrivalDelay[fromStopEvent]) continue;
-                const Vertex toStopEvent = stopEventGraph.get(ToVertex, shortcut);
-                const int travelTime = stopEventGraph.get(TravelTime, shortcut);
-                if (!isTransferFeasible(StopEventId(fromStopEvent), StopEventId(toStopEvent), travelTime)) {
-                    infeasibleShortcuts.addEdge(fromStopEvent, toStopEvent, stopEventGraph.edgeRecord(shortcut));
-                } else {
-                    const int maxOriginDelay = stopEventGraph.get(MaxOriginDelay, shortcut);
-                    if (maxOriginDelay < maxArrivalDelay && maxOriginDelay < arrivalDelay[fromStopEvent]) continue;
-                    result.addEdge(fromStopEvent, toStopEvent, stopEventGraph.edgeRecord(shortcut));
+                if (j < replacementShortcuts.size() && replacementShortcuts[j].from == fromStopEvent) {
+                    const Vertex toStopEvent = stopEventGraph.get(ToVertex, shortcut);
+                    for (; j < replacementShortcuts.size() && replacementShortcuts[j].from == fromStopEvent && replacementShortcuts[j].to < toStopEvent; j++) {
+                        addReplacementShortcut(result, infeasibleShortcuts, replacementShortcuts[j]);
+                    }
+                    if (j < replacementShortcuts.size() && replacementShortcuts[j].from == fromStopEvent && replacementShortcuts[j].to == toStopEvent) {
+                        const int travelTime = stopEventGraph.get(TravelTime, shortcut);
+                        TransferGraph& graph = isTransferFeasible(StopEventId(fromStopEvent), StopEventId(toStopEvent), travelTime) ? result : infeasibleShortcuts;
+                        graph.addEdge(fromStopEvent, toStopEvent).set(TravelTime, travelTime);
+                        j++;
+                        continue;
+                    }
+                }
+                if (shortcutState[shortcut] == Feasible) {
+                    result.addEdge(fromStopEvent, stopEventGraph.get(ToVertex, shortcut)).set(TravelTime, stopEventGraph.get(TravelTime, shortcut));
+                } else if (shortcutState[shortcut] == Infeasible) {
+                    infeasibleShortcuts.addEdge(fromStopEvent, stopEventGraph.get(ToVertex, shortcut)).set(TravelTime, stopEventGraph.get(TravelTime, shortcut));
+                }
+            }
+            for (; j < replacementShortcuts.size() && replacementShortcuts[j].from == fromStopEvent; j++) {
+                addReplacementShortcut(result, infeasibleShortcuts, replacementShortcuts[j]);
+            }
+        }
+        for (const Vertex fromStopEvent : changedStopEvents) {
+            filterChanged[fromStopEvent] = false;
+        }
+        changedStopEvents.clear();
+        filteredShortcuts.first = std::move(result);
+        filteredShortcuts.second = std::move(infeasibleShortcuts);
+        return filteredShortcuts;
+    }
+
+    inline static void copyShortcuts(const TransferGraph& from, TransferGraph& to, const Vertex fromStopEvent) noexcept {
+        for (const Edge shortcut : from.edgesFrom(fromStopEvent)) {
+            to.addEdge(fromStopEvent, from.get(ToVertex, shortcut)).set(TravelTime, from.get(TravelTime, shortcut));
+        }
+    }
+
+    inline void markFilterChanged(const Vertex fromStopEvent) noexcept {
+        if (filterChanged[fromStopEvent]) return;
+        filterChanged[fromStopEvent] = true;
+        changedStopEvents.emplace_back(fromStopEvent);
+    }
+
+    inline void addReplacementShortcut(TransferGraph& result, TransferGraph& infeasibleShortcuts, const ShortcutInfo& shortcut) const noexcept {
+        TransferGraph& graph = isTransferFeasible(StopEventId(shortcut.from), StopEventId(shortcut.to), shortcut.travelTime) ? result : infeasibleShortcuts;
+        graph.addEdge(shortcut.from, shortcut.to).set(TravelTime, shortcut.travelTime);
+    }
+
+    inline static Edge addReplacementEdge(DelayGraph& graph, const ShortcutInfo& shortcut) noexcept {
+        const Edge edge = graph.addEdge(shortcut.from, shortcut.to).set(TravelTime, shortcut.travelTime);
+        graph.set(MinOriginDelay, edge, 0);
+        graph.set(MaxOriginDelay, edge, INFTY);
+        return edge;
+    }
+
+    inline u_int8_t getShortcutState(const Vertex fromStopEvent, const Edge shortcut) const noexcept {
+        if (stopEventGraph.get(MinOriginDelay, shortcut) > arrivalDelay[fromStopEvent]) return Discarded;
+        const Vertex toStopEvent = stopEventGraph.get(ToVertex, shortcut);
+        if (!isTransferFeasible(StopEventId(fromStopEvent), StopEventId(toStopEvent), stopEventGraph.get(TravelTime, shortcut))) return Infeasible;
+        const int maxOriginDelay = stopEventGraph.get(MaxOriginDelay, shortcut);
+        if (maxOriginDelay < maxArrivalDelay && maxOriginDelay < arrivalDelay[fromStopEvent]) return Discarded;
+        return Feasible;
+    }
+
+    inline void updateShortcutState(const Vertex fromStopEvent, const Edge shortcut) noexcept {
+        const u_int8_t state = getShortcutState(fromStopEvent, shortcut);
+        if (shortcutState[shortcut] == state) return;
+        shortcutState[shortcut] = state;
+        markFilterChanged(fromStopEvent);
+    }
+
+    // The state of a shortcut depends on the arrival delay of its origin and the departure delay of its destination.
+    inline void updateShortcutStates() noexcept {
+        if (shortcutState.size() != stopEventGraph.numEdges() || filteredArrivalDelay.size() != arrivalDelay.size()) {
+            buildIncomingShortcuts(stopEventGraph, incomingShortcuts, firstIncomingShortcut);
+            shortcutState.resize(stopEventGraph.numEdges());
+            for (const auto [shortcut, fromStopEvent] : stopEventGraph.edgesWithFromVertex()) {
+                shortcutState[shortcut] = getShortcutState(fromStopEvent, shortcut);
+            }
+            filteredShortcuts = std::make_pair(TransferGraph(), TransferGraph());
+            filterChanged.assign(stopEventGraph.numVertices(), false);
+            changedStopEvents.clear();
+            filteredArrivalDelay = arrivalDelay;
+            filteredDepartureDelay = departureDelay;
+            return;
+        }
+        for (size_t event = 0; event < arrivalDelay.size(); event++) {
+            if (arrivalDelay[event] != filteredArrivalDelay[event]) {
+                filteredArrivalDelay[event] = arrivalDelay[event];
+                for (const Edge shortcut : stopEventGraph.edgesFrom(Vertex(event))) {
+                    updateShortcutState(Vertex(event), shortcut);
+                }
+            }
+            if (departureDelay[event] != filteredDepartureDelay[event]) {
+                filteredDepartureDelay[event] = departureDelay[event];
+                for (size_t i = firstIncomingShortcut[event]; i < firstIncomingShortcut[event + 1]; i++) {
+                    const auto [fromStopEvent, shortcut] = incomingShortcuts[i];
+                    updateShortcutState(fromStopEvent, shortcut);
                 }
             }
         }
-        return std::make_pair(result, infeasibleShortcuts);
+    }
+
+    inline static void buildIncomingShortcuts(const DelayGraph& graph, std::vector<std::pair<Vertex, Edge>>& incoming, std::vector<size_t>& firstIncoming) noexcept {
+        firstIncoming.assign(graph.numVertices() + 1, 0);
+        for (const Edge edge : graph.edges()) {
+            firstIncoming[graph.get(ToVertex, edge) + 1]++;
+        }
+        for (size_t i = 1; i < firstIncoming.size(); i++) {
+            firstIncoming[i] += firstIncoming[i - 1];
+        }
+        std::vector<size_t> nextIncoming(firstIncoming.begin(), firstIncoming.end() - 1);
+        incoming.resize(graph.numEdges());
+        for (const auto [edge, from] : graph.edgesWithFromVertex()) {
+            incoming[nextIncoming[graph.get(ToVertex, edge)]++] = std::make_pair(from, edge);
+        }
     }
 
 public:
@@ -226,6 +468,17 @@ public:
     int maxDepartureDelay;
     std::vector<int> arrivalDelay;
     std::vector<int> departureDelay;
+
+private:
+    std::vector<ShortcutInfo> replacementShortcuts;
+    std::vector<u_int8_t> shortcutState;
+    std::vector<std::pair<Vertex, Edge>> incomingShortcuts;
+    std::vector<size_t> firstIncomingShortcut;
+    std::vector<int> filteredArrivalDelay;
+    std::vector<int> filteredDepartureDelay;
+    std::pair<TransferGraph, TransferGraph> filteredShortcuts;
+    std::vector<bool> filterChanged;
+    std::vector<Vertex> changedStopEvents;
 };
 
 }
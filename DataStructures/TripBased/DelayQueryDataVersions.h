@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "DelayUpdateData.h"
+
+namespace TripBased {
+
+// Read-copy-update publication of DelayQueryData. Readers pin the current version with acquire() and can query it
+// for as long as they hold the pointer, while the updater builds the next version from scratch and publishes it.
+// A version that has been replaced is freed as soon as its last reader releases it.
+class DelayQueryDataVersions {
+
+public:
+    using Version = std::shared_ptr<const DelayQueryData>;
+
+public:
+    DelayQueryDataVersions() :
+        numberOfPublishedVersions(0),
+        numberOfLiveVersions(std::make_shared<std::atomic<size_t>>(0)) {
+    }
+
+    DelayQueryDataVersions(const DelayQueryDataVersions&) = delete;
+    DelayQueryDataVersions& operator=(const DelayQueryDataVersions&) = delete;
+
+    inline Version acquire() const noexcept {
+        return std::atomic_load(&currentVersion);
+    }
+
+    inline void publish(DelayQueryData&& queryData) noexcept {
+        std::shared_ptr<std::atomic<size_t>> liveVersions = numberOfLiveVersions;
+        (*liveVersions)++;
+        const Version newVersion(new DelayQueryData(std::move(queryData)), [liveVersions](const DelayQueryData* version) {
+            delete version;
+            (*liveVersions)--;
+        });
+        std::atomic_store(&currentVersion, newVersion);
+        numberOfPublishedVersions++;
+    }
+
+    inline size_t getNumberOfPublishedVersions() const noexcept {
+        return numberOfPublishedVersions;
+    }
+
+    // Number of versions that have not been freed yet, including the current one.
+    inline size_t getNumberOfLiveVersions() const noexcept {
+        return *numberOfLiveVersions;
+    }
+
+private:
+    Version currentVersion;
+    std::atomic<size_t> numberOfPublishedVersions;
+    std::shared_ptr<std::atomic<size_t>> numberOfLiveVersions;
+
+};
+
+}
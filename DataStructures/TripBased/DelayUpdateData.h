@@ -65,7 +65,7 @@ struct DelayUpdateData {
         initialTransfers(initialTransfers) {
     }
 
-    inline void update(const RAPTOR::Data&& newRaptorData, const std::pair<TransferGraph, TransferGraph>&& filteredShortcuts) noexcept {
+    inline void update(const RAPTOR::Data&& newRaptorData, const std::pair<TransferGraph, TransferGraph>& filteredShortcuts) noexcept {
         raptorData = std::move(newRaptorData);
         const Order stopEventOrder = raptorData.rebuildRoutes();
         internalToOriginal = Permutation(stopEventOrder);
@@ -73,7 +73,7 @@ struct DelayUpdateData {
         reverseRaptorData = raptorData.reverseNetwork();
         tripData = Data(raptorData);
         routeGrouping = RouteGrouping(raptorData);
-        std::tie(tripData.stopEventGraph, infeasibleShortcuts) = std::move(filteredShortcuts);
+        std::tie(tripData.stopEventGraph, infeasibleShortcuts) = filteredShortcuts;
         tripData.stopEventGraph.applyVertexPermutation(originalToInternal);
         tripData.stopEventGraph.sortEdges(ToVertex);
         infeasibleShortcuts.applyVertexPermutation(originalToInternal);
@@ -94,7 +94,7 @@ struct DelayUpdateData {
 };
 
 struct DelayQueryData {
-    inline void update(RAPTOR::Data&& newRaptorData, const std::pair<TransferGraph, TransferGraph>&& filteredShortcuts) noexcept {
+    inline void update(RAPTOR::Data&& newRaptorData, const std::pair<TransferGraph, TransferGraph>& filteredShortcuts) noexcept {
         const Order stopEventOrder = newRaptorData.rebuildRoutes();
         internalToOriginal = Permutation(stopEventOrder);
         const Permutation originalToInternal(Construct::Invert, stopEventOrder);
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <tuple>
+
 #include "../../Helpers/Types.h"
 #include "../../Helpers/IO/Serialization.h"
+#include "../../Helpers/Vector/Permutation.h"
 
 namespace TripBased {
 
@@ -17,6 +20,35 @@ struct Shortcut {
     int walkingDistance;
 };
 
+struct ShortcutInfo {
+    ShortcutInfo(const Vertex from = noVertex, const Vertex to = noVertex, const int travelTime = INFTY) :
+        from(from),
+        to(to),
+        travelTime(travelTime) {
+    }
+
+    inline void applyVertexPermutation(const Permutation& permutation) noexcept {
+        from = permutation.permutate(from);
+        to = permutation.permutate(to);
+    }
+
+    inline bool operator<(const ShortcutInfo& other) const noexcept {
+        return std::tie(from, to) < std::tie(other.from, other.to);
+    }
+
+    inline void serialize(IO::Serialization& serialize) const noexcept {
+        serialize(from, to, travelTime);
+    }
+
+    inline void deserialize(IO::Deserialization& deserialize) noexcept {
+        deserialize(from, to, travelTime);
+    }
+
+    Vertex from;
+    Vertex to;
+    int travelTime;
+};
+
 struct DelayShortcut {
     DelayShortcut(const StopEventId destination, const int travelTime, const int minOriginDelay, const int maxOriginDelay) :
         destination(destination),
@@ -13,6 +13,7 @@
 
 #include <strings.h>
 #include <string.h>
+#include <sys/resource.h>
 
 #include "HighlightText.h"
 
@@ -51,6 +52,13 @@ inline void sleep(int milliSeconds) {
     std::this_thread::sleep_for(timespan);
 }
 
+// Peak resident set size of the process in bytes.
+inline long long peakMemoryUsage() noexcept {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return static_cast<long long>(usage.ru_maxrss) * 1024;
+}
+
 template<typename T>
 inline T floor(const T value, const T unit) noexcept {
     return std::floor((value - unit) / unit) * unit;
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+
+#include "Assert.h"
+#include "String/String.h"
+
+// Log-linear histogram in the style of HdrHistogram. Values below SubBucketCount are counted exactly, larger values
+// are counted in buckets whose width is at most 1/SubBucketHalf of their lower bound (i.e., less than 2% error).
+// The bucket array only grows up to the largest recorded value, so recording a value is a few instructions.
+// Values are recorded in steps of 1/resolution, e.g., times in microseconds are recorded in nanoseconds with
+// TimeResolution, so sub-microsecond times are not rounded away.
+class Histogram {
+
+public:
+    inline static constexpr int SubBucketBits = 7;
+    inline static constexpr uint64_t SubBucketCount = uint64_t(1) << SubBucketBits;
+    inline static constexpr uint64_t SubBucketHalf = SubBucketCount / 2;
+
+    inline static constexpr uint64_t TimeResolution = 1000;
+
+    inline static constexpr int NameWidth = 28;
+    inline static constexpr int ValueWidth = 14;
+
+    inline static constexpr double Percentiles[] = {50, 90, 99};
+    inline static constexpr size_t NumPercentiles = sizeof(Percentiles) / sizeof(Percentiles[0]);
+
+public:
+    Histogram(const uint64_t resolution = 1) :
+        resolution(resolution),
+        numValues(0),
+        sum(0),
+        maxValue(0) {
+    }
+
+    inline void add(const uint64_t value) noexcept {
+        record(value * resolution);
+        sum += value;
+    }
+
+    inline void add(const double value) noexcept {
+        const double clampedValue = std::max(value, 0.0);
+        record(static_cast<uint64_t>(std::llround(clampedValue * resolution)));
+        sum += clampedValue;
+    }
+
+    inline void clear() noexcept {
+        counts.clear();
+        numValues = 0;
+        sum = 0;
+        maxValue = 0;
+    }
+
+    inline Histogram& operator+=(const Histogram& other) noexcept {
+        AssertMsg(resolution == other.resolution, "Cannot merge histograms with different resolutions (" << resolution << ", " << other.resolution << ")!");
+        if (counts.size() < other.counts.size()) counts.resize(other.counts.size(), 0);
+        for (size_t i = 0; i < other.counts.size(); i++) {
+            counts[i] += other.counts[i];
+        }
+        numValues += other.numValues;
+        sum += other.sum;
+        maxValue = std::max(maxValue, other.maxValue);
+        return *this;
+    }
+
+    inline size_t size() const noexcept {
+        return numValues;
+    }
+
+    inline double mean() const noexcept {
+        return (numValues == 0) ? 0.0 : sum / static_cast<double>(numValues);
+    }
+
+    inline double max() const noexcept {
+        return maxValue / static_cast<double>(resolution);
+    }
+
+    // Smallest recorded value v (up to bucket precision) such that p percent of all values are <= v.
+    inline double percentile(const double p) const noexcept {
+        if (numValues == 0) return 0;
+        const uint64_t rank = std::max<uint64_t>(1, std::ceil(p / 100.0 * numValues));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(highestEquivalentValue(i), maxValue) / static_cast<double>(resolution);
+        }
+        return max();
+    }
+
+    inline static void printHeader(const std::string& title) noexcept {
+        std::cout << std::endl << std::left << std::setw(NameWidth) << title << std::right << std::setw(ValueWidth) << "Mean";
+        for (const double p : Percentiles) {
+            std::cout << std::setw(ValueWidth) << ("p" + String::prettyInt(p));
+        }
+        std::cout << std::setw(ValueWidth) << "Max" << std::endl;
+    }
+
+    // Times are recorded in microseconds, everything else is printed as a plain number.
+    inline void print(const std::string& name, const bool isTime) const noexcept {
+        std::cout << std::left << std::setw(NameWidth) << name << std::right;
+        if (isTime) {
+            std::cout << std::setw(ValueWidth + 1) << String::musToString(mean());
+            for (const double p : Percentiles) {
+                std::cout << std::setw(ValueWidth + 1) << String::musToString(percentile(p));
+            }
+            std::cout << std::setw(ValueWidth + 1) << String::musToString(max());
+        } else {
+            std::cout << std::setw(ValueWidth) << String::prettyDouble(mean());
+            for (const double p : Percentiles) {
+                std::cout << std::setw(ValueWidth) << String::prettyInt(static_cast<uint64_t>(percentile(p)));
+            }
+            std::cout << std::setw(ValueWidth) << String::prettyInt(static_cast<uint64_t>(max()));
+        }
+        std::cout << std::endl;
+    }
+
+private:
+    inline void record(const uint64_t value) noexcept {
+        const size_t index = bucketIndex(value);
+        if (index >= counts.size()) counts.resize(index + 1, 0);
+        counts[index]++;
+        numValues++;
+        maxValue = std::max(maxValue, value);
+    }
+
+    inline static size_t bucketIndex(const uint64_t value) noexcept {
+        if (value < SubBucketCount) return value;
+        // Shift such that (value >> shift) lies in [SubBucketHalf, SubBucketCount).
+        const size_t shift = 64 - __builtin_clzll(value) - SubBucketBits;
+        return SubBucketCount + (shift - 1) * SubBucketHalf + ((value >> shift) - SubBucketHalf);
+    }
+
+    inline static uint64_t highestEquivalentValue(const size_t index) noexcept {
+        if (index < SubBucketCount) return index;
+        const size_t shift = (index - SubBucketCount) / SubBucketHalf + 1;
+        const uint64_t subBucket = (index - SubBucketCount) % SubBucketHalf + SubBucketHalf;
+        return ((subBucket + 1) << shift) - 1;
+    }
+
+private:
+    uint64_t resolution;
+    std::vector<uint64_t> counts;
+    uint64_t numValues;
+    double sum;
+    uint64_t maxValue;
+};
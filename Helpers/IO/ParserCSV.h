@@ -11,6 +11,7 @@
 #include <future>
 #include <cassert>
 #include <cerrno>
+#include <limits>
 
 #include "File.h"
 #include "../Timer.h"
@@ -94,12 +95,21 @@ private:
     char* buffer;
     int dataBegin;
     int dataEnd;
+    long bytesLeft;
 
     char fileName[Error::MAX_FILE_NAME_LENGTH + 1];
     unsigned fileLine;
 
-    void init() {
+    int readBlock(char* destination, const int length) {
+        const int bytes = std::fread(destination, 1, std::min<long>(length, bytesLeft), file);
+        bytesLeft -= bytes;
+        return bytes;
+    }
+
+    void init(const long begin = 0, const long end = std::numeric_limits<long>::max()) {
         fileLine = 0;
+        bytesLeft = end - begin;
+        if (begin > 0) Ensure(std::fseek(file, begin, SEEK_SET) == 0, "cannot seek to byte " << begin << " in file: " << fileName);
 
         // Tell the std library that we want to do the buffering ourself.
         std::setvbuf(file, 0, _IONBF, 0);
@@ -112,13 +122,13 @@ private:
         }
 
         dataBegin = 0;
-        dataEnd = std::fread(buffer, 1, 2 * BLOCK_LENGTH, file);
+        dataEnd = readBlock(buffer, 2 * BLOCK_LENGTH);
 
         // Ignore UTF-8 BOM
         if (dataEnd >= 3 && buffer[0] == '\xEF' && buffer[1] == '\xBB' && buffer[2] == '\xBF') dataBegin = 3;
 
         if (dataEnd == 2 * BLOCK_LENGTH) {
-            bytesRead = std::async(std::launch::async, [=]()->int {return std::fread(buffer + 2 * BLOCK_LENGTH, 1, BLOCK_LENGTH, file);});
+            bytesRead = std::async(std::launch::async, [=]()->int {return readBlock(buffer + 2 * BLOCK_LENGTH, BLOCK_LENGTH);});
         }
     }
 
@@ -147,6 +157,12 @@ public:
         init();
     }
 
+    // Reads only the bytes in [begin, end), which should both be at the start of a line (see splitIntoLineChunks).
+    LineReader(const std::string& fileName, const long begin, const long end) : file(IO::openFile(fileName)) {
+        setFileName(fileName.c_str());
+        init(begin, end);
+    }
+
     void setFileName(const std::string& fileName) {
         setFileName(fileName.c_str());
     }
@@ -183,7 +199,7 @@ public:
             if (bytesRead.valid()) {
                 dataEnd += bytesRead.get();
                 std::memcpy(buffer + BLOCK_LENGTH, buffer + 2 * BLOCK_LENGTH, BLOCK_LENGTH);
-                bytesRead = std::async(std::launch::async, [=]()->int {return std::fread(buffer + 2 * BLOCK_LENGTH, 1, BLOCK_LENGTH, file);});
+                bytesRead = std::async(std::launch::async, [=]()->int {return readBlock(buffer + 2 * BLOCK_LENGTH, BLOCK_LENGTH);});
             }
         }
 
@@ -826,6 +842,16 @@ public:
         init();
     }
 
+    CSVReader(const std::string& fileName, const long begin, const long end) : in(fileName, begin, end) {
+        init();
+    }
+
+    // For readers of a chunk that does not contain the header.
+    void useHeaderOf(const CSVReader& other) {
+        columnNameAliases = other.columnNameAliases;
+        colOrder = other.colOrder;
+    }
+
     template<typename... T, typename = std::enable_if_t<sizeof...(T) == COLUMN_COUNT>>
     void readHeader(const T&... columnNames) {
         columnNameAliases = std::array<std::vector<std::string>, COLUMN_COUNT>{std::vector<std::string>{columnNames}...};
@@ -933,6 +959,32 @@ private:
 
 };
 
+// Splits a CSV file into the header line and numberOfChunks ranges of rows, such that every range starts at the
+// beginning of a line. Chunk i consists of the bytes in [result[i], result[i + 1]), the header of [0, result[0]).
+// Line breaks within quoted fields are not supported.
+inline std::vector<long> splitIntoLineChunks(const std::string& fileName, const size_t numberOfChunks) noexcept {
+    FILE* file = IO::openFile(fileName);
+    std::fseek(file, 0, SEEK_END);
+    const long fileSize = std::ftell(file);
+    const auto nextLineStart = [&](const long offset) {
+        if (offset >= fileSize) return fileSize;
+        std::fseek(file, offset, SEEK_SET);
+        long position = offset;
+        for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+            position++;
+            if (c == '\n') break;
+        }
+        return position;
+    };
+    std::vector<long> result(1, nextLineStart(0));
+    for (size_t i = 1; i < numberOfChunks; i++) {
+        result.emplace_back(std::max(result.back(), nextLineStart((fileSize * i) / numberOfChunks)));
+    }
+    result.emplace_back(fileSize);
+    std::fclose(file);
+    return result;
+}
+
 template<typename PARSE_CONTENT>
 inline void readFile(const std::string& fileName, const std::string& contentName, const PARSE_CONTENT& parseContent, const bool verbose = true) {
     if (verbose) std::cout << "Reading " << contentName << " from CSV file (" << fileName << ")..." << std::flush;
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../Assert.h"
+
+namespace IO {
+
+    //################################################# Unix Sockets ##################################################################//
+    inline sockaddr_un unixSocketAddress(const std::string& path) noexcept {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        Ensure(path.size() < sizeof(address.sun_path), "Socket path is too long: " << path);
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        return address;
+    }
+
+    // Creates a Unix domain stream socket listening at path. An existing socket file at path is replaced.
+    inline int listenUnixSocket(const std::string& path, const int backlog = 64) noexcept {
+        const sockaddr_un address = unixSocketAddress(path);
+        const int socketDescriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        Ensure(socketDescriptor != -1, "Cannot create socket: " << std::strerror(errno));
+        ::unlink(path.c_str());
+        Ensure(::bind(socketDescriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0, "Cannot bind socket " << path << ": " << std::strerror(errno));
+        Ensure(::listen(socketDescriptor, backlog) == 0, "Cannot listen on socket " << path << ": " << std::strerror(errno));
+        return socketDescriptor;
+    }
+
+    inline int connectUnixSocket(const std::string& path) noexcept {
+        const sockaddr_un address = unixSocketAddress(path);
+        const int socketDescriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        Ensure(socketDescriptor != -1, "Cannot create socket: " << std::strerror(errno));
+        Ensure(::connect(socketDescriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0, "Cannot connect to socket " << path << ": " << std::strerror(errno));
+        return socketDescriptor;
+    }
+
+    // Returns the previous file status flags, which can be restored with fcntl(fileDescriptor, F_SETFL, flags).
+    inline int setNonBlocking(const int fileDescriptor) noexcept {
+        const int flags = ::fcntl(fileDescriptor, F_GETFL);
+        Ensure(flags != -1, "Cannot access file descriptor " << fileDescriptor << ": " << std::strerror(errno));
+        Ensure(::fcntl(fileDescriptor, F_SETFL, flags | O_NONBLOCK) != -1, "Cannot make file descriptor " << fileDescriptor << " non-blocking: " << std::strerror(errno));
+        return flags;
+    }
+
+    // Writes as much of the buffer as a non-blocking descriptor accepts. Returns the number of bytes written, or -1 if
+    // the other side has closed the connection.
+    inline ssize_t writeSome(const int fileDescriptor, const char* data, const size_t size) noexcept {
+        while (true) {
+            ssize_t written = ::send(fileDescriptor, data, size, MSG_NOSIGNAL);
+            if (written < 0 && errno == ENOTSOCK) written = ::write(fileDescriptor, data, size);
+            if (written >= 0) return written;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            if (errno != EINTR) return -1;
+        }
+    }
+
+    // Writes the whole buffer. Returns false if the other side has closed the connection.
+    inline bool writeAll(const int fileDescriptor, const char* data, size_t size) noexcept {
+        while (size > 0) {
+            const ssize_t written = ::send(fileDescriptor, data, size, MSG_NOSIGNAL);
+            if (written < 0 && errno == ENOTSOCK) {
+                const ssize_t pipeWritten = ::write(fileDescriptor, data, size);
+                if (pipeWritten <= 0) return false;
+                data += pipeWritten;
+                size -= pipeWritten;
+                continue;
+            }
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            data += written;
+            size -= written;
+        }
+        return true;
+    }
+
+    inline bool writeAll(const int fileDescriptor, const std::string& data) noexcept {
+        return writeAll(fileDescriptor, data.data(), data.size());
+    }
+
+    //############################################## Socket Line Reader ###############################################################//
+    // Splits the bytes read from a file descriptor into lines. Incomplete lines are kept until the rest arrives.
+    class SocketLineReader {
+
+    public:
+        SocketLineReader(const int fileDescriptor = -1) :
+            fileDescriptor(fileDescriptor),
+            endOfFile(false) {
+        }
+
+        // Reads the currently available bytes (blocking only if none are available) and appends all complete lines.
+        // Returns false once the end of the file has been reached. On a non-blocking descriptor without available
+        // bytes, no lines are appended.
+        inline bool readLines(std::vector<std::string>& lines) noexcept {
+            char data[1 << 16];
+            ssize_t size = ::read(fileDescriptor, data, sizeof(data));
+            while (size < 0 && errno == EINTR) {
+                size = ::read(fileDescriptor, data, sizeof(data));
+            }
+            if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            if (size <= 0) {
+                endOfFile = true;
+                if (!buffer.empty()) lines.emplace_back(std::move(buffer));
+                buffer.clear();
+                return false;
+            }
+            size_t lineBegin = 0;
+            for (ssize_t i = 0; i < size; i++) {
+                if (data[i] != '\n') continue;
+                buffer.append(data + lineBegin, i - lineBegin);
+                if (!buffer.empty() && buffer.back() == '\r') buffer.pop_back();
+                lines.emplace_back(std::move(buffer));
+                buffer.clear();
+                lineBegin = i + 1;
+            }
+            buffer.append(data + lineBegin, size - lineBegin);
+            return true;
+        }
+
+        inline bool reachedEndOfFile() const noexcept {
+            return endOfFile;
+        }
+
+        inline int getFileDescriptor() const noexcept {
+            return fileDescriptor;
+        }
+
+    private:
+        int fileDescriptor;
+        std::string buffer;
+        bool endOfFile;
+
+    };
+
+}
@@ -7,6 +7,8 @@
 #include "../../Shell/Shell.h"
 using namespace Shell;
 
+#include "ParallelQueries.h"
+
 #include "../../Algorithms/RAPTOR/Bounded/BoundedMcRAPTOR.h"
 #include "../../Algorithms/RAPTOR/ULTRABounded/UBMHydRA.h"
 #include "../../Algorithms/RAPTOR/ULTRABounded/UBMRAPTOR.h"
@@ -22,42 +24,42 @@ using namespace Shell;
 #include "../../DataStructures/RAPTOR/Data.h"
 #include "../../DataStructures/TripBased/Data.h"
 
-class RunTransitiveMcRAPTORQueries : public ParameterizedCommand {
+class RunTransitiveMcRAPTORQueries : public ParallelQueryCommand {
 
 public:
     RunTransitiveMcRAPTORQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runTransitiveMcRAPTORQueries", "Runs the given number of random transitive McRAPTOR queries.") {
+        ParallelQueryCommand(shell, "runTransitiveMcRAPTORQueries", "Runs the given number of random transitive McRAPTOR queries.") {
         addParameter("RAPTOR input file");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
         RAPTOR::Data raptorData = RAPTOR::Data::FromBinary(getParameter("RAPTOR input file"));
         raptorData.useImplicitDepartureBufferTimes();
         raptorData.printInfo();
-        RAPTOR::McRAPTOR<true, true, RAPTOR::AggregateProfiler> algorithm(raptorData);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<StopQuery> queries = generateRandomStopQueries(raptorData.numberOfStops(), n);
 
-        double numJourneys = 0;
-        for (const StopQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::McRAPTOR<true, true, RAPTOR::AggregateProfiler>(raptorData);
+        }, [](auto& algorithm, const StopQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunMCRQueries : public ParameterizedCommand {
+class RunMCRQueries : public ParallelQueryCommand {
 
 public:
     RunMCRQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runMCRQueries", "Runs the given number of random MCR queries.") {
+        ParallelQueryCommand(shell, "runMCRQueries", "Runs the given number of random MCR queries.") {
         addParameter("RAPTOR input file");
         addParameter("CH data");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -65,29 +67,28 @@ public:
         raptorData.useImplicitDepartureBufferTimes();
         raptorData.printInfo();
         CH::CH ch(getParameter("CH data"));
-        RAPTOR::MCR<true, RAPTOR::AggregateProfiler> algorithm(raptorData, ch);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::MCR<true, RAPTOR::AggregateProfiler>(raptorData, ch);
+        }, [](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunULTRAMcRAPTORQueries : public ParameterizedCommand {
+class RunULTRAMcRAPTORQueries : public ParallelQueryCommand {
 
 public:
     RunULTRAMcRAPTORQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runULTRAMcRAPTORQueries", "Runs the given number of random ULTRA-McRAPTOR queries.") {
+        ParallelQueryCommand(shell, "runULTRAMcRAPTORQueries", "Runs the given number of random ULTRA-McRAPTOR queries.") {
         addParameter("RAPTOR input file");
         addParameter("CH data");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -95,59 +96,57 @@ public:
         raptorData.useImplicitDepartureBufferTimes();
         raptorData.printInfo();
         CH::CH ch(getParameter("CH data"));
-        RAPTOR::ULTRAMcRAPTOR<RAPTOR::AggregateProfiler> algorithm(raptorData, ch);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::ULTRAMcRAPTOR<RAPTOR::AggregateProfiler>(raptorData, ch);
+        }, [](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunULTRAMcTBQueries : public ParameterizedCommand {
+class RunULTRAMcTBQueries : public ParallelQueryCommand {
 
 public:
     RunULTRAMcTBQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runULTRAMcTBQueries", "Runs the given number of random ULTRA-McTB queries.") {
+        ParallelQueryCommand(shell, "runULTRAMcTBQueries", "Runs the given number of random ULTRA-McTB queries.") {
         addParameter("Trip-Based input file");
         addParameter("CH data");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
         TripBased::Data tripBasedData(getParameter("Trip-Based input file"));
         tripBasedData.printInfo();
         CH::CH ch(getParameter("CH data"));
-        TripBased::McQuery<TripBased::AggregateProfiler> algorithm(tripBasedData, ch);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return TripBased::McQuery<TripBased::AggregateProfiler>(tripBasedData, ch);
+        }, [](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunTransitiveBoundedMcRAPTORQueries : public ParameterizedCommand {
+class RunTransitiveBoundedMcRAPTORQueries : public ParallelQueryCommand {
 
 public:
     RunTransitiveBoundedMcRAPTORQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runTransitiveBoundedMcRAPTORQueries", "Runs the given number of random transitive Bounded McRAPTOR queries.") {
+        ParallelQueryCommand(shell, "runTransitiveBoundedMcRAPTORQueries", "Runs the given number of random transitive Bounded McRAPTOR queries.") {
         addParameter("RAPTOR input file");
         addParameter("Number of queries");
         addParameter("Arrival slack");
         addParameter("Trip slack");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -155,7 +154,6 @@ public:
         raptorData.useImplicitDepartureBufferTimes();
         raptorData.printInfo();
         const RAPTOR::Data reverseData = raptorData.reverseNetwork();
-        RAPTOR::BoundedMcRAPTOR<RAPTOR::AggregateProfiler> algorithm(raptorData, reverseData);
 
         const double arrivalSlack = getParameter<double>("Arrival slack");
         const double tripSlack = getParameter<double>("Trip slack");
@@ -163,26 +161,26 @@ public:
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<StopQuery> queries = generateRandomStopQueries(raptorData.numberOfStops(), n);
 
-        double numJourneys = 0;
-        for (const StopQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::BoundedMcRAPTOR<RAPTOR::AggregateProfiler>(raptorData, reverseData);
+        }, [&](auto& algorithm, const StopQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target, arrivalSlack, tripSlack);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunUBMRAPTORQueries : public ParameterizedCommand {
+class RunUBMRAPTORQueries : public ParallelQueryCommand {
 
 public:
     RunUBMRAPTORQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runUBMRAPTORQueries", "Runs the given number of random UBM-RAPTOR queries.") {
+        ParallelQueryCommand(shell, "runUBMRAPTORQueries", "Runs the given number of random UBM-RAPTOR queries.") {
         addParameter("RAPTOR input file");
         addParameter("CH data");
         addParameter("Number of queries");
         addParameter("Arrival slack");
         addParameter("Trip slack");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -191,7 +189,6 @@ public:
         raptorData.printInfo();
         const RAPTOR::Data reverseData = raptorData.reverseNetwork();
         CH::CH ch(getParameter("CH data"));
-        RAPTOR::UBMRAPTOR<RAPTOR::AggregateProfiler> algorithm(raptorData, reverseData, ch);
 
         const double arrivalSlack = getParameter<double>("Arrival slack");
         const double tripSlack = getParameter<double>("Trip slack");
@@ -199,21 +196,20 @@ public:
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::UBMRAPTOR<RAPTOR::AggregateProfiler>(raptorData, reverseData, ch);
+        }, [&](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target, arrivalSlack, tripSlack);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunUBMTBQueries : public ParameterizedCommand {
+class RunUBMTBQueries : public ParallelQueryCommand {
 
 public:
     RunUBMTBQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runUBMTBQueries", "Runs the given number of random UBM-TB queries.") {
+        ParallelQueryCommand(shell, "runUBMTBQueries", "Runs the given number of random UBM-TB queries.") {
         addParameter("Trip-Based input file");
         addParameter("Bounded forward Trip-Based input file");
         addParameter("Bounded backward Trip-Based input file");
@@ -221,6 +217,7 @@ public:
         addParameter("Number of queries");
         addParameter("Arrival slack");
         addParameter("Trip slack");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -231,7 +228,6 @@ public:
         TripBased::Data backwardBoundedData(getParameter("Bounded backward Trip-Based input file"));
         backwardBoundedData.printInfo();
         CH::CH ch(getParameter("CH data"));
-        TripBased::BoundedMcQuery<TripBased::AggregateProfiler> algorithm(tripBasedData, forwardBoundedData, backwardBoundedData, ch);
 
         const double arrivalSlack = getParameter<double>("Arrival slack");
         const double tripSlack = getParameter<double>("Trip slack");
@@ -239,21 +235,20 @@ public:
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return TripBased::BoundedMcQuery<TripBased::AggregateProfiler>(tripBasedData, forwardBoundedData, backwardBoundedData, ch);
+        }, [&](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target, arrivalSlack, tripSlack);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunUBMHydRAQueries : public ParameterizedCommand {
+class RunUBMHydRAQueries : public ParallelQueryCommand {
 
 public:
     RunUBMHydRAQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runUBMHydRAQueries", "Runs the given number of random UBM-HydRA queries.") {
+        ParallelQueryCommand(shell, "runUBMHydRAQueries", "Runs the given number of random UBM-HydRA queries.") {
         addParameter("Trip-Based input file");
         addParameter("Bounded forward Trip-Based input file");
         addParameter("Bounded backward Trip-Based input file");
@@ -261,6 +256,7 @@ public:
         addParameter("Number of queries");
         addParameter("Arrival slack");
         addParameter("Trip slack");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -272,7 +268,6 @@ public:
         backwardBoundedData.printInfo();
         const CH::CH ch(getParameter("CH data"));
 
-        RAPTOR::UBMHydRA<RAPTOR::AggregateProfiler> algorithm(tripBasedData, forwardBoundedData, backwardBoundedData, ch);
 
         const double arrivalSlack = getParameter<double>("Arrival slack");
         const double tripSlack = getParameter<double>("Trip slack");
@@ -280,13 +275,12 @@ public:
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::UBMHydRA<RAPTOR::AggregateProfiler>(tripBasedData, forwardBoundedData, backwardBoundedData, ch);
+        }, [&](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target, arrivalSlack, tripSlack);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
@@ -387,3 +381,86 @@ private:
         return false;
     }
 };
+
+class BenchmarkParetoBags : public ParameterizedCommand {
+
+public:
+    BenchmarkParetoBags(BasicShell& shell) :
+        ParameterizedCommand(shell, "benchmarkParetoBags", "Replays the bags recorded from random transitive McRAPTOR queries into RAPTOR::Bag and RAPTOR::ParetoBag.") {
+        addParameter("RAPTOR input file");
+        addParameter("Number of queries");
+        addParameter("Number of repetitions", "10");
+    }
+
+    virtual void execute() noexcept {
+        RAPTOR::Data raptorData = RAPTOR::Data::FromBinary(getParameter("RAPTOR input file"));
+        raptorData.useImplicitDepartureBufferTimes();
+        raptorData.printInfo();
+        RAPTOR::McRAPTOR<false, true, RAPTOR::NoProfiler> algorithm(raptorData);
+
+        const size_t n = getParameter<size_t>("Number of queries");
+        const size_t repetitions = getParameter<size_t>("Number of repetitions");
+        const std::vector<StopQuery> queries = generateRandomStopQueries(raptorData.numberOfStops(), n);
+
+        std::vector<Label> labels;
+        std::vector<size_t> bagBegin;
+        size_t maxBagSize = 0;
+        for (const StopQuery& query : queries) {
+            algorithm.run(query.source, query.departureTime);
+            for (const StopId stop : raptorData.stops()) {
+                const std::vector<RAPTOR::WalkingParetoLabel> results = algorithm.getResults(stop);
+                if (results.empty()) continue;
+                bagBegin.emplace_back(labels.size());
+                for (const RAPTOR::WalkingParetoLabel& result : results) {
+                    labels.emplace_back(result.arrivalTime, result.walkingDistance);
+                }
+                maxBagSize = std::max(maxBagSize, results.size());
+            }
+        }
+        bagBegin.emplace_back(labels.size());
+        std::cout << "Recorded " << String::prettyInt(bagBegin.size() - 1) << " bags with " << String::prettyInt(labels.size()) << " labels (at most " << maxBagSize << " per bag)" << std::endl;
+
+        RAPTOR::Bag<Label> bag;
+        const auto [bagTime, bagSize] = replay(labels, bagBegin, repetitions, bag);
+        RAPTOR::ParetoBag paretoBag;
+        const auto [paretoBagTime, paretoBagSize] = replay(labels, bagBegin, repetitions, paretoBag);
+        if (bagSize != paretoBagSize) {
+            std::cout << "Mismatch: RAPTOR::Bag kept " << String::prettyInt(bagSize) << " labels, but RAPTOR::ParetoBag kept " << String::prettyInt(paretoBagSize) << std::endl;
+        }
+        std::cout << "RAPTOR::Bag:       " << String::musToString(bagTime) << std::endl;
+        std::cout << "RAPTOR::ParetoBag: " << String::musToString(paretoBagTime) << std::endl;
+    }
+
+private:
+    struct Label {
+        Label(const int arrivalTime = never, const int walkingDistance = INFTY) :
+            arrivalTime(arrivalTime),
+            walkingDistance(walkingDistance) {
+        }
+
+        inline bool dominates(const Label& other) const noexcept {
+            return arrivalTime <= other.arrivalTime && walkingDistance <= other.walkingDistance;
+        }
+
+        int arrivalTime;
+        int walkingDistance;
+    };
+
+    // Every recorded label is first tested against its bag (as the target pruning does), and then merged into it.
+    template<typename BAG>
+    inline std::pair<double, size_t> replay(const std::vector<Label>& labels, const std::vector<size_t>& bagBegin, const size_t repetitions, BAG& bag) const noexcept {
+        size_t keptLabels = 0;
+        Timer timer;
+        for (size_t repetition = 0; repetition < repetitions; repetition++) {
+            for (size_t i = 0; i + 1 < bagBegin.size(); i++) {
+                bag.clear();
+                for (size_t j = bagBegin[i]; j < bagBegin[i + 1]; j++) {
+                    if (bag.dominates(labels[j])) continue;
+                    bag.merge(labels[j]);
+                }
+                keptLabels += bag.size();
+            }
+        }
+        return std::make_pair(timer.elapsedMicroseconds(), keptLabels);
+    }
+};
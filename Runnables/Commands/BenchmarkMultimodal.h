@@ -7,6 +7,8 @@
 #include "../../Shell/Shell.h"
 using namespace Shell;
 
+#include "ParallelQueries.h"
+
 #include "../../Algorithms/RAPTOR/InitialTransfers.h"
 #include "../../Algorithms/RAPTOR/MultimodalMCR.h"
 #include "../../Algorithms/RAPTOR/MultimodalULTRAMcRAPTOR.h"
@@ -20,14 +22,15 @@ using namespace Shell;
 #include "../../DataStructures/TripBased/Data.h"
 #include "../../DataStructures/TripBased/MultimodalData.h"
 
-class RunMultimodalMCRQueries : public ParameterizedCommand {
+class RunMultimodalMCRQueries : public ParallelQueryCommand {
 
 public:
     RunMultimodalMCRQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runMultimodalMCRQueries", "Runs the given number of random multimodal MCR queries.") {
+        ParallelQueryCommand(shell, "runMultimodalMCRQueries", "Runs the given number of random multimodal MCR queries.") {
         addParameter("RAPTOR input file");
         addParameter("CH directory");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -55,29 +58,28 @@ private:
         for (const size_t mode : raptorData.modes) {
             chData.emplace_back(chDirectory + RAPTOR::TransferModeNames[mode] + "CH");
         }
-        RAPTOR::MultimodalMCR<true, NUM_MODES, RAPTOR::AggregateProfiler> algorithm(raptorData, chData);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(chData[0].numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::MultimodalMCR<true, NUM_MODES, RAPTOR::AggregateProfiler>(raptorData, chData);
+        }, [](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunMultimodalULTRAMcRAPTORQueries : public ParameterizedCommand {
+class RunMultimodalULTRAMcRAPTORQueries : public ParallelQueryCommand {
 
 public:
     RunMultimodalULTRAMcRAPTORQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runMultimodalULTRAMcRAPTORQueries", "Runs the given number of random multimodal ULTRA-McRAPTOR queries.") {
+        ParallelQueryCommand(shell, "runMultimodalULTRAMcRAPTORQueries", "Runs the given number of random multimodal ULTRA-McRAPTOR queries.") {
         addParameter("RAPTOR input file");
         addParameter("CH directory");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -105,31 +107,30 @@ private:
         for (const size_t mode : raptorData.modes) {
             chData.emplace_back(chDirectory + RAPTOR::TransferModeNames[mode] + "CH");
         }
-        RAPTOR::MultimodalULTRAMcRAPTOR<NUM_MODES, RAPTOR::AggregateProfiler> algorithm(raptorData, chData);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(chData[0].numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::MultimodalULTRAMcRAPTOR<NUM_MODES, RAPTOR::AggregateProfiler>(raptorData, chData);
+        }, [](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunMultimodalUBMRAPTORQueries : public ParameterizedCommand {
+class RunMultimodalUBMRAPTORQueries : public ParallelQueryCommand {
 
 public:
     RunMultimodalUBMRAPTORQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runMultimodalUBMRAPTORQueries", "Runs the given number of random multimodal UBM-RAPTOR queries.") {
+        ParallelQueryCommand(shell, "runMultimodalUBMRAPTORQueries", "Runs the given number of random multimodal UBM-RAPTOR queries.") {
         addParameter("RAPTOR input file");
         addParameter("CH directory");
         addParameter("Number of queries");
         addParameter("Arrival slack");
         addParameter("Trip slack");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -161,7 +162,6 @@ private:
         }
         RAPTOR::TransferGraph backwardTransitiveGraph = raptorData.raptorData.transferGraph;
         backwardTransitiveGraph.revert();
-        RAPTOR::MultimodalUBMRAPTOR<NUM_MODES, RAPTOR::AggregateProfiler> algorithm(raptorData, pruningData, reversePruningData, backwardTransitiveGraph, chData);
 
         const double arrivalSlack = getParameter<double>("Arrival slack");
         const double tripSlack = getParameter<double>("Trip slack");
@@ -169,22 +169,21 @@ private:
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(chData[0].numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::MultimodalUBMRAPTOR<NUM_MODES, RAPTOR::AggregateProfiler>(raptorData, pruningData, reversePruningData, backwardTransitiveGraph, chData);
+        }, [&](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target, arrivalSlack, tripSlack);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
 
     }
 };
 
-class RunMultimodalUBMHydRAQueries : public ParameterizedCommand {
+class RunMultimodalUBMHydRAQueries : public ParallelQueryCommand {
 
 public:
     RunMultimodalUBMHydRAQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runMultimodalUBMHydRAQueries", "Runs the given number of random multimodal UBM-HydRA queries.") {
+        ParallelQueryCommand(shell, "runMultimodalUBMHydRAQueries", "Runs the given number of random multimodal UBM-HydRA queries.") {
         addParameter("Trip-Based input file");
         addParameter("Bounded forward Trip-Based input file");
         addParameter("Bounded backward Trip-Based input file");
@@ -192,6 +191,7 @@ public:
         addParameter("Number of queries");
         addParameter("Arrival slack");
         addParameter("Trip slack");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -228,7 +228,6 @@ private:
         }
         RAPTOR::TransferGraph backwardTransitiveGraph = tripBasedData.tripData.raptorData.transferGraph;
         backwardTransitiveGraph.revert();
-        RAPTOR::MultimodalUBMHydRA<NUM_MODES, RAPTOR::AggregateProfiler> algorithm(tripBasedData, forwardPruningData, backwardPruningData, backwardTransitiveGraph, chData);
 
         const double arrivalSlack = getParameter<double>("Arrival slack");
         const double tripSlack = getParameter<double>("Trip slack");
@@ -236,12 +235,11 @@ private:
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(chData[0].numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::MultimodalUBMHydRA<NUM_MODES, RAPTOR::AggregateProfiler>(tripBasedData, forwardPruningData, backwardPruningData, backwardTransitiveGraph, chData);
+        }, [&](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target, arrivalSlack, tripSlack);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
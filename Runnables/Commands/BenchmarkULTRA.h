@@ -7,13 +7,17 @@
 #include "../../Shell/Shell.h"
 using namespace Shell;
 
+#include "ParallelQueries.h"
+
 #include "../../Algorithms/CSA/CSA.h"
 #include "../../Algorithms/CSA/DijkstraCSA.h"
 #include "../../Algorithms/CSA/HLCSA.h"
 #include "../../Algorithms/CSA/ULTRACSA.h"
+#include "../../Algorithms/CSA/ULTRAProfileCSA.h"
 #include "../../Algorithms/RAPTOR/HLRAPTOR.h"
 #include "../../Algorithms/RAPTOR/DijkstraRAPTOR.h"
 #include "../../Algorithms/RAPTOR/InitialTransfers.h"
+#include "../../Algorithms/RAPTOR/McRAPTOR.h"
 #include "../../Algorithms/RAPTOR/RAPTOR.h"
 #include "../../Algorithms/RAPTOR/ULTRARAPTOR.h"
 #include "../../Algorithms/TripBased/Query/Query.h"
@@ -24,42 +28,44 @@ using namespace Shell;
 #include "../../DataStructures/RAPTOR/Data.h"
 #include "../../DataStructures/TripBased/Data.h"
 
-class RunTransitiveCSAQueries : public ParameterizedCommand {
+class RunTransitiveCSAQueries : public ParallelQueryCommand {
 
 public:
     RunTransitiveCSAQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runTransitiveCSAQueries", "Runs the given number of random transitive CSA queries.") {
+        ParallelQueryCommand(shell, "runTransitiveCSAQueries", "Runs the given number of random transitive CSA queries.") {
         addParameter("CSA input file");
         addParameter("Number of queries");
         addParameter("Target pruning?");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
         CSA::Data csaData = CSA::Data::FromBinary(getParameter("CSA input file"));
         csaData.sortConnectionsAscending();
         csaData.printInfo();
-        CSA::CSA<true, CSA::AggregateProfiler> algorithm(csaData);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<StopQuery> queries = generateRandomStopQueries(csaData.numberOfStops(), n);
 
         const bool targetPruning = getParameter<bool>("Target pruning?");
 
-        for (const StopQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return CSA::CSA<true, CSA::AggregateProfiler>(csaData);
+        }, [&](auto& algorithm, const StopQuery& query) {
             algorithm.run(query.source, query.departureTime, targetPruning ? query.target : noStop);
-        }
-        algorithm.getProfiler().printStatistics();
+        });
     }
 };
 
-class RunDijkstraCSAQueries : public ParameterizedCommand {
+class RunDijkstraCSAQueries : public ParallelQueryCommand {
 
 public:
     RunDijkstraCSAQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runDijkstraCSAQueries", "Runs the given number of random Dijkstra-CSA queries.") {
+        ParallelQueryCommand(shell, "runDijkstraCSAQueries", "Runs the given number of random Dijkstra-CSA queries.") {
         addParameter("CSA input file");
         addParameter("CH data");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -67,27 +73,28 @@ public:
         csaData.sortConnectionsAscending();
         csaData.printInfo();
         CH::CH ch(getParameter("CH data"));
-        CSA::DijkstraCSA<RAPTOR::CoreCHInitialTransfers, true, CSA::AggregateProfiler> algorithm(csaData, ch);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
 
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return CSA::DijkstraCSA<RAPTOR::CoreCHInitialTransfers, true, CSA::AggregateProfiler>(csaData, ch);
+        }, [](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-        }
-        algorithm.getProfiler().printStatistics();
+        });
     }
 };
 
-class RunHLCSAQueries : public ParameterizedCommand {
+class RunHLCSAQueries : public ParallelQueryCommand {
 
 public:
     RunHLCSAQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runHLCSAQueries", "Runs the given number of random HL-CSA queries.") {
+        ParallelQueryCommand(shell, "runHLCSAQueries", "Runs the given number of random HL-CSA queries.") {
         addParameter("CSA input file");
         addParameter("Out-hub file");
         addParameter("In-hub file");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -96,23 +103,51 @@ public:
         csaData.printInfo();
         const TransferGraph outHubs(getParameter("Out-hub file"));
         const TransferGraph inHubs(getParameter("In-hub file"));
-        CSA::HLCSA<CSA::AggregateProfiler> algorithm(csaData, outHubs, inHubs);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(inHubs.numVertices(), n);
 
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return CSA::HLCSA<CSA::AggregateProfiler>(csaData, outHubs, inHubs);
+        }, [](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-        }
-        algorithm.getProfiler().printStatistics();
+        });
     }
 };
 
-class RunULTRACSAQueries : public ParameterizedCommand {
+class RunULTRACSAQueries : public ParallelQueryCommand {
 
 public:
     RunULTRACSAQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runULTRACSAQueries", "Runs the given number of random ULTRA-CSA queries.") {
+        ParallelQueryCommand(shell, "runULTRACSAQueries", "Runs the given number of random ULTRA-CSA queries.") {
+        addParameter("CSA input file");
+        addParameter("CH data");
+        addParameter("Number of queries");
+        addParallelQueryParameters();
+    }
+
+    virtual void execute() noexcept {
+        CSA::Data csaData = CSA::Data::FromBinary(getParameter("CSA input file"));
+        csaData.sortConnectionsAscending();
+        csaData.printInfo();
+        CH::CH ch(getParameter("CH data"));
+
+        const size_t n = getParameter<size_t>("Number of queries");
+        const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
+
+        runQueries(queries, [&]() {
+            return CSA::ULTRACSA<true, CSA::AggregateProfiler>(csaData, ch);
+        }, [](auto& algorithm, const VertexQuery& query) {
+            algorithm.run(query.source, query.departureTime, query.target);
+        });
+    }
+};
+
+class BenchmarkCSAQueryReset : public ParameterizedCommand {
+
+public:
+    BenchmarkCSAQueryReset(BasicShell& shell) :
+        ParameterizedCommand(shell, "benchmarkCSAQueryReset", "Compares the touched-label reset of ULTRA-CSA with a full reset of all stop and trip labels.") {
         addParameter("CSA input file");
         addParameter("CH data");
         addParameter("Number of queries");
@@ -128,50 +163,337 @@ public:
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
 
+        struct ParentLabel {
+            Vertex parent;
+            bool reachedByTransfer;
+            TripId tripId;
+        };
+        std::vector<int> arrivalTime(csaData.numberOfStops() + 1, never);
+        std::vector<ConnectionId> tripReached(csaData.numberOfTrips(), noConnection);
+        std::vector<ParentLabel> parentLabel(csaData.numberOfStops() + 1, ParentLabel{noVertex, false, noTripId});
+
+        Timer timer;
+        double fullResetTime = 0;
         for (const VertexQuery& query : queries) {
             algorithm.run(query.source, query.departureTime, query.target);
+            timer.restart();
+            Vector::fill(arrivalTime, never);
+            Vector::fill(tripReached, noConnection);
+            Vector::fill(parentLabel, ParentLabel{noVertex, false, noTripId});
+            fullResetTime += timer.elapsedMicroseconds();
+        }
+        algorithm.getProfiler().printStatistics();
+        std::cout << std::endl;
+        std::cout << "Touched-label reset: " << String::musToString(algorithm.getProfiler().getPhaseTime(CSA::PHASE_CLEAR)) << std::endl;
+        std::cout << "Full reset: " << String::musToString(fullResetTime / n) << std::endl;
+    }
+};
+
+class RunULTRAProfileCSAQueries : public ParameterizedCommand {
+
+public:
+    RunULTRAProfileCSAQueries(BasicShell& shell) :
+        ParameterizedCommand(shell, "runULTRAProfileCSAQueries", "Compares random ULTRA-pCSA profile queries with one ULTRA-CSA query per departure time step.") {
+        addParameter("CSA input file");
+        addParameter("CH data");
+        addParameter("Number of queries");
+        addParameter("Start time", "08:00:00");
+        addParameter("End time", "10:00:00");
+        addParameter("Departure time step", "60");
+    }
+
+    virtual void execute() noexcept {
+        const size_t n = getParameter<size_t>("Number of queries");
+        const int startTime = String::parseSeconds(getParameter("Start time"));
+        const int endTime = String::parseSeconds(getParameter("End time"));
+        const int step = getParameter<int>("Departure time step");
+        if (n == 0) {
+            shell.error("The number of queries must be positive!");
+            return;
         }
+        if (step <= 0) {
+            shell.error("The departure time step must be positive!");
+            return;
+        }
+        if (startTime > endTime) {
+            shell.error("The start time must not be after the end time!");
+            return;
+        }
+
+        CSA::Data csaData = CSA::Data::FromBinary(getParameter("CSA input file"));
+        csaData.sortConnectionsAscending();
+        csaData.printInfo();
+        CH::CH ch(getParameter("CH data"));
+        CSA::ULTRAProfileCSA<CSA::AggregateProfiler> profileAlgorithm(csaData, ch);
+        CSA::ULTRACSA<false, CSA::AggregateProfiler> algorithm(csaData, ch);
+
+        const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
+
+        Timer timer;
+        double profileTime = 0;
+        double repeatedTime = 0;
+        size_t profileSize = 0;
+        size_t numberOfDepartureTimes = 0;
+        size_t mismatches = 0;
+        for (const VertexQuery& query : queries) {
+            timer.restart();
+            profileAlgorithm.run(query.source, startTime, endTime, query.target);
+            profileTime += timer.elapsedMicroseconds();
+            profileSize += profileAlgorithm.getProfile().size();
+            for (int departureTime = startTime; departureTime <= endTime; departureTime += step) {
+                timer.restart();
+                algorithm.run(query.source, departureTime, query.target);
+                repeatedTime += timer.elapsedMicroseconds();
+                numberOfDepartureTimes++;
+                if (algorithm.getEarliestArrivalTime(query.target) == profileAlgorithm.getEarliestArrivalTime(departureTime)) continue;
+                mismatches++;
+                std::cout << "Mismatch at " << String::secToString(departureTime) << " for query " << query;
+                std::cout << "   ULTRA-CSA: " << algorithm.getEarliestArrivalTime(query.target) << ", ULTRA-pCSA: " << profileAlgorithm.getEarliestArrivalTime(departureTime) << std::endl;
+            }
+        }
+        std::cout << "ULTRA-pCSA:" << std::endl;
+        profileAlgorithm.getProfiler().printStatistics();
+        std::cout << "ULTRA-CSA:" << std::endl;
         algorithm.getProfiler().printStatistics();
+        std::cout << std::endl;
+        std::cout << "Mismatches: " << String::prettyInt(mismatches) << " of " << String::prettyInt(numberOfDepartureTimes) << " departure times" << std::endl;
+        std::cout << "Avg. profile size: " << String::prettyDouble(profileSize / double(n)) << std::endl;
+        std::cout << "Avg. profile query time: " << String::musToString(profileTime / n) << std::endl;
+        std::cout << "Avg. time of " << String::prettyInt(numberOfDepartureTimes / n) << " ULTRA-CSA queries: " << String::musToString(repeatedTime / n) << std::endl;
     }
 };
 
-class RunTransitiveRAPTORQueries : public ParameterizedCommand {
+class RunTransitiveRAPTORQueries : public ParallelQueryCommand {
 
 public:
     RunTransitiveRAPTORQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runTransitiveRAPTORQueries", "Runs the given number of random transitive RAPTOR queries.") {
+        ParallelQueryCommand(shell, "runTransitiveRAPTORQueries", "Runs the given number of random transitive RAPTOR queries.") {
         addParameter("RAPTOR input file");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
         RAPTOR::Data raptorData = RAPTOR::Data::FromBinary(getParameter("RAPTOR input file"));
         raptorData.useImplicitDepartureBufferTimes();
         raptorData.printInfo();
-        RAPTOR::RAPTOR<true, RAPTOR::AggregateProfiler, true, false> algorithm(raptorData);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<StopQuery> queries = generateRandomStopQueries(raptorData.numberOfStops(), n);
 
-        double numJourneys = 0;
-        for (const StopQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::RAPTOR<true, RAPTOR::AggregateProfiler, true, false>(raptorData);
+        }, [](auto& algorithm, const StopQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
+            return algorithm.getJourneys().size();
+        });
+
+    }
+};
+
+class ValidateTransitiveRAPTORQueries : public ParameterizedCommand {
+
+public:
+    ValidateTransitiveRAPTORQueries(BasicShell& shell) :
+        ParameterizedCommand(shell, "validateTransitiveRAPTORQueries", "Compares RAPTOR queries with lazily reset labels to queries that reset all labels eagerly.") {
+        addParameter("RAPTOR input file");
+        addParameter("Number of queries");
+    }
+
+    virtual void execute() noexcept {
+        RAPTOR::Data raptorData = RAPTOR::Data::FromBinary(getParameter("RAPTOR input file"));
+        raptorData.useImplicitDepartureBufferTimes();
+        raptorData.printInfo();
+
+        const size_t n = getParameter<size_t>("Number of queries");
+        const std::vector<StopQuery> queries = generateRandomStopQueries(raptorData.numberOfStops(), n);
+
+        std::cout << "Combined route and transfer entries:" << std::endl;
+        validate<RAPTOR::RAPTOR<true, RAPTOR::NoProfiler, true, false, false, true>, RAPTOR::RAPTOR<true, RAPTOR::NoProfiler, true, false, false, false>>(raptorData, queries);
+        std::cout << "Separate route and transfer entries:" << std::endl;
+        validate<RAPTOR::RAPTOR<true, RAPTOR::NoProfiler, true, false, true, true>, RAPTOR::RAPTOR<true, RAPTOR::NoProfiler, true, false, true, false>>(raptorData, queries);
+    }
+
+private:
+    template<typename LAZY_ALGORITHM, typename EAGER_ALGORITHM>
+    inline void validate(const RAPTOR::Data& raptorData, const std::vector<StopQuery>& queries) const noexcept {
+        LAZY_ALGORITHM lazyAlgorithm(raptorData);
+        EAGER_ALGORITHM eagerAlgorithm(raptorData);
+        size_t mismatches = 0;
+        for (const StopQuery& query : queries) {
+            lazyAlgorithm.run(query.source, query.departureTime, query.target);
+            eagerAlgorithm.run(query.source, query.departureTime, query.target);
+            const std::vector<RAPTOR::ArrivalLabel> lazyArrivals = lazyAlgorithm.getArrivals();
+            const std::vector<RAPTOR::ArrivalLabel> eagerArrivals = eagerAlgorithm.getArrivals();
+            const std::vector<RAPTOR::Journey> lazyJourneys = lazyAlgorithm.getJourneys();
+            const std::vector<RAPTOR::Journey> eagerJourneys = eagerAlgorithm.getJourneys();
+            bool equal = (lazyArrivals == eagerArrivals) && (lazyJourneys.size() == eagerJourneys.size());
+            for (size_t i = 0; equal && i < lazyJourneys.size(); i++) {
+                equal = (lazyJourneys[i].size() == eagerJourneys[i].size());
+                for (size_t j = 0; equal && j < lazyJourneys[i].size(); j++) {
+                    equal = (lazyJourneys[i][j].from == eagerJourneys[i][j].from) && (lazyJourneys[i][j].to == eagerJourneys[i][j].to) && (lazyJourneys[i][j].departureTime == eagerJourneys[i][j].departureTime) && (lazyJourneys[i][j].arrivalTime == eagerJourneys[i][j].arrivalTime);
+                }
+            }
+            if (equal) continue;
+            mismatches++;
+            std::cout << "Mismatch for query " << query;
         }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+        std::cout << "Mismatches: " << String::prettyInt(mismatches) << " of " << String::prettyInt(queries.size()) << " queries" << std::endl;
+    }
+};
+
+class BenchmarkRouteScans : public ParameterizedCommand {
+
+public:
+    BenchmarkRouteScans(BasicShell& shell) :
+        ParameterizedCommand(shell, "benchmarkRouteScans", "Measures the route scan time per route segment of random transitive RAPTOR and McRAPTOR queries, and compares the trip searches on the departure columns to scans of the stop event rows.") {
+        addParameter("RAPTOR input file");
+        addParameter("Number of queries");
+    }
+
+    virtual void execute() noexcept {
+        RAPTOR::Data raptorData = RAPTOR::Data::FromBinary(getParameter("RAPTOR input file"));
+        raptorData.useImplicitDepartureBufferTimes();
+        raptorData.printInfo();
+
+        const size_t n = getParameter<size_t>("Number of queries");
+        const std::vector<StopQuery> queries = generateRandomStopQueries(raptorData.numberOfStops(), n);
+
+        RAPTOR::RAPTOR<true, RAPTOR::AggregateProfiler, true, false> raptor(raptorData);
+        for (const StopQuery& query : queries) {
+            raptor.run(query.source, query.departureTime, query.target);
+        }
+        printScanTime("RAPTOR", raptor.getProfiler());
+        RAPTOR::McRAPTOR<true, true, RAPTOR::AggregateProfiler> mcRaptor(raptorData);
+        for (const StopQuery& query : queries) {
+            mcRaptor.run(query.source, query.departureTime, query.target);
+        }
+        printScanTime("McRAPTOR", mcRaptor.getProfiler());
+
+        // Every route is scanned from its first stop for the departure time of every query, as if all stops of the
+        // route had been reached at that time.
+        size_t segments = 0;
+        for (const RouteId route : raptorData.routes()) {
+            segments += raptorData.numberOfStopsInRoute(route) - 1;
+        }
+        segments *= n;
+        size_t rowChecksum = 0;
+        size_t columnChecksum = 0;
+        Timer timer;
+        for (const StopQuery& query : queries) {
+            for (const RouteId route : raptorData.routes()) {
+                rowChecksum += scanRowsBackward(raptorData, route, query.departureTime);
+            }
+        }
+        const double rowBackwardTime = timer.elapsedMicroseconds();
+        timer.restart();
+        for (const StopQuery& query : queries) {
+            for (const RouteId route : raptorData.routes()) {
+                columnChecksum += scanColumnsBackward(raptorData, route, query.departureTime);
+            }
+        }
+        const double columnBackwardTime = timer.elapsedMicroseconds();
+        timer.restart();
+        for (const StopQuery& query : queries) {
+            for (const RouteId route : raptorData.routes()) {
+                rowChecksum += scanRowsForward(raptorData, route, query.departureTime);
+            }
+        }
+        const double rowForwardTime = timer.elapsedMicroseconds();
+        timer.restart();
+        for (const StopQuery& query : queries) {
+            for (const RouteId route : raptorData.routes()) {
+                columnChecksum += scanColumnsForward(raptorData, route, query.departureTime);
+            }
+        }
+        const double columnForwardTime = timer.elapsedMicroseconds();
+        if (rowChecksum != columnChecksum) {
+            std::cout << "Mismatch: the row scans found trips with checksum " << rowChecksum << ", but the column searches found " << columnChecksum << std::endl;
+        }
+        std::cout << "Replayed " << String::prettyInt(segments) << " route segments" << std::endl;
+        std::cout << "Backward, stop event rows:  " << String::prettyDouble(1000 * rowBackwardTime / segments) << "ns per segment" << std::endl;
+        std::cout << "Backward, departure column: " << String::prettyDouble(1000 * columnBackwardTime / segments) << "ns per segment" << std::endl;
+        std::cout << "Forward, stop event rows:   " << String::prettyDouble(1000 * rowForwardTime / segments) << "ns per segment" << std::endl;
+        std::cout << "Forward, departure column:  " << String::prettyDouble(1000 * columnForwardTime / segments) << "ns per segment" << std::endl;
+    }
+
+private:
+    inline void printScanTime(const std::string& name, const RAPTOR::AggregateProfiler& profiler) const noexcept {
+        const double scanTime = profiler.getPhaseTime(RAPTOR::PHASE_SCAN);
+        const double segments = profiler.getMetric(RAPTOR::METRIC_ROUTE_SEGMENTS);
+        std::cout << name << ": " << String::musToString(scanTime) << " route scan time, " << String::prettyDouble(segments, 0) << " route segments, " << String::prettyDouble(1000 * scanTime / segments) << "ns per segment" << std::endl;
+    }
+
+    // The trip scans below mirror the route scans of RAPTOR (backward) and McRAPTOR (forward) and sum up the arrival
+    // times of the trips they find.
+    inline size_t scanRowsBackward(const RAPTOR::Data& raptorData, const RouteId route, const int time) const noexcept {
+        const size_t tripSize = raptorData.numberOfStopsInRoute(route);
+        const RAPTOR::StopEvent* firstTrip = raptorData.firstTripOfRoute(route);
+        const RAPTOR::StopEvent* trip = raptorData.lastTripOfRoute(route);
+        size_t checksum = 0;
+        for (size_t stopIndex = 0; stopIndex + 1 < tripSize; stopIndex++) {
+            while ((trip > firstTrip) && ((trip - tripSize + stopIndex)->departureTime >= time)) {
+                trip -= tripSize;
+            }
+            checksum += trip[stopIndex + 1].arrivalTime;
+        }
+        return checksum;
+    }
+
+    inline size_t scanColumnsBackward(const RAPTOR::Data& raptorData, const RouteId route, const int time) const noexcept {
+        const size_t tripSize = raptorData.numberOfStopsInRoute(route);
+        const size_t numberOfTrips = raptorData.numberOfTripsInRoute(route);
+        const RAPTOR::StopEvent* firstTrip = raptorData.firstTripOfRoute(route);
+        const int* departureTimes = raptorData.departureTimesOfRoute(route);
+        size_t tripIndex = numberOfTrips - 1;
+        size_t checksum = 0;
+        for (size_t stopIndex = 0; stopIndex + 1 < tripSize; stopIndex++) {
+            tripIndex = RAPTOR::findEarliestTripBackward(departureTimes + (stopIndex * numberOfTrips), tripIndex, time);
+            checksum += firstTrip[(tripIndex * tripSize) + stopIndex + 1].arrivalTime;
+        }
+        return checksum;
+    }
+
+    inline size_t scanRowsForward(const RAPTOR::Data& raptorData, const RouteId route, const int time) const noexcept {
+        const size_t tripSize = raptorData.numberOfStopsInRoute(route);
+        const RAPTOR::StopEvent* firstTrip = raptorData.firstTripOfRoute(route);
+        const RAPTOR::StopEvent* lastTrip = raptorData.lastTripOfRoute(route);
+        size_t checksum = 0;
+        for (size_t stopIndex = 0; stopIndex + 1 < tripSize; stopIndex++) {
+            const RAPTOR::StopEvent* trip = firstTrip;
+            while ((trip < lastTrip) && (trip[stopIndex].departureTime < time)) {
+                trip += tripSize;
+            }
+            if (trip[stopIndex].departureTime < time) continue;
+            checksum += trip[stopIndex + 1].arrivalTime;
+        }
+        return checksum;
+    }
 
+    inline size_t scanColumnsForward(const RAPTOR::Data& raptorData, const RouteId route, const int time) const noexcept {
+        const size_t tripSize = raptorData.numberOfStopsInRoute(route);
+        const size_t numberOfTrips = raptorData.numberOfTripsInRoute(route);
+        const RAPTOR::StopEvent* firstTrip = raptorData.firstTripOfRoute(route);
+        const int* departureTimes = raptorData.departureTimesOfRoute(route);
+        size_t checksum = 0;
+        for (size_t stopIndex = 0; stopIndex + 1 < tripSize; stopIndex++) {
+            const size_t tripIndex = RAPTOR::findEarliestTripForward(departureTimes + (stopIndex * numberOfTrips), 0, numberOfTrips, time);
+            if (tripIndex == numberOfTrips) continue;
+            checksum += firstTrip[(tripIndex * tripSize) + stopIndex + 1].arrivalTime;
+        }
+        return checksum;
     }
 };
 
-class RunDijkstraRAPTORQueries : public ParameterizedCommand {
+class RunDijkstraRAPTORQueries : public ParallelQueryCommand {
 
 public:
     RunDijkstraRAPTORQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runDijkstraRAPTORQueries", "Runs the given number of random Dijkstra RAPTOR queries.") {
+        ParallelQueryCommand(shell, "runDijkstraRAPTORQueries", "Runs the given number of random Dijkstra RAPTOR queries.") {
         addParameter("RAPTOR input file");
         addParameter("CH data");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -179,30 +501,29 @@ public:
         raptorData.useImplicitDepartureBufferTimes();
         raptorData.printInfo();
         CH::CH ch(getParameter("CH data"));
-        RAPTOR::DijkstraRAPTOR<RAPTOR::CoreCHInitialTransfers, RAPTOR::AggregateProfiler, true, false> algorithm(raptorData, ch);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::DijkstraRAPTOR<RAPTOR::CoreCHInitialTransfers, RAPTOR::AggregateProfiler, true, false>(raptorData, ch);
+        }, [](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunHLRAPTORQueries : public ParameterizedCommand {
+class RunHLRAPTORQueries : public ParallelQueryCommand {
 
 public:
     RunHLRAPTORQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runHLRAPTORQueries", "Runs the given number of random HL-RAPTOR queries.") {
+        ParallelQueryCommand(shell, "runHLRAPTORQueries", "Runs the given number of random HL-RAPTOR queries.") {
         addParameter("RAPTOR input file");
         addParameter("Out-hub file");
         addParameter("In-hub file");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -211,29 +532,28 @@ public:
         raptorData.printInfo();
         const TransferGraph outHubs(getParameter("Out-hub file"));
         const TransferGraph inHubs(getParameter("In-hub file"));
-        RAPTOR::HLRAPTOR<RAPTOR::AggregateProfiler> algorithm(raptorData, outHubs, inHubs);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(inHubs.numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::HLRAPTOR<RAPTOR::AggregateProfiler>(raptorData, outHubs, inHubs);
+        }, [](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunULTRARAPTORQueries : public ParameterizedCommand {
+class RunULTRARAPTORQueries : public ParallelQueryCommand {
 
 public:
     RunULTRARAPTORQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runULTRARAPTORQueries", "Runs the given number of random ULTRA-RAPTOR queries.") {
+        ParallelQueryCommand(shell, "runULTRARAPTORQueries", "Runs the given number of random ULTRA-RAPTOR queries.") {
         addParameter("RAPTOR input file");
         addParameter("CH data");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
@@ -241,73 +561,228 @@ public:
         raptorData.useImplicitDepartureBufferTimes();
         raptorData.printInfo();
         CH::CH ch(getParameter("CH data"));
-        RAPTOR::ULTRARAPTOR<RAPTOR::AggregateProfiler, false> algorithm(raptorData, ch);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return RAPTOR::ULTRARAPTOR<RAPTOR::AggregateProfiler, false>(raptorData, ch);
+        }, [](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
+            return algorithm.getJourneys().size();
+        });
+    }
+};
+
+class RunULTRARAPTORProfileQueries : public ParallelQueryCommand {
+
+public:
+    RunULTRARAPTORProfileQueries(BasicShell& shell) :
+        ParallelQueryCommand(shell, "runULTRARAPTORProfileQueries", "Runs the given number of random ULTRA-rRAPTOR profile queries over the given departure time range.") {
+        addParameter("RAPTOR input file");
+        addParameter("CH data");
+        addParameter("Number of queries");
+        addParameter("Start time", "08:00:00");
+        addParameter("End time", "10:00:00");
+        addParallelQueryParameters();
+    }
+
+    virtual void execute() noexcept {
+        RAPTOR::Data raptorData = RAPTOR::Data::FromBinary(getParameter("RAPTOR input file"));
+        raptorData.useImplicitDepartureBufferTimes();
+        raptorData.printInfo();
+        CH::CH ch(getParameter("CH data"));
+
+        const size_t n = getParameter<size_t>("Number of queries");
+        const int startTime = String::parseSeconds(getParameter("Start time"));
+        const int endTime = String::parseSeconds(getParameter("End time"));
+        const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
+
+        runQueries(queries, [&]() {
+            return RAPTOR::ULTRARAPTOR<RAPTOR::AggregateProfiler, false>(raptorData, ch);
+        }, [&](auto& algorithm, const VertexQuery& query) {
+            algorithm.runProfile(query.source, startTime, endTime, query.target);
+            return algorithm.getProfile().size();
+        });
+    }
+};
+
+class ValidateRAPTORProfileQueries : public ParameterizedCommand {
+
+public:
+    ValidateRAPTORProfileQueries(BasicShell& shell) :
+        ParameterizedCommand(shell, "validateRAPTORProfileQueries", "Compares rRAPTOR profile queries to one RAPTOR/ULTRA-RAPTOR query per departure time.") {
+        addParameter("Transitive RAPTOR input file");
+        addParameter("RAPTOR input file");
+        addParameter("CH data");
+        addParameter("Number of queries");
+        addParameter("Start time", "08:00:00");
+        addParameter("End time", "10:00:00");
+    }
+
+    virtual void execute() noexcept {
+        RAPTOR::Data transitiveRaptorData = RAPTOR::Data::FromBinary(getParameter("Transitive RAPTOR input file"));
+        transitiveRaptorData.useImplicitDepartureBufferTimes();
+        transitiveRaptorData.printInfo();
+        RAPTOR::Data raptorData = RAPTOR::Data::FromBinary(getParameter("RAPTOR input file"));
+        raptorData.useImplicitDepartureBufferTimes();
+        raptorData.printInfo();
+        CH::CH ch(getParameter("CH data"));
+
+        const size_t n = getParameter<size_t>("Number of queries");
+        const int startTime = String::parseSeconds(getParameter("Start time"));
+        const int endTime = String::parseSeconds(getParameter("End time"));
+
+        const std::vector<StopQuery> stopQueries = generateRandomStopQueries(raptorData.numberOfStops(), n);
+        // Both variants use only the transfer edges of the source as initial transfers.
+        const auto stopTransferTimes = [](const RAPTOR::Data& data) {
+            return [&data](auto&, const StopQuery& query) {
+                std::vector<int> transferTimes(data.numberOfStops(), INFTY);
+                transferTimes[query.source] = 0;
+                for (const Edge edge : data.transferGraph.edgesFrom(query.source)) {
+                    transferTimes[data.transferGraph.get(ToVertex, edge)] = data.transferGraph.get(TravelTime, edge);
+                }
+                return transferTimes;
+            };
+        };
+        std::cout << "Transitive RAPTOR:" << std::endl;
+        validate<RAPTOR::RAPTOR<true, RAPTOR::NoProfiler, true, false, false>>(transitiveRaptorData, stopQueries, startTime, endTime, stopTransferTimes(transitiveRaptorData), transitiveRaptorData);
+        std::cout << "Non-transitive RAPTOR:" << std::endl;
+        validate<RAPTOR::RAPTOR<true, RAPTOR::NoProfiler, false, false, false>>(raptorData, stopQueries, startTime, endTime, stopTransferTimes(raptorData), raptorData);
+
+        const std::vector<VertexQuery> vertexQueries = generateRandomVertexQueries(ch.numVertices(), n);
+        const auto transferTimes = [&](auto& algorithm, const VertexQuery& query) {
+            algorithm.run(query.source, startTime, query.target);
+            std::vector<int> transferTimes(raptorData.numberOfStops(), INFTY);
+            for (const StopId stop : raptorData.stops()) {
+                if (Vertex(stop) == query.target) continue;
+                transferTimes[stop] = std::min(INFTY, algorithm.getWalkingArrivalTime(stop) - startTime);
+            }
+            return transferTimes;
+        };
+        std::cout << "ULTRA-RAPTOR:" << std::endl;
+        validate<RAPTOR::ULTRARAPTOR<RAPTOR::NoProfiler, false>>(raptorData, vertexQueries, startTime, endTime, transferTimes, raptorData, ch);
+        std::cout << "ULTRA-RAPTOR without direct walking:" << std::endl;
+        validate<RAPTOR::ULTRARAPTOR<RAPTOR::NoProfiler, true>>(raptorData, vertexQueries, startTime, endTime, transferTimes, raptorData, ch);
+    }
+
+private:
+    // The reference profile runs one query per departure time of a trip at a stop that is reachable from the source
+    // by the initial transfers, from the latest to the earliest, and keeps the arrivals that improved.
+    template<typename ALGORITHM, typename QUERY, typename TRANSFER_TIMES, typename... ARGUMENTS>
+    inline void validate(const RAPTOR::Data& raptorData, const std::vector<QUERY>& queries, const int startTime, const int endTime, const TRANSFER_TIMES& getTransferTimes, const ARGUMENTS&... arguments) const noexcept {
+        ALGORITHM profileAlgorithm(arguments...);
+        ALGORITHM referenceAlgorithm(arguments...);
+        Timer timer;
+        double profileTime = 0;
+        double referenceTime = 0;
+        size_t profileSize = 0;
+        size_t mismatches = 0;
+        for (const QUERY& query : queries) {
+            timer.restart();
+            profileAlgorithm.runProfile(query.source, startTime, endTime, query.target);
+            profileTime += timer.elapsedMicroseconds();
+            const std::vector<RAPTOR::ProfileLabel>& profile = profileAlgorithm.getProfile();
+            profileSize += profile.size();
+
+            const std::vector<int> transferTimes = getTransferTimes(referenceAlgorithm, query);
+            std::vector<int> departureTimes;
+            for (const StopId stop : raptorData.stops()) {
+                const int transferTime = transferTimes[stop];
+                if (transferTime >= INFTY) continue;
+                for (const RAPTOR::RouteSegment& route : raptorData.routesContainingStop(stop)) {
+                    const size_t tripSize = raptorData.numberOfStopsInRoute(route.routeId);
+                    if (route.stopIndex + 1 == tripSize) continue;
+                    for (const RAPTOR::StopEvent* trip = raptorData.firstTripOfRoute(route.routeId); trip <= raptorData.lastTripOfRoute(route.routeId); trip += tripSize) {
+                        const int departureTime = trip[route.stopIndex].departureTime - transferTime;
+                        if (departureTime >= startTime && departureTime <= endTime) departureTimes.emplace_back(departureTime);
+                    }
+                }
+            }
+            sort(departureTimes);
+            departureTimes.erase(std::unique(departureTimes.begin(), departureTimes.end()), departureTimes.end());
+
+            timer.restart();
+            std::vector<RAPTOR::ProfileLabel> referenceProfile;
+            std::vector<int> previousArrivalTimes;
+            for (size_t i = departureTimes.size() - 1; i < departureTimes.size(); i--) {
+                referenceAlgorithm.run(query.source, departureTimes[i], query.target);
+                std::vector<int> arrivalTimes = referenceAlgorithm.getArrivalTimes();
+                const size_t maxNumberOfTrips = std::max(arrivalTimes.size(), previousArrivalTimes.size());
+                arrivalTimes.resize(maxNumberOfTrips, arrivalTimes.empty() ? never : arrivalTimes.back());
+                previousArrivalTimes.resize(maxNumberOfTrips, previousArrivalTimes.empty() ? never : previousArrivalTimes.back());
+                for (size_t numberOfTrips = 0; numberOfTrips < maxNumberOfTrips; numberOfTrips++) {
+                    const int arrivalTimeWithFewerTrips = (numberOfTrips == 0) ? never : arrivalTimes[numberOfTrips - 1];
+                    if (arrivalTimes[numberOfTrips] < arrivalTimeWithFewerTrips && arrivalTimes[numberOfTrips] < previousArrivalTimes[numberOfTrips]) {
+                        referenceProfile.emplace_back(departureTimes[i], arrivalTimes[numberOfTrips], numberOfTrips);
+                    }
+                }
+                previousArrivalTimes = arrivalTimes;
+            }
+            referenceTime += timer.elapsedMicroseconds();
+
+            if (profile == referenceProfile) continue;
+            mismatches++;
+            std::cout << "Mismatch for query " << query;
+            std::cout << "   rRAPTOR profile: " << profile.size() << " entries, reference profile: " << referenceProfile.size() << " entries" << std::endl;
         }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+        std::cout << "Mismatches: " << String::prettyInt(mismatches) << " of " << String::prettyInt(queries.size()) << " queries" << std::endl;
+        std::cout << "Avg. profile size: " << String::prettyDouble(profileSize / double(queries.size())) << std::endl;
+        std::cout << "Avg. profile query time: " << String::musToString(profileTime / queries.size()) << std::endl;
+        std::cout << "Avg. time of one query per departure time: " << String::musToString(referenceTime / queries.size()) << std::endl;
     }
 };
 
-class RunTransitiveTBQueries : public ParameterizedCommand {
+class RunTransitiveTBQueries : public ParallelQueryCommand {
 
 public:
     RunTransitiveTBQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runTransitiveTBQueries", "Runs the given number of random transitive TB queries.") {
+        ParallelQueryCommand(shell, "runTransitiveTBQueries", "Runs the given number of random transitive TB queries.") {
         addParameter("Trip-Based input file");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
         TripBased::Data tripBasedData(getParameter("Trip-Based input file"));
         tripBasedData.printInfo();
-        TripBased::TransitiveQuery<TripBased::AggregateProfiler> algorithm(tripBasedData);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<StopQuery> queries = generateRandomStopQueries(tripBasedData.numberOfStops(), n);
 
-        double numJourneys = 0;
-        for (const StopQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return TripBased::TransitiveQuery<TripBased::AggregateProfiler>(tripBasedData);
+        }, [](auto& algorithm, const StopQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
 
-class RunULTRATBQueries : public ParameterizedCommand {
+class RunULTRATBQueries : public ParallelQueryCommand {
 
 public:
     RunULTRATBQueries(BasicShell& shell) :
-        ParameterizedCommand(shell, "runULTRATBQueries", "Runs the given number of random ULTRA-TB queries.") {
+        ParallelQueryCommand(shell, "runULTRATBQueries", "Runs the given number of random ULTRA-TB queries.") {
         addParameter("Trip-Based input file");
         addParameter("CH data");
         addParameter("Number of queries");
+        addParallelQueryParameters();
     }
 
     virtual void execute() noexcept {
         TripBased::Data tripBasedData(getParameter("Trip-Based input file"));
         tripBasedData.printInfo();
         CH::CH ch(getParameter("CH data"));
-        TripBased::Query<TripBased::AggregateProfiler> algorithm(tripBasedData, ch);
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
 
-        double numJourneys = 0;
-        for (const VertexQuery& query : queries) {
+        runQueries(queries, [&]() {
+            return TripBased::Query<TripBased::AggregateProfiler>(tripBasedData, ch);
+        }, [](auto& algorithm, const VertexQuery& query) {
             algorithm.run(query.source, query.departureTime, query.target);
-            numJourneys += algorithm.getJourneys().size();
-        }
-        algorithm.getProfiler().printStatistics();
-        std::cout << "Avg. journeys: " << String::prettyDouble(numJourneys/n) << std::endl;
+            return algorithm.getJourneys().size();
+        });
     }
 };
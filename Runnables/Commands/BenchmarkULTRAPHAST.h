@@ -106,6 +106,9 @@ public:
         addParameter("Reorder network?");
         addParameter("Order", { "DFS", "Level" });
         addParameter("Targets", { "Vertices", "Stops" });
+        addParameter("Setup threads", "1");
+        addParameter("Sweep threads", "1");
+        addParameter("Pin multiplier", "1");
     }
 
     virtual void execute() noexcept {
@@ -138,12 +141,25 @@ private:
         using UPCSA = CSA::UPCSA<USE_STOP_BUCKETS, USE_TARGET_BUCKETS, true, CSA::AggregateProfiler>;
         Timer timer;
         const bool reorder = getParameter<bool>("Reorder network?");
-        UPCSA algorithm(csaData, ch, targetSet, reorder, getParameter("Order") == "DFS");
+        const ThreadPinning threadPinning(getParameter<size_t>("Setup threads"), getParameter<size_t>("Pin multiplier"));
+        UPCSA algorithm(csaData, ch, targetSet, reorder, getParameter("Order") == "DFS", CSA::AggregateProfiler(), threadPinning);
         const double buildTime = timer.elapsedMicroseconds();
 
         const size_t n = getParameter<size_t>("Number of queries");
         const std::vector<OneToAllQuery> queries = generateRandomOneToAllQueries(ch.numVertices(), n);
 
+        //With parallel sweeps, the queries are run sequentially first to measure the speedup
+        const size_t sweepThreads = getParameter<size_t>("Sweep threads");
+        CSA::AggregateProfiler sequentialProfiler;
+        if (sweepThreads > 1) {
+            for (const OneToAllQuery& query : queries) {
+                algorithm.run(query.source, query.departureTime);
+            }
+            sequentialProfiler = algorithm.getProfiler();
+            algorithm.getProfiler().initialize();
+            algorithm.useParallelSweeps(ThreadPinning(sweepThreads, getParameter<size_t>("Pin multiplier")));
+        }
+
         for (const OneToAllQuery& query : queries) {
             algorithm.run(query.source, query.departureTime);
         }
@@ -160,6 +176,106 @@ private:
 
         std::cout << "Query statistics:" << std::endl;
         algorithm.getProfiler().printStatistics();
+
+        if (sweepThreads > 1) {
+            std::cout << std::endl << "Speedup of parallel sweeps with " << sweepThreads << " threads:" << std::endl;
+            for (const CSA::Phase phase : {CSA::PHASE_INITIALIZATION, CSA::PHASE_DOWNWARD_SEARCH}) {
+                const double sequentialTime = sequentialProfiler.getPhaseTime(phase);
+                const double parallelTime = algorithm.getProfiler().getPhaseTime(phase);
+                std::cout << "\t" << CSA::PhaseNames[phase] << ": " << String::musToString(sequentialTime) << " -> " << String::musToString(parallelTime) << " (" << String::prettyDouble(sequentialTime / parallelTime) << "x)" << std::endl;
+            }
+            std::cout << "\tTotal: " << String::musToString(sequentialProfiler.getTotalTime()) << " -> " << String::musToString(algorithm.getProfiler().getTotalTime()) << " (" << String::prettyDouble(sequentialProfiler.getTotalTime() / algorithm.getProfiler().getTotalTime()) << "x)" << std::endl;
+        }
+    }
+};
+
+class RunUPCSABatchQueries : public ParameterizedCommand {
+
+public:
+    RunUPCSABatchQueries(BasicShell& shell) :
+        ParameterizedCommand(shell, "runUPCSABatchQueries", "Runs the given number of random UP-CSA queries in batches and compares the cost per source with single-source queries.") {
+        addParameter("CSA data");
+        addParameter("CH data");
+        addParameter("Number of queries");
+        addParameter("Initial transfers", { "Bucket", "PHAST" });
+        addParameter("Reorder network?");
+        addParameter("Order", { "DFS", "Level" });
+        addParameter("Targets", { "Vertices", "Stops" });
+    }
+
+    virtual void execute() noexcept {
+        if (getParameter("Initial transfers") == "Bucket") {
+            run<true>();
+        } else {
+            run<false>();
+        }
+    }
+
+private:
+    template<bool USE_STOP_BUCKETS>
+    inline void run() const noexcept {
+        CSA::Data csaData(getParameter("CSA data"));
+        csaData.sortConnectionsAscending();
+        csaData.printInfo();
+        CH::CH ch(getParameter("CH data"));
+
+        IndexedSet<false, Vertex> targetSet = getTargetSet(csaData, ch.numVertices(), getParameter("Targets") == "Vertices");
+
+        using UPCSA = CSA::UPCSA<USE_STOP_BUCKETS, false, false, CSA::AggregateProfiler>;
+        constexpr size_t BatchSize = UPCSA::BatchSize;
+        const bool reorder = getParameter<bool>("Reorder network?");
+        UPCSA algorithm(csaData, ch, targetSet, reorder, getParameter("Order") == "DFS");
+
+        const size_t n = getParameter<size_t>("Number of queries");
+        const std::vector<OneToAllQuery> queries = generateRandomOneToAllQueries(ch.numVertices(), n);
+
+        std::vector<std::vector<int>> arrivalTimes;
+        Timer timer;
+        for (const OneToAllQuery& query : queries) {
+            algorithm.run(query.source, query.departureTime);
+            std::vector<int>& result = arrivalTimes.emplace_back();
+            for (const Vertex target : targetSet) {
+                result.emplace_back(algorithm.getEarliestArrivalTime(target));
+            }
+        }
+        const double singleTime = timer.elapsedMicroseconds();
+        const CSA::AggregateProfiler singleProfiler = algorithm.getProfiler();
+        algorithm.getProfiler().initialize();
+
+        size_t mismatches = 0;
+        size_t numberOfBatches = 0;
+        std::vector<Vertex> sources;
+        std::vector<int> departureTimes;
+        timer.restart();
+        for (size_t i = 0; i < queries.size(); i += BatchSize) {
+            sources.clear();
+            departureTimes.clear();
+            for (size_t j = i; j < std::min(i + BatchSize, queries.size()); j++) {
+                sources.emplace_back(queries[j].source);
+                departureTimes.emplace_back(queries[j].departureTime);
+            }
+            algorithm.runBatch(sources, departureTimes);
+            numberOfBatches++;
+            for (size_t lane = 0; lane < sources.size(); lane++) {
+                size_t t = 0;
+                for (const Vertex target : targetSet) {
+                    if (algorithm.getBatchEarliestArrivalTime(lane, target) != arrivalTimes[i + lane][t++]) mismatches++;
+                }
+            }
+        }
+        const double batchTime = timer.elapsedMicroseconds();
+        const CSA::AggregateProfiler& batchProfiler = algorithm.getProfiler();
+
+        std::cout << "Cost per source (" << BatchSize << " sources per batch):" << std::endl;
+        std::cout << "\t" << std::left << std::setw(24) << "Phase" << std::right << std::setw(16) << "Single" << std::setw(16) << "Batched" << std::endl;
+        for (const CSA::Phase phase : {CSA::PHASE_CLEAR, CSA::PHASE_INITIALIZATION, CSA::PHASE_CONNECTION_SCAN, CSA::PHASE_UPWARD_SWEEP, CSA::PHASE_DOWNWARD_SEARCH}) {
+            const double singlePhaseTime = singleProfiler.getPhaseTime(phase);
+            const double batchPhaseTime = batchProfiler.getPhaseTime(phase) * numberOfBatches / queries.size();
+            std::cout << "\t" << std::left << std::setw(24) << CSA::PhaseNames[phase] << std::right << std::setw(17) << String::musToString(singlePhaseTime) << std::setw(17) << String::musToString(batchPhaseTime) << std::endl;
+        }
+        std::cout << "\t" << std::left << std::setw(24) << "Total (with evaluation)" << std::right << std::setw(17) << String::musToString(singleTime / queries.size()) << std::setw(17) << String::musToString(batchTime / queries.size()) << std::endl;
+        std::cout << "Speedup: " << String::prettyDouble(singleTime / batchTime) << std::endl;
+        std::cout << "Mismatching arrival times: " << String::prettyInt(mismatches) << std::endl;
     }
 };
 
@@ -1,9 +1,11 @@
 #include <iostream>
+#include <iomanip>
 #include <vector>
 #include <string>
 #include <random>
 
 #include "../../Helpers/MultiThreading.h"
+#include "../../Helpers/Timer.h"
 
 #include "../../DataStructures/CSA/Data.h"
 #include "../../DataStructures/Intermediate/Data.h"
@@ -12,6 +14,13 @@
 #include "../../Algorithms/CH/CH.h"
 #include "../../Algorithms/CH/Preprocessing/CHBuilder.h"
 #include "../../Algorithms/CH/Preprocessing/BidirectionalWitnessSearch.h"
+#include "../../Algorithms/CH/Preprocessing/HubLabelBuilder.h"
+#include "../../Algorithms/CH/CCH/NestedDissection.h"
+#include "../../Algorithms/CH/CCH/CustomizableCH.h"
+#include "../../Algorithms/CH/Query/CHQuery.h"
+#include "../../Algorithms/Dijkstra/Dijkstra.h"
+
+#include "../../DataStructures/Queries/Queries.h"
 #include "../../Shell/Shell.h"
 using namespace Shell;
 
@@ -46,16 +55,86 @@ inline CH::CH finalizeCH(CH_BUILDER&& chBuilder, const std::string& orderOutputF
     return ch;
 }
 
+// With more than one thread, the vertices are contracted in parallel rounds of independent sets.
 template<typename PROFILER, typename WITNESS_SEARCH, typename GRAPH, typename KEY_FUNCTION, typename STOP_CRITERION = StopCriterion>
-inline CH::CH buildCH(GRAPH& originalGraph, const std::string& orderOutputFile, const std::string& chOutputFile, const KEY_FUNCTION& keyFunction, const STOP_CRITERION& stopCriterion = StopCriterion()) noexcept {
+inline CH::CH buildCH(GRAPH& originalGraph, const std::string& orderOutputFile, const std::string& chOutputFile, const KEY_FUNCTION& keyFunction, const STOP_CRITERION& stopCriterion = StopCriterion(), const size_t numberOfThreads = 1, const size_t pinMultiplier = 1) noexcept {
     TravelTimeGraph graph;
     Graph::copy(originalGraph, graph);
     Graph::printInfo(graph);
     CH::Builder<PROFILER, WITNESS_SEARCH, KEY_FUNCTION, STOP_CRITERION, false, false> chBuilder(std::move(graph), graph[TravelTime], keyFunction, stopCriterion);
-    chBuilder.run();
+    if (numberOfThreads > 1) {
+        std::cout << "Contracting with " << numberOfThreads << " threads" << std::endl;
+        chBuilder.run(ThreadPinning(numberOfThreads, pinMultiplier));
+        std::cout << "Contracted in " << String::prettyInt(chBuilder.getNumberOfRounds()) << " rounds" << std::endl;
+    } else {
+        chBuilder.run();
+    }
     return finalizeCH(chBuilder, orderOutputFile, chOutputFile);
 }
 
+// Replaces the transfer graph of the network by the core of the CH, i.e., the edges between core vertices.
+template<typename NETWORK_TYPE>
+inline void replaceTransferGraphByCore(NETWORK_TYPE& data, const CH::CH& ch) noexcept {
+    Intermediate::TransferGraph resultGraph;
+    resultGraph.addVertices(data.transferGraph.numVertices());
+    resultGraph[Coordinates] = data.transferGraph[Coordinates];
+    for (const Vertex vertex : resultGraph.vertices()) {
+        if (ch.isCoreVertex(vertex)) {
+            for (const Edge edge : ch.forward.edgesFrom(vertex)) {
+                resultGraph.addEdge(vertex, ch.forward.get(ToVertex, edge)).set(TravelTime, ch.forward.get(Weight, edge));
+            }
+        }
+    }
+    Graph::move(std::move(resultGraph), data.transferGraph);
+}
+
+template<typename GRAPH>
+inline void validateCH(const GRAPH& graph, const CH::CH& ch, const size_t numberOfQueries) noexcept {
+    if (numberOfQueries == 0) return;
+    const std::vector<VertexQuery> queries = generateRandomVertexQueries(graph.numVertices(), numberOfQueries);
+    Dijkstra<GRAPH, false> dijkstra(graph);
+    CH::Query<CHGraph, true> query(ch);
+    size_t numberOfErrors = 0;
+    for (const VertexQuery& vertexQuery : queries) {
+        dijkstra.run(vertexQuery.source, vertexQuery.target);
+        query.run(vertexQuery.source, vertexQuery.target);
+        const int dijkstraDistance = dijkstra.visited(vertexQuery.target) ? dijkstra.getDistance(vertexQuery.target) : INFTY;
+        if (query.getDistance() != dijkstraDistance) {
+            if (numberOfErrors < 10) std::cout << "Wrong distance for " << vertexQuery.source << " -> " << vertexQuery.target << ": " << query.getDistance() << " instead of " << dijkstraDistance << std::endl;
+            numberOfErrors++;
+        }
+    }
+    std::cout << "Validated " << String::prettyInt(numberOfQueries) << " queries, " << String::prettyInt(numberOfErrors) << " errors" << std::endl;
+}
+
+// Prints the average core degree in the same terms as CoreCriterion, i.e., core edges per core vertex.
+inline void printCoreDegree(const CH::CH& ch) noexcept {
+    size_t coreSize = 0;
+    size_t coreEdges = 0;
+    size_t maxDegree = 0;
+    for (const Vertex vertex : ch.forward.vertices()) {
+        if (!ch.isCoreVertex(vertex)) continue;
+        coreSize++;
+        coreEdges += ch.forward.outDegree(vertex);
+        maxDegree = std::max<size_t>(maxDegree, ch.forward.outDegree(vertex));
+    }
+    std::cout << "Core: " << String::prettyInt(coreSize) << " vertices, " << String::prettyInt(coreEdges) << " edges, average degree " << String::prettyDouble(coreEdges / double(std::max<size_t>(coreSize, 1))) << ", max. degree " << String::prettyInt(maxDegree) << std::endl;
+}
+
+template<typename GRAPH>
+inline CH::CH customizeCCH(const GRAPH& graph, const Order& order, const size_t numberOfContractedVertices, const size_t numberOfThreads, const size_t pinMultiplier) noexcept {
+    Timer timer;
+    CH::CustomizableCH cch(graph, order, numberOfContractedVertices);
+    std::cout << "Topology: " << String::prettyInt(cch.numberOfArcs()) << " arcs, " << String::prettyInt(cch.numberOfLevels()) << " levels, " << String::prettyInt(cch.numberOfVertices() - numberOfContractedVertices) << " core vertices (" << String::msToString(timer.elapsedMilliseconds()) << ")" << std::endl;
+    timer.restart();
+    cch.customize(graph[TravelTime], ThreadPinning(numberOfThreads, pinMultiplier));
+    std::cout << "Customization with " << numberOfThreads << " threads: " << String::msToString(timer.elapsedMilliseconds()) << std::endl;
+    CH::CH ch = cch.getCH();
+    std::cout << "CH edges: " << String::prettyInt(ch.numEdges()) << std::endl;
+    if (numberOfContractedVertices < cch.numberOfVertices()) printCoreDegree(ch);
+    return ch;
+}
+
 class BuildCH : public ParameterizedCommand {
 
 public:
@@ -67,6 +146,8 @@ public:
         addParameter("Use full profiler?", "true");
         addParameter("Witness search type", "bidirectional", { "normal", "bidirectional" });
         addParameter("Level weight", "256");
+        addParameter("Number of threads", "1");
+        addParameter("Pin multiplier", "1");
     }
 
     virtual void execute() noexcept {
@@ -91,7 +172,15 @@ private:
     inline void build() const noexcept {
         TransferGraph graph(getParameter("Graph binary"));
         GreedyKey<WITNESS_SEARCH> keyFunction(ShortcutWeight, getParameter<int>("Level weight"), DegreeWeight);
-        buildCH<PROFILER, WITNESS_SEARCH>(graph, getParameter("Order output file"), getParameter("CH output file"), keyFunction);
+        buildCH<PROFILER, WITNESS_SEARCH>(graph, getParameter("Order output file"), getParameter("CH output file"), keyFunction, StopCriterion(), getNumberOfThreads(), getParameter<size_t>("Pin multiplier"));
+    }
+
+    inline size_t getNumberOfThreads() const noexcept {
+        if (getParameter("Number of threads") == "max") {
+            return numberOfCores();
+        } else {
+            return getParameter<int>("Number of threads");
+        }
     }
 };
 
@@ -109,6 +198,8 @@ public:
         addParameter("Use full profiler?", "true");
         addParameter("Witness search type", "bidirectional", { "normal", "bidirectional" });
         addParameter("Level weight", "256");
+        addParameter("Number of threads", "1");
+        addParameter("Pin multiplier", "1");
     }
 
     virtual void execute() noexcept {
@@ -156,19 +247,294 @@ private:
         GreedyKey<WITNESS_SEARCH> greedyKey(ShortcutWeight, getParameter<int>("Level weight"), DegreeWeight);
         PartialKey<WITNESS_SEARCH> keyFunction(contractable, data.transferGraph.numVertices(), greedyKey);
         CH::CoreCriterion stopCriterion(data.numberOfStops(), maxCoreDegree);
-        const CH::CH ch = buildCH<PROFILER, WITNESS_SEARCH>(data.transferGraph, getParameter("Order output file"), getParameter("CH output file"), keyFunction, stopCriterion);
-
-        Intermediate::TransferGraph resultGraph;
-        resultGraph.addVertices(data.transferGraph.numVertices());
-        resultGraph[Coordinates] = data.transferGraph[Coordinates];
-        for (const Vertex vertex : resultGraph.vertices()) {
-            if (ch.isCoreVertex(vertex)) {
-                for (const Edge edge : ch.forward.edgesFrom(vertex)) {
-                    resultGraph.addEdge(vertex, ch.forward.get(ToVertex, edge)).set(TravelTime, ch.forward.get(Weight, edge));
+        const CH::CH ch = buildCH<PROFILER, WITNESS_SEARCH>(data.transferGraph, getParameter("Order output file"), getParameter("CH output file"), keyFunction, stopCriterion, getNumberOfThreads(), getParameter<size_t>("Pin multiplier"));
+        printCoreDegree(ch);
+        replaceTransferGraphByCore(data, ch);
+        data.serialize(getParameter("Network output file"));
+    }
+
+    inline size_t getNumberOfThreads() const noexcept {
+        if (getParameter("Number of threads") == "max") {
+            return numberOfCores();
+        } else {
+            return getParameter<int>("Number of threads");
+        }
+    }
+};
+
+class BuildNestedDissectionOrder : public ParameterizedCommand {
+
+public:
+    BuildNestedDissectionOrder(BasicShell& shell) :
+        ParameterizedCommand(shell, "buildNestedDissectionOrder", "Computes a metric-independent vertex order for a customizable CH with nested dissection, using the vertex coordinates.") {
+        addParameter("Graph binary");
+        addParameter("Order output file");
+        addParameter("Number of threads", "max");
+        addParameter("Pin multiplier", "1");
+    }
+
+    virtual void execute() noexcept {
+        const TransferGraph graph(getParameter("Graph binary"));
+        Graph::printInfo(graph);
+        const size_t numberOfThreads = getNumberOfThreads();
+
+        CH::NestedDissection nestedDissection(graph);
+        std::cout << "Computing nested dissection order with " << numberOfThreads << " threads" << std::endl;
+        Timer timer;
+        const Order order = nestedDissection.run(ThreadPinning(numberOfThreads, getParameter<size_t>("Pin multiplier")));
+        std::cout << "Order time: " << String::msToString(timer.elapsedMilliseconds()) << std::endl;
+        order.serialize(getParameter("Order output file"));
+    }
+
+private:
+    inline size_t getNumberOfThreads() const noexcept {
+        if (getParameter("Number of threads") == "max") {
+            return numberOfCores();
+        } else {
+            return getParameter<int>("Number of threads");
+        }
+    }
+};
+
+class CustomizeCCH : public ParameterizedCommand {
+
+public:
+    CustomizeCCH(BasicShell& shell) :
+        ParameterizedCommand(shell, "customizeCCH", "Computes a CH for the travel times of the input graph by customizing a CCH with the given nested dissection order.") {
+        addParameter("Graph binary");
+        addParameter("Order file");
+        addParameter("CH output file");
+        addParameter("Number of threads", "max");
+        addParameter("Pin multiplier", "1");
+        addParameter("Number of validation queries", "0");
+    }
+
+    virtual void execute() noexcept {
+        const TransferGraph graph(getParameter("Graph binary"));
+        Graph::printInfo(graph);
+        const Order order(getParameter("Order file"));
+        const CH::CH ch = customizeCCH(graph, order, graph.numVertices(), getNumberOfThreads(), getParameter<size_t>("Pin multiplier"));
+        ch.writeBinary(getParameter("CH output file"));
+        validateCH(graph, ch, getParameter<size_t>("Number of validation queries"));
+    }
+
+private:
+    inline size_t getNumberOfThreads() const noexcept {
+        if (getParameter("Number of threads") == "max") {
+            return numberOfCores();
+        } else {
+            return getParameter<int>("Number of threads");
+        }
+    }
+};
+
+class CustomizeCoreCCH : public ParameterizedCommand {
+
+public:
+    CustomizeCoreCCH(BasicShell& shell) :
+        ParameterizedCommand(shell, "customizeCoreCCH", "Computes a core-CH for the input network by customizing a CCH, where all stops are moved to the top of the nested dissection order and kept uncontracted.") {
+        addParameter("Network input file");
+        addParameter("Order file");
+        addParameter("CH output file");
+        addParameter("Network output file");
+        addParameter("Network type", "raptor", {"intermediate", "csa", "raptor"});
+        addParameter("Number of threads", "max");
+        addParameter("Pin multiplier", "1");
+    }
+
+    virtual void execute() noexcept {
+        const std::string networkType = getParameter("Network type");
+        if (networkType == "raptor") {
+            build<RAPTOR::Data>();
+        } else if (networkType == "csa") {
+            build<CSA::Data>();
+        } else {
+            build<Intermediate::Data>();
+        }
+    }
+
+private:
+    template<typename NETWORK_TYPE>
+    inline void build() const noexcept {
+        NETWORK_TYPE data(getParameter("Network input file"));
+        data.printInfo();
+        const Order order(getParameter("Order file"));
+        Order coreOrder;
+        for (const size_t vertex : order) {
+            if (vertex >= data.numberOfStops()) coreOrder.emplace_back(vertex);
+        }
+        for (const size_t vertex : order) {
+            if (vertex < data.numberOfStops()) coreOrder.emplace_back(vertex);
+        }
+        const size_t numberOfContractedVertices = data.transferGraph.numVertices() - data.numberOfStops();
+        const CH::CH ch = customizeCCH(data.transferGraph, coreOrder, numberOfContractedVertices, getNumberOfThreads(), getParameter<size_t>("Pin multiplier"));
+        ch.writeBinary(getParameter("CH output file"));
+        replaceTransferGraphByCore(data, ch);
+        data.serialize(getParameter("Network output file"));
+    }
+
+    inline size_t getNumberOfThreads() const noexcept {
+        if (getParameter("Number of threads") == "max") {
+            return numberOfCores();
+        } else {
+            return getParameter<int>("Number of threads");
+        }
+    }
+};
+
+class CompareCHs : public ParameterizedCommand {
+
+public:
+    CompareCHs(BasicShell& shell) :
+        ParameterizedCommand(shell, "compareCHs", "Compares the size and query performance of a CH to a reference CH of the same graph, e.g., a parallel to a sequential contraction.") {
+        addParameter("Reference CH file");
+        addParameter("CH file");
+        addParameter("Number of queries", "10000");
+    }
+
+    virtual void execute() noexcept {
+        const CH::CH reference(getParameter("Reference CH file"));
+        const CH::CH ch(getParameter("CH file"));
+        Ensure(reference.numVertices() == ch.numVertices(), "The CHs have " << reference.numVertices() << " and " << ch.numVertices() << " vertices!");
+        const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), getParameter<size_t>("Number of queries"));
+
+        std::cout << std::setw(10) << "" << std::setw(14) << "Edges" << std::setw(14) << "Shortcuts" << std::setw(14) << "Search space" << std::setw(14) << "Search edges" << std::setw(14) << "Query time" << std::endl;
+        const std::vector<int> referenceDistances = evaluate("Reference", reference, queries);
+        const std::vector<int> distances = evaluate("CH", ch, queries);
+        size_t numberOfMismatches = 0;
+        for (size_t i = 0; i < queries.size(); i++) {
+            if (distances[i] == referenceDistances[i]) continue;
+            if (numberOfMismatches < 10) std::cout << "Wrong distance for " << queries[i].source << " -> " << queries[i].target << ": " << distances[i] << " instead of " << referenceDistances[i] << std::endl;
+            numberOfMismatches++;
+        }
+        std::cout << "Distance mismatches: " << String::prettyInt(numberOfMismatches) << std::endl;
+    }
+
+private:
+    // Prints the size of the CH, the average number of vertices and edges in the upward search spaces of the source
+    // and target (without stall-on-demand), and the average query time. Returns the query distances.
+    inline std::vector<int> evaluate(const std::string& name, const CH::CH& ch, const std::vector<VertexQuery>& queries) const noexcept {
+        size_t numberOfShortcuts = 0;
+        for (const Edge edge : ch.edges()) {
+            if (ch.get(ViaVertex, edge) != noVertex) numberOfShortcuts++;
+        }
+        std::vector<bool> reached(ch.numVertices(), false);
+        std::vector<Vertex> searchSpace;
+        size_t searchSpaceVertices = 0;
+        size_t searchSpaceEdges = 0;
+        for (const VertexQuery& query : queries) {
+            for (const int direction : {FORWARD, BACKWARD}) {
+                const CHGraph& graph = ch.getGraph(direction);
+                searchSpace.assign(1, (direction == FORWARD) ? query.source : query.target);
+                reached[searchSpace[0]] = true;
+                for (size_t i = 0; i < searchSpace.size(); i++) {
+                    searchSpaceEdges += graph.outDegree(searchSpace[i]);
+                    for (const Edge edge : graph.edgesFrom(searchSpace[i])) {
+                        const Vertex to = graph.get(ToVertex, edge);
+                        if (reached[to]) continue;
+                        reached[to] = true;
+                        searchSpace.emplace_back(to);
+                    }
+                }
+                searchSpaceVertices += searchSpace.size();
+                for (const Vertex vertex : searchSpace) {
+                    reached[vertex] = false;
                 }
             }
         }
-        Graph::move(std::move(resultGraph), data.transferGraph);
-        data.serialize(getParameter("Network output file"));
+
+        CH::Query<CHGraph, true> query(ch);
+        std::vector<int> distances;
+        distances.reserve(queries.size());
+        Timer timer;
+        for (const VertexQuery& vertexQuery : queries) {
+            query.run(vertexQuery.source, vertexQuery.target);
+            distances.emplace_back(query.getDistance());
+        }
+        const double queryTime = timer.elapsedMicroseconds() / std::max<size_t>(queries.size(), 1);
+        const double numberOfQueries = std::max<size_t>(queries.size(), 1);
+        std::cout << std::setw(10) << name
+                  << std::setw(14) << String::prettyInt(ch.numEdges())
+                  << std::setw(14) << String::prettyInt(numberOfShortcuts)
+                  << std::setw(14) << String::prettyDouble(searchSpaceVertices / numberOfQueries, 1)
+                  << std::setw(14) << String::prettyDouble(searchSpaceEdges / numberOfQueries, 1)
+                  << std::setw(14) << String::musToString(queryTime) << std::endl;
+        return distances;
+    }
+};
+
+class BuildHubLabels : public ParameterizedCommand {
+
+public:
+    BuildHubLabels(BasicShell& shell) :
+        ParameterizedCommand(shell, "buildHubLabels", "Computes hub labels for the input graph with pruned landmark labeling, using the vertex order of a CH.") {
+        addParameter("Graph binary");
+        addParameter("Order file");
+        addParameter("Out-hub output file");
+        addParameter("In-hub output file");
+        addParameter("Number of threads", "max");
+        addParameter("Pin multiplier", "1");
+        addParameter("Number of validation queries", "0");
+    }
+
+    virtual void execute() noexcept {
+        const TransferGraph graph(getParameter("Graph binary"));
+        Graph::printInfo(graph);
+        const Order order(getParameter("Order file"));
+        const size_t numberOfThreads = getNumberOfThreads();
+        const size_t pinMultiplier = getParameter<size_t>("Pin multiplier");
+
+        CH::HubLabelBuilder builder(graph, order);
+        std::cout << "Computing hub labels with " << numberOfThreads << " threads" << std::endl;
+        Timer timer;
+        builder.run(ThreadPinning(numberOfThreads, pinMultiplier));
+        const double buildTime = timer.elapsedMilliseconds();
+        std::cout << "Build time: " << String::msToString(buildTime) << " (" << String::prettyInt(builder.getNumberOfBatches()) << " batches)" << std::endl;
+        builder.printStatistics();
+
+        const TransferGraph outHubs = builder.getOutHubs();
+        const TransferGraph inHubs = builder.getInHubs();
+        outHubs.writeBinary(getParameter("Out-hub output file"));
+        inHubs.writeBinary(getParameter("In-hub output file"));
+        validate(graph, outHubs, inHubs);
+    }
+
+private:
+    inline size_t getNumberOfThreads() const noexcept {
+        if (getParameter("Number of threads") == "max") {
+            return numberOfCores();
+        } else {
+            return getParameter<int>("Number of threads");
+        }
+    }
+
+    inline void validate(const TransferGraph& graph, const TransferGraph& outHubs, const TransferGraph& inHubs) const noexcept {
+        const size_t n = getParameter<size_t>("Number of validation queries");
+        if (n == 0) return;
+        const std::vector<VertexQuery> queries = generateRandomVertexQueries(graph.numVertices(), n);
+        Dijkstra<TransferGraph, false> dijkstra(graph);
+        std::vector<int> distanceToHub(graph.numVertices(), INFTY);
+        size_t numberOfErrors = 0;
+        for (const VertexQuery& query : queries) {
+            dijkstra.run(query.source, query.target);
+            for (const Edge edge : outHubs.edgesFrom(query.source)) {
+                distanceToHub[outHubs.get(ToVertex, edge)] = outHubs.get(TravelTime, edge);
+            }
+            int hubDistance = INFTY;
+            for (const Edge edge : inHubs.edgesFrom(query.target)) {
+                const Vertex hub = inHubs.get(ToVertex, edge);
+                if (distanceToHub[hub] == INFTY) continue;
+                hubDistance = std::min(hubDistance, distanceToHub[hub] + inHubs.get(TravelTime, edge));
+            }
+            for (const Edge edge : outHubs.edgesFrom(query.source)) {
+                distanceToHub[outHubs.get(ToVertex, edge)] = INFTY;
+            }
+            const int dijkstraDistance = dijkstra.visited(query.target) ? dijkstra.getDistance(query.target) : INFTY;
+            if (hubDistance != dijkstraDistance) {
+                if (numberOfErrors < 10) std::cout << "Wrong distance for " << query.source << " -> " << query.target << ": " << hubDistance << " instead of " << dijkstraDistance << std::endl;
+                numberOfErrors++;
+            }
+        }
+        std::cout << "Validated " << String::prettyInt(n) << " queries, " << String::prettyInt(numberOfErrors) << " errors" << std::endl;
     }
 };
@@ -4,6 +4,9 @@
 #include <vector>
 #include <iostream>
 #include <random>
+#include <atomic>
+#include <memory>
+#include <thread>
 
 #include "../../Shell/Shell.h"
 
@@ -13,6 +16,7 @@
 #include "../../DataStructures/TripBased/Delay.h"
 #include "../../DataStructures/TripBased/DelayData.h"
 #include "../../DataStructures/TripBased/DelayInfo.h"
+#include "../../DataStructures/TripBased/DelayQueryDataVersions.h"
 #include "../../DataStructures/TripBased/DelayUpdateData.h"
 
 #include "../../Algorithms/RAPTOR/DijkstraRAPTOR.h"
@@ -20,7 +24,9 @@
 #include "../../Algorithms/TripBased/Preprocessing/DelayUpdater.h"
 #include "../../Algorithms/TripBased/Query/Query.h"
 
+#include "../../Helpers/Histogram.h"
 #include "../../Helpers/MultiThreading.h"
+#include "../../Helpers/Timer.h"
 
 using namespace Shell;
 
@@ -534,6 +540,7 @@ public:
         addParameter("Target slack");
         addParameter("Number of threads", "max");
         addParameter("Pin multiplier", "1");
+        addParameter("Shortcut merge threshold", "1000");
     }
     virtual void execute() noexcept {
         TripBased::DelayData delayData(getParameter("Trip-Based data"));
@@ -545,7 +552,8 @@ public:
         const int pinMultiplier = getParameter<int>("Pin multiplier");
         const ThreadPinning threadPinning(numberOfThreads, pinMultiplier);
         const int targetSlack = getParameter<int>("Target slack");
-        TripBased::DelayUpdaterWithReplacement delayUpdater(delayData, initialTransfers, threadPinning, targetSlack);
+        const size_t mergeThreshold = getParameter<size_t>("Shortcut merge threshold");
+        TripBased::DelayUpdaterWithReplacement delayUpdater(delayData, initialTransfers, threadPinning, targetSlack, mergeThreshold);
 
         const TripBased::DelayScenario delayScenario(delayData.data, getParameter("Delay scenario file"));
         const bool allowDepartureDelays = getParameter<bool>("Allow departure delays?");
@@ -794,9 +802,14 @@ public:
         addParameter("Number of queries");
         addParameter("Start time", "14:00:00");
         addParameter("End time", "15:00:00");
+        addParameter("Concurrent updates?", "false");
     }
 
     virtual void execute() noexcept {
+        if (getParameter<bool>("Concurrent updates?")) {
+            runWithConcurrentUpdates();
+            return;
+        }
         RAPTOR::Data dijkstraRaptorData(getParameter("Dijkstra RAPTOR data"));
         dijkstraRaptorData.useImplicitDepartureBufferTimes();
         dijkstraRaptorData.printInfo();
@@ -837,4 +850,80 @@ private:
         algorithm.getProfiler().printStatistics();
         return results;
     }
+
+    // Replays the update log after the start time on a separate thread while the queries are answered. Every query
+    // pins the current version of the query data, so it never waits for an update to finish.
+    inline void runWithConcurrentUpdates() noexcept {
+        TripBased::DelayData delayData(getParameter("Trip-Based data"));
+        delayData.printInfo();
+        const CH::CH bucketCH(getParameter("Bucket CH data"));
+        const RAPTOR::BucketCHInitialTransfers initialTransfers(bucketCH.forward, bucketCH.backward, delayData.data.numberOfStops(), Weight);
+
+        const int startTime = String::parseSeconds(getParameter("Start time"));
+        const int endTime = String::parseSeconds(getParameter("End time"));
+        TripBased::DelayUpdateSimulator delayUpdater(delayData, getParameter("Update log file"));
+        delayUpdater.applyUpdatesUntil(startTime, true);
+        const TripBased::DelayQueryDataVersions& queryDataVersions = delayUpdater.getQueryDataVersions();
+        const size_t initialVersions = queryDataVersions.getNumberOfPublishedVersions();
+
+        const size_t n = getParameter<size_t>("Number of queries");
+        const std::vector<VertexQuery> queries = generateRandomVertexQueries(bucketCH.numVertices(), n, startTime, endTime);
+
+        std::atomic<bool> queriesFinished(false);
+        std::atomic<size_t> updatesStarted(0);
+        std::atomic<size_t> updatesFinished(0);
+        Histogram updateTime(Histogram::TimeResolution);
+        std::thread updateThread([&]() {
+            while (!queriesFinished && delayUpdater.hasNextUpdate() && delayUpdater.nextUpdateFinishTime() <= endTime) {
+                updatesStarted++;
+                Timer timer;
+                delayUpdater.applyNextUpdate(true);
+                updateTime.add(timer.elapsedMicroseconds());
+                updatesFinished++;
+            }
+        });
+
+        Histogram latencyBetweenUpdates(Histogram::TimeResolution);
+        Histogram latencyDuringUpdates(Histogram::TimeResolution);
+        size_t numberOfJourneys = 0;
+        size_t usedVersions = 0;
+        size_t maxLiveVersions = 0;
+        TripBased::DelayQueryDataVersions::Version version;
+        std::unique_ptr<TripBased::Query<>> algorithm;
+        Progress progress(queries.size());
+        for (const VertexQuery& query : queries) {
+            const size_t finishedUpdates = updatesFinished;
+            Timer timer;
+            TripBased::DelayQueryDataVersions::Version currentVersion = queryDataVersions.acquire();
+            if (currentVersion != version) {
+                algorithm.reset();
+                version = std::move(currentVersion);
+                algorithm = std::make_unique<TripBased::Query<>>(version->tripData, initialTransfers);
+                usedVersions++;
+            }
+            algorithm->run(query.source, query.departureTime, query.target);
+            numberOfJourneys += algorithm->getJourneys().size();
+            const double latency = timer.elapsedMicroseconds();
+            if (updatesStarted > finishedUpdates) {
+                latencyDuringUpdates.add(latency);
+            } else {
+                latencyBetweenUpdates.add(latency);
+            }
+            maxLiveVersions = std::max(maxLiveVersions, queryDataVersions.getNumberOfLiveVersions());
+            progress++;
+        }
+        queriesFinished = true;
+        updateThread.join();
+        progress.finished();
+
+        std::cout << "Applied updates: " << String::prettyInt(updatesFinished.load()) << std::endl;
+        std::cout << "Published versions: " << String::prettyInt(queryDataVersions.getNumberOfPublishedVersions() - initialVersions) << std::endl;
+        std::cout << "Versions used by queries: " << String::prettyInt(usedVersions) << std::endl;
+        std::cout << "Max. live versions: " << String::prettyInt(maxLiveVersions) << std::endl;
+        std::cout << "Avg. journeys: " << String::prettyDouble(numberOfJourneys / static_cast<double>(queries.size())) << std::endl;
+        Histogram::printHeader("Statistic");
+        latencyBetweenUpdates.print("Latency between updates", true);
+        latencyDuringUpdates.print("Latency during updates", true);
+        updateTime.print("Update time", true);
+    }
 };
@@ -10,6 +10,10 @@
 #include "../../DataStructures/RAPTOR/MultimodalData.h"
 #include "../../DataStructures/TripBased/MultimodalData.h"
 
+#include "../../Helpers/Helpers.h"
+#include "../../Helpers/MultiThreading.h"
+#include "../../Helpers/Timer.h"
+
 #include "../../Shell/Shell.h"
 
 using namespace Shell;
@@ -21,15 +25,28 @@ public:
         ParameterizedCommand(shell, "parseGTFS", "Parses raw GTFS data from the given directory and converts it to a binary representation.") {
         addParameter("Input directory");
         addParameter("Output file");
+        addParameter("Number of threads", "max");
     }
 
     virtual void execute() noexcept {
         const std::string gtfsDirectory = getParameter("Input directory");
         const std::string outputFile = getParameter("Output file");
 
-        GTFS::Data data = GTFS::Data::FromGTFS(gtfsDirectory);
+        Timer timer;
+        GTFS::Data data = GTFS::Data::FromGTFS(gtfsDirectory, true, getNumberOfThreads());
         data.printInfo();
         data.serialize(outputFile);
+        std::cout << "Total time: " << String::msToString(timer.elapsedMilliseconds()) << std::endl;
+        std::cout << "Peak memory usage: " << String::bytesToString(peakMemoryUsage()) << std::endl;
+    }
+
+private:
+    inline size_t getNumberOfThreads() const noexcept {
+        if (getParameter("Number of threads") == "max") {
+            return numberOfCores();
+        } else {
+            return getParameter<int>("Number of threads");
+        }
     }
 
 };
@@ -55,11 +72,14 @@ public:
         const bool useDaysOfOperation = getParameter<bool>("Use days of operation?");
         const bool useFrequencies = getParameter<bool>("Use frequencies?");
 
+        Timer timer;
         GTFS::Data gtfs = GTFS::Data::FromBinary(gtfsDirectory);
         gtfs.printInfo();
         Intermediate::Data inter = Intermediate::Data::FromGTFS(gtfs, firstDay, lastDay, !useDaysOfOperation, !useFrequencies);
         inter.printInfo();
         inter.serialize(outputFile);
+        std::cout << "Total time: " << String::msToString(timer.elapsedMilliseconds()) << std::endl;
+        std::cout << "Peak memory usage: " << String::bytesToString(peakMemoryUsage()) << std::endl;
     }
 
 };
@@ -11,6 +11,7 @@
 #include "../../DataStructures/RAPTOR/Data.h"
 
 #include "../../Helpers/HighlightText.h"
+#include "../../Helpers/MultiThreading.h"
 
 #include "../../Shell/Shell.h"
 
@@ -326,6 +327,7 @@ public:
         addParameter("Max travel time");
         addParameter("Output file");
         addParameter("Build transitive closure?", "false");
+        addParameter("Number of threads", "max");
     }
 
     virtual void execute() noexcept {
@@ -333,18 +335,28 @@ public:
         const int maxTravelTime = getParameter<int>("Max travel time");
         const std::string outputFile = getParameter("Output file");
         const bool buildTransitiveClosure = getParameter<bool>("Build transitive closure?");
+        const size_t numberOfThreads = getNumberOfThreads();
 
         Intermediate::Data inter = Intermediate::Data::FromBinary(intermediateFile);
         inter.printInfo();
-        inter.makeDirectTransfers(maxTravelTime, true);
+        inter.makeDirectTransfers(maxTravelTime, true, numberOfThreads);
         inter.printInfo();
         if (buildTransitiveClosure) {
-            inter.makeDirectTransfers(8640000, true);
+            inter.makeDirectTransfers(8640000, true, numberOfThreads);
             inter.printInfo();
         }
         inter.serialize(outputFile);
     }
 
+private:
+    inline size_t getNumberOfThreads() const noexcept {
+        if (getParameter("Number of threads") == "max") {
+            return numberOfCores();
+        } else {
+            return getParameter<int>("Number of threads");
+        }
+    }
+
 };
 
 class MakeOneHopTransfersByGeoDistance : public ParameterizedCommand {
@@ -357,6 +369,7 @@ public:
         addParameter("Speed in km/h");
         addParameter("Output file");
         addParameter("Build transitive closure?", "false");
+        addParameter("Number of threads", "max");
     }
 
     virtual void execute() noexcept {
@@ -365,18 +378,28 @@ public:
         const double speed = getParameter<double>("Speed in km/h");
         const std::string outputFile = getParameter("Output file");
         const bool buildTransitiveClosure = getParameter<bool>("Build transitive closure?");
+        const size_t numberOfThreads = getNumberOfThreads();
 
         Intermediate::Data inter = Intermediate::Data::FromBinary(intermediateFile);
         inter.printInfo();
-        inter.makeDirectTransfersByGeoDistance(maxDistance, speed, true);
+        inter.makeDirectTransfersByGeoDistance(maxDistance, speed, true, numberOfThreads);
         inter.printInfo();
         if (buildTransitiveClosure) {
-            inter.makeDirectTransfers(8640000, true);
+            inter.makeDirectTransfers(8640000, true, numberOfThreads);
             inter.printInfo();
         }
         inter.serialize(outputFile);
     }
 
+private:
+    inline size_t getNumberOfThreads() const noexcept {
+        if (getParameter("Number of threads") == "max") {
+            return numberOfCores();
+        } else {
+            return getParameter<int>("Number of threads");
+        }
+    }
+
 };
 
 class ApplyMaxTransferSpeed : public ParameterizedCommand {
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <type_traits>
+
+#include <omp.h>
+
+#include "../../Helpers/MultiThreading.h"
+#include "../../Helpers/Histogram.h"
+#include "../../Helpers/IO/File.h"
+#include "../../Helpers/String/String.h"
+#include "../../Helpers/Timer.h"
+#include "../../Helpers/Vector/Vector.h"
+
+#include "../../Shell/Shell.h"
+using namespace Shell;
+
+struct ParallelQueryResult {
+    size_t numberOfThreads;
+    double wallTime;
+    double numJourneys;
+};
+
+// Runs a query set on one algorithm instance per thread. The input data is shared read-only between the threads.
+// MAKE_ALGORITHM is called once per thread and must return a new algorithm instance.
+// RUN_QUERY runs a single query on the given instance and returns the number of journeys found (or nothing).
+template<typename QUERY, typename MAKE_ALGORITHM, typename RUN_QUERY>
+inline auto runParallelQueries(const std::vector<QUERY>& queries, const MAKE_ALGORITHM& makeAlgorithm, const RUN_QUERY& runQuery, const ThreadPinning& threadPinning, ParallelQueryResult& result) noexcept {
+    using Algorithm = decltype(makeAlgorithm());
+    using Profiler = std::decay_t<decltype(std::declval<Algorithm&>().getProfiler())>;
+    static constexpr bool CountJourneys = !std::is_void_v<decltype(runQuery(std::declval<Algorithm&>(), std::declval<const QUERY&>()))>;
+
+    const size_t numberOfThreads = threadPinning.numberOfThreads;
+    std::vector<Profiler> profilers(numberOfThreads);
+    std::vector<double> numJourneys(numberOfThreads, 0);
+    Timer timer;
+    double wallTime = 0;
+
+    omp_set_num_threads(numberOfThreads);
+    #pragma omp parallel
+    {
+        threadPinning.pinThread();
+        const size_t threadId = omp_get_thread_num();
+        Algorithm algorithm = makeAlgorithm();
+        double threadJourneys = 0;
+
+        #pragma omp barrier
+        #pragma omp single
+        timer.restart();
+
+        #pragma omp for schedule(dynamic)
+        for (size_t i = 0; i < queries.size(); i++) {
+            if constexpr (CountJourneys) {
+                threadJourneys += runQuery(algorithm, queries[i]);
+            } else {
+                runQuery(algorithm, queries[i]);
+            }
+        }
+
+        #pragma omp single
+        wallTime = timer.elapsedMicroseconds();
+
+        numJourneys[threadId] = threadJourneys;
+        profilers[threadId] = algorithm.getProfiler();
+    }
+
+    Profiler profiler = profilers[0];
+    for (size_t i = 1; i < numberOfThreads; i++) {
+        profiler += profilers[i];
+    }
+    result.numberOfThreads = numberOfThreads;
+    result.wallTime = wallTime;
+    result.numJourneys = CountJourneys ? Vector::sum(numJourneys) : -1;
+    return profiler;
+}
+
+class ParallelQueryCommand : public ParameterizedCommand {
+
+public:
+    template<typename... T>
+    ParallelQueryCommand(BasicShell& shell, const T&... description) :
+        ParameterizedCommand(shell, description...) {
+    }
+
+protected:
+    inline void addParallelQueryParameters() noexcept {
+        addParameter("Number of threads", "1");
+        addParameter("Pin multiplier", "1");
+        addParameter("Scaling curve?", "false");
+        addParameter("Statistics file", "");
+    }
+
+    template<typename QUERY, typename MAKE_ALGORITHM, typename RUN_QUERY>
+    inline void runQueries(const std::vector<QUERY>& queries, const MAKE_ALGORITHM& makeAlgorithm, const RUN_QUERY& runQuery) const noexcept {
+        const size_t maxThreads = getNumberOfThreads();
+        const size_t pinMultiplier = getParameter<size_t>("Pin multiplier");
+        std::vector<size_t> threadCounts;
+        if (getParameter<bool>("Scaling curve?")) {
+            for (size_t threads = 1; threads < maxThreads; threads *= 2) {
+                threadCounts.emplace_back(threads);
+            }
+        }
+
+        std::vector<ParallelQueryResult> results;
+        for (const size_t threads : threadCounts) {
+            results.emplace_back();
+            runParallelQueries(queries, makeAlgorithm, runQuery, ThreadPinning(threads, pinMultiplier), results.back());
+        }
+        results.emplace_back();
+        const auto profiler = runParallelQueries(queries, makeAlgorithm, runQuery, ThreadPinning(maxThreads, pinMultiplier), results.back());
+        profiler.printStatistics();
+        if (results.back().numJourneys >= 0) {
+            std::cout << "Avg. journeys: " << String::prettyDouble(results.back().numJourneys/queries.size()) << std::endl;
+        }
+        printThroughput(results, queries.size());
+
+        const std::string statisticsFile = getParameter("Statistics file");
+        if (statisticsFile.empty()) return;
+        if (String::endsWith(statisticsFile, ".json")) {
+            writeJSON(statisticsFile, profiler, results, queries.size());
+        } else {
+            writeCSV(statisticsFile, profiler, results, queries.size());
+        }
+        std::cout << "Statistics written to " << statisticsFile << std::endl;
+    }
+
+private:
+    inline size_t getNumberOfThreads() const noexcept {
+        if (getParameter("Number of threads") == "max") {
+            return numberOfCores();
+        } else {
+            return getParameter<int>("Number of threads");
+        }
+    }
+
+    inline static void printThroughput(const std::vector<ParallelQueryResult>& results, const size_t numberOfQueries) noexcept {
+        std::cout << std::endl;
+        std::cout << std::setw(10) << "Threads" << std::setw(16) << "Wall time" << std::setw(16) << "Queries/s" << std::setw(12) << "Speedup" << std::endl;
+        for (const ParallelQueryResult& result : results) {
+            std::cout << std::setw(10) << result.numberOfThreads;
+            std::cout << std::setw(16) << String::msToString(result.wallTime / 1000);
+            std::cout << std::setw(16) << String::prettyDouble(queriesPerSecond(result, numberOfQueries), 1);
+            std::cout << std::setw(12) << String::prettyDouble(results.front().wallTime / result.wallTime, 2);
+            std::cout << std::endl;
+        }
+    }
+
+    inline static double queriesPerSecond(const ParallelQueryResult& result, const size_t numberOfQueries) noexcept {
+        return numberOfQueries / (result.wallTime / 1000000.0);
+    }
+
+    // One row per profiler statistic (times in microseconds) for the run with the most threads,
+    // followed by the wall time and throughput of every run.
+    template<typename PROFILER>
+    inline void writeCSV(const std::string& fileName, const PROFILER& profiler, const std::vector<ParallelQueryResult>& results, const size_t numberOfQueries) const noexcept {
+        IO::OFStream file(fileName);
+        file << "command,threads,queries,statistic,unit,mean";
+        for (const double p : Histogram::Percentiles) {
+            file << ",p" << p;
+        }
+        file << ",max\n";
+        const std::string prefix = name() + "," + std::to_string(results.back().numberOfThreads) + "," + std::to_string(numberOfQueries) + ",";
+        profiler.forEachStatistic([&](const std::string& statistic, const bool isTime, const Histogram& histogram) {
+            file << prefix << statistic << "," << (isTime ? "us" : "count") << "," << histogram.mean();
+            for (const double p : Histogram::Percentiles) {
+                file << "," << histogram.percentile(p);
+            }
+            file << "," << histogram.max() << "\n";
+        });
+        for (const ParallelQueryResult& result : results) {
+            const std::string runPrefix = name() + "," + std::to_string(result.numberOfThreads) + "," + std::to_string(numberOfQueries) + ",";
+            const std::string empty(Histogram::NumPercentiles + 1, ',');
+            file << runPrefix << "Wall time,us," << result.wallTime << empty << "\n";
+            file << runPrefix << "Throughput,queries/s," << queriesPerSecond(result, numberOfQueries) << empty << "\n";
+        }
+    }
+
+    template<typename PROFILER>
+    inline void writeJSON(const std::string& fileName, const PROFILER& profiler, const std::vector<ParallelQueryResult>& results, const size_t numberOfQueries) const noexcept {
+        IO::OFStream file(fileName);
+        file << "{\n";
+        file << "  \"command\": \"" << name() << "\",\n";
+        file << "  \"queries\": " << numberOfQueries << ",\n";
+        file << "  \"threads\": " << results.back().numberOfThreads << ",\n";
+        file << "  \"statistics\": [";
+        bool first = true;
+        profiler.forEachStatistic([&](const std::string& statistic, const bool isTime, const Histogram& histogram) {
+            file << (first ? "\n" : ",\n");
+            first = false;
+            file << "    {\"name\": \"" << statistic << "\", \"unit\": \"" << (isTime ? "us" : "count") << "\", \"mean\": " << histogram.mean();
+            for (const double p : Histogram::Percentiles) {
+                file << ", \"p" << p << "\": " << histogram.percentile(p);
+            }
+            file << ", \"max\": " << histogram.max() << "}";
+        });
+        file << "\n  ],\n";
+        file << "  \"throughput\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            file << ((i == 0) ? "\n" : ",\n");
+            file << "    {\"threads\": " << results[i].numberOfThreads << ", \"wallTimeUs\": " << results[i].wallTime << ", \"queriesPerSecond\": " << queriesPerSecond(results[i], numberOfQueries) << "}";
+        }
+        file << "\n  ]\n";
+        file << "}\n";
+    }
+};
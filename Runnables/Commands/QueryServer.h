@@ -0,0 +1,723 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <sstream>
+#include <charconv>
+#include <limits>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../../Shell/Shell.h"
+using namespace Shell;
+
+#include "../../Algorithms/CSA/ULTRACSA.h"
+#include "../../Algorithms/RAPTOR/ULTRARAPTOR.h"
+#include "../../Algorithms/TripBased/Query/Query.h"
+
+#include "../../DataStructures/Queries/Queries.h"
+#include "../../DataStructures/CSA/Data.h"
+#include "../../DataStructures/RAPTOR/Data.h"
+#include "../../DataStructures/TripBased/Data.h"
+
+#include "../../Helpers/Histogram.h"
+#include "../../Helpers/MultiThreading.h"
+#include "../../Helpers/Timer.h"
+#include "../../Helpers/IO/File.h"
+#include "../../Helpers/IO/UnixSocket.h"
+#include "../../Helpers/String/String.h"
+
+// Line protocol of the query server:
+//     request:  <id> <algorithm> <source vertex> <target vertex> <departure time>
+//     response: <id> <number of journeys> [<arrival time> <number of trips>]...
+//     error:    <id> error <message>
+// The algorithm is csa (ULTRA-CSA), raptor (ULTRA-RAPTOR) or tb (ULTRA-TB). Responses on one connection may arrive in
+// a different order than the requests. The line "quit" shuts the server down once all pending requests are answered.
+namespace QueryServer {
+
+enum class Algorithm {
+    CSA,
+    RAPTOR,
+    TB,
+    NumberOfAlgorithms
+};
+
+inline constexpr size_t NumberOfAlgorithms = static_cast<size_t>(Algorithm::NumberOfAlgorithms);
+
+inline const std::string AlgorithmNames[NumberOfAlgorithms] = {"csa", "raptor", "tb"};
+
+inline bool parseAlgorithm(const std::string& name, Algorithm& algorithm) noexcept {
+    for (size_t i = 0; i < NumberOfAlgorithms; i++) {
+        if (name != AlgorithmNames[i]) continue;
+        algorithm = static_cast<Algorithm>(i);
+        return true;
+    }
+    return false;
+}
+
+// A client of the server. The workers append their responses to an output buffer, which the I/O loop writes to the
+// non-blocking output descriptor whenever it accepts more data, so a client that stops reading cannot stall the
+// workers. The connection is finished once the client has closed its side and all responses have been written.
+class Connection {
+
+public:
+    Connection(const int inputDescriptor, const int outputDescriptor, const bool ownsDescriptors) :
+        reader(inputDescriptor),
+        outputDescriptor(outputDescriptor),
+        ownsDescriptors(ownsDescriptors),
+        outputFlags(IO::setNonBlocking(outputDescriptor)),
+        numberOfOpenRequests(0),
+        closed(false) {
+    }
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    ~Connection() {
+        if (ownsDescriptors) {
+            ::close(reader.getFileDescriptor());
+        } else {
+            ::fcntl(outputDescriptor, F_SETFL, outputFlags);
+        }
+    }
+
+    // Called by the I/O loop for every request that is handed to the workers.
+    inline void addRequest() noexcept {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        numberOfOpenRequests++;
+    }
+
+    // Called by the workers with the responses to numberOfResponses requests.
+    inline void write(const std::string& data, const size_t numberOfResponses) noexcept {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        AssertMsg(numberOfOpenRequests >= numberOfResponses, "More responses than requests!");
+        numberOfOpenRequests -= numberOfResponses;
+        if (!closed) output += data;
+    }
+
+    // Writes as much of the buffered output as the output descriptor accepts without blocking.
+    inline void flush() noexcept {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        size_t written = 0;
+        while (!closed && written < output.size()) {
+            const ssize_t bytes = IO::writeSome(outputDescriptor, output.data() + written, output.size() - written);
+            if (bytes < 0) closed = true;
+            if (bytes <= 0) break;
+            written += bytes;
+        }
+        if (closed) {
+            output.clear();
+        } else {
+            output.erase(0, written);
+        }
+    }
+
+    inline size_t bufferedOutput() const noexcept {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        return output.size();
+    }
+
+    // A client with too many open requests or buffered responses is not read from until it catches up.
+    inline bool isBusy(const size_t maxOpenRequests, const size_t maxBufferedOutput) const noexcept {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        return numberOfOpenRequests >= maxOpenRequests || output.size() >= maxBufferedOutput;
+    }
+
+    inline bool isFinished() const noexcept {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        return reader.reachedEndOfFile() && numberOfOpenRequests == 0 && output.empty();
+    }
+
+    inline int getOutputDescriptor() const noexcept {
+        return outputDescriptor;
+    }
+
+public:
+    IO::SocketLineReader reader;
+
+private:
+    int outputDescriptor;
+    bool ownsDescriptors;
+    int outputFlags;
+    mutable std::mutex outputMutex;
+    std::string output;
+    size_t numberOfOpenRequests;
+    bool closed;
+
+};
+
+// Lets the workers wake up the I/O loop once they have buffered responses.
+class WakeUpPipe {
+
+public:
+    WakeUpPipe() {
+        int pipeDescriptors[2];
+        Ensure(::pipe(pipeDescriptors) == 0, "Cannot create pipe: " << std::strerror(errno));
+        readDescriptor = pipeDescriptors[0];
+        writeDescriptor = pipeDescriptors[1];
+        IO::setNonBlocking(readDescriptor);
+        IO::setNonBlocking(writeDescriptor);
+    }
+    WakeUpPipe(const WakeUpPipe&) = delete;
+    WakeUpPipe& operator=(const WakeUpPipe&) = delete;
+
+    ~WakeUpPipe() {
+        ::close(readDescriptor);
+        ::close(writeDescriptor);
+    }
+
+    // If the pipe is full, the I/O loop will wake up anyway.
+    inline void notify() noexcept {
+        const char signal = 0;
+        [[maybe_unused]] const ssize_t written = ::write(writeDescriptor, &signal, 1);
+    }
+
+    inline void clear() noexcept {
+        char data[256];
+        while (::read(readDescriptor, data, sizeof(data)) > 0);
+    }
+
+    inline int getReadDescriptor() const noexcept {
+        return readDescriptor;
+    }
+
+private:
+    int readDescriptor;
+    int writeDescriptor;
+
+};
+
+struct Request {
+    Request(const std::shared_ptr<Connection>& connection = nullptr) :
+        connection(connection),
+        algorithm(Algorithm::RAPTOR),
+        source(noVertex),
+        target(noVertex),
+        departureTime(never) {
+    }
+
+    std::shared_ptr<Connection> connection;
+    std::string id;
+    Algorithm algorithm;
+    Vertex source;
+    Vertex target;
+    int departureTime;
+    std::string error;
+};
+
+// Batches of requests waiting for a worker. Each worker takes a whole batch at once.
+class BatchQueue {
+
+public:
+    BatchQueue() : closed(false) {}
+
+    inline void push(std::vector<Request>&& batch) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batches.emplace_back(std::move(batch));
+        }
+        condition.notify_one();
+    }
+
+    // Blocks until a batch is available. Returns false once the queue has been closed and is empty.
+    inline bool pop(std::vector<Request>& batch) noexcept {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return closed || !batches.empty(); });
+        if (batches.empty()) return false;
+        batch = std::move(batches.front());
+        batches.pop_front();
+        return true;
+    }
+
+    inline void close() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        condition.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::vector<Request>> batches;
+    bool closed;
+
+};
+
+// The data is loaded once and shared read-only by all workers. Data that was not loaded is nullptr.
+struct Network {
+    std::unique_ptr<CH::CH> ch;
+    std::unique_ptr<CSA::Data> csaData;
+    std::unique_ptr<RAPTOR::Data> raptorData;
+    std::unique_ptr<TripBased::Data> tripBasedData;
+
+    inline bool hasAlgorithm(const Algorithm algorithm) const noexcept {
+        switch (algorithm) {
+            case Algorithm::CSA: return csaData != nullptr;
+            case Algorithm::RAPTOR: return raptorData != nullptr;
+            case Algorithm::TB: return tripBasedData != nullptr;
+            default: return false;
+        }
+    }
+};
+
+// Algorithm instances of one worker thread.
+class Worker {
+
+public:
+    Worker(const Network& network) :
+        numberOfQueries(NumberOfAlgorithms, 0) {
+        if (network.csaData) csa = std::make_unique<CSA::ULTRACSA<true>>(*network.csaData, *network.ch);
+        if (network.raptorData) raptor = std::make_unique<RAPTOR::ULTRARAPTOR<>>(*network.raptorData, *network.ch);
+        if (network.tripBasedData) tripBased = std::make_unique<TripBased::Query<>>(*network.tripBasedData, *network.ch);
+    }
+
+    // Answers the batch and buffers the responses, one write per run of requests from the same connection.
+    inline void run(const std::vector<Request>& batch) noexcept {
+        std::string responses;
+        size_t numberOfResponses = 0;
+        for (size_t i = 0; i < batch.size(); i++) {
+            answer(batch[i], responses);
+            numberOfResponses++;
+            if (i + 1 == batch.size() || batch[i + 1].connection != batch[i].connection) {
+                batch[i].connection->write(responses, numberOfResponses);
+                responses.clear();
+                numberOfResponses = 0;
+            }
+        }
+    }
+
+    inline const std::vector<size_t>& getNumberOfQueries() const noexcept {
+        return numberOfQueries;
+    }
+
+private:
+    inline void answer(const Request& request, std::string& responses) noexcept {
+        responses += request.id;
+        if (!request.error.empty()) {
+            responses += " error " + request.error + "\n";
+            return;
+        }
+        numberOfQueries[static_cast<size_t>(request.algorithm)]++;
+        switch (request.algorithm) {
+            case Algorithm::CSA: {
+                csa->run(request.source, request.departureTime, request.target);
+                if (csa->reachable(request.target)) {
+                    size_t numberOfTrips = 0;
+                    for (const CSA::JourneyLeg& leg : csa->getJourney(request.target)) {
+                        if (leg.usesTrip) numberOfTrips++;
+                    }
+                    responses += " 1 " + std::to_string(csa->getEarliestArrivalTime(request.target)) + " " + std::to_string(numberOfTrips);
+                } else {
+                    responses += " 0";
+                }
+                break;
+            }
+            case Algorithm::RAPTOR: {
+                raptor->run(request.source, request.departureTime, request.target);
+                appendArrivals(raptor->getArrivals(), responses);
+                break;
+            }
+            case Algorithm::TB: {
+                tripBased->run(request.source, request.departureTime, request.target);
+                appendArrivals(tripBased->getArrivals(), responses);
+                break;
+            }
+            default: break;
+        }
+        responses += "\n";
+    }
+
+    inline static void appendArrivals(const std::vector<RAPTOR::ArrivalLabel>& arrivals, std::string& responses) noexcept {
+        responses += " " + std::to_string(arrivals.size());
+        for (const RAPTOR::ArrivalLabel& arrival : arrivals) {
+            responses += " " + std::to_string(arrival.arrivalTime) + " " + std::to_string(arrival.numberOfTrips);
+        }
+    }
+
+private:
+    std::unique_ptr<CSA::ULTRACSA<true>> csa;
+    std::unique_ptr<RAPTOR::ULTRARAPTOR<>> raptor;
+    std::unique_ptr<TripBased::Query<>> tripBased;
+
+    std::vector<size_t> numberOfQueries;
+
+};
+
+inline std::vector<std::string> tokenize(const std::string& line) noexcept {
+    std::vector<std::string> tokens;
+    std::istringstream stream(line);
+    std::string token;
+    while (stream >> token) {
+        tokens.emplace_back(token);
+    }
+    return tokens;
+}
+
+// Accepts only a complete decimal number within [0, maxValue].
+inline bool parseNumber(const std::string& token, const int64_t maxValue, int64_t& value) noexcept {
+    const char* end = token.data() + token.size();
+    const std::from_chars_result result = std::from_chars(token.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end && value >= 0 && value <= maxValue;
+}
+
+inline Request parseRequest(const std::string& line, const std::shared_ptr<Connection>& connection, const Network& network) noexcept {
+    Request request(connection);
+    const std::vector<std::string> tokens = tokenize(line);
+    request.id = tokens.empty() ? "" : tokens[0];
+    Algorithm algorithm;
+    if (tokens.size() != 5) {
+        request.error = "expected <id> <algorithm> <source> <target> <departure time>";
+    } else if (!parseAlgorithm(tokens[1], algorithm)) {
+        request.error = "unknown algorithm " + tokens[1];
+    } else if (!network.hasAlgorithm(algorithm)) {
+        request.error = "no data loaded for algorithm " + tokens[1];
+    } else {
+        int64_t source;
+        int64_t target;
+        int64_t departureTime;
+        const int64_t maxVertex = int64_t(network.ch->numVertices()) - 1;
+        if (!parseNumber(tokens[2], maxVertex, source)) {
+            request.error = "invalid source vertex " + tokens[2];
+        } else if (!parseNumber(tokens[3], maxVertex, target)) {
+            request.error = "invalid target vertex " + tokens[3];
+        } else if (!parseNumber(tokens[4], std::numeric_limits<int>::max(), departureTime)) {
+            request.error = "invalid departure time " + tokens[4];
+        } else {
+            request.algorithm = algorithm;
+            request.source = Vertex(source);
+            request.target = Vertex(target);
+            request.departureTime = departureTime;
+        }
+    }
+    return request;
+}
+
+}
+
+class RunQueryServer : public ParameterizedCommand {
+
+public:
+    RunQueryServer(BasicShell& shell) :
+        ParameterizedCommand(shell, "runQueryServer", "Loads the networks once and answers ULTRA-CSA/RAPTOR/TB queries from a Unix socket (or from stdin if the socket is \"-\", terminating the application at the end of the input) on a pool of worker threads.") {
+        addParameter("CH data");
+        addParameter("Socket");
+        addParameter("RAPTOR input file", "-");
+        addParameter("CSA input file", "-");
+        addParameter("Trip-Based input file", "-");
+        addParameter("Number of threads", "max");
+        addParameter("Pin multiplier", "1");
+        addParameter("Batch size", "64");
+    }
+
+    virtual void execute() noexcept {
+        QueryServer::Network network;
+        loadNetwork(network);
+
+        const size_t numberOfThreads = getNumberOfThreads();
+        const size_t pinMultiplier = getParameter<size_t>("Pin multiplier");
+        const size_t batchSize = std::max<size_t>(getParameter<size_t>("Batch size"), 1);
+        const std::string socketPath = getParameter("Socket");
+        const bool useStandardInput = (socketPath == "-");
+
+        QueryServer::BatchQueue queue;
+        QueryServer::WakeUpPipe wakeUp;
+        std::vector<std::vector<size_t>> numberOfQueries(numberOfThreads);
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < numberOfThreads; i++) {
+            workers.emplace_back([&, i]() {
+                pinThreadToCoreId((i * pinMultiplier) % numberOfCores());
+                QueryServer::Worker worker(network);
+                std::vector<QueryServer::Request> batch;
+                while (queue.pop(batch)) {
+                    worker.run(batch);
+                    wakeUp.notify();
+                }
+                numberOfQueries[i] = worker.getNumberOfQueries();
+            });
+        }
+
+        std::vector<std::shared_ptr<QueryServer::Connection>> connections;
+        int listenDescriptor = -1;
+        if (useStandardInput) {
+            // Nothing else may be written to stdout while it is non-blocking.
+            std::cout << "Reading queries from stdin with " << numberOfThreads << " worker threads" << std::endl;
+            connections.emplace_back(std::make_shared<QueryServer::Connection>(STDIN_FILENO, STDOUT_FILENO, false));
+        } else {
+            listenDescriptor = IO::listenUnixSocket(socketPath);
+            std::cout << "Listening on " << socketPath << " with " << numberOfThreads << " worker threads" << std::endl;
+        }
+
+        Timer timer;
+        size_t numberOfBatches = 0;
+        std::vector<QueryServer::Request> pending;
+        std::vector<std::string> lines;
+        std::vector<pollfd> descriptors;
+        bool running = true;
+        while (running) {
+            // Per connection, one entry for the input and one for the output. Entries with a negative descriptor are
+            // ignored.
+            descriptors.clear();
+            for (const std::shared_ptr<QueryServer::Connection>& connection : connections) {
+                const bool readInput = !connection->reader.reachedEndOfFile() && !connection->isBusy(MaxOpenRequests, MaxBufferedOutput);
+                descriptors.push_back(pollfd{readInput ? connection->reader.getFileDescriptor() : -1, POLLIN, 0});
+                descriptors.push_back(pollfd{(connection->bufferedOutput() > 0) ? connection->getOutputDescriptor() : -1, POLLOUT, 0});
+            }
+            descriptors.push_back(pollfd{wakeUp.getReadDescriptor(), POLLIN, 0});
+            if (listenDescriptor != -1) descriptors.push_back(pollfd{listenDescriptor, POLLIN, 0});
+            if (::poll(descriptors.data(), descriptors.size(), -1) < 0) continue;
+
+            if (descriptors[2 * connections.size()].revents != 0) wakeUp.clear();
+            for (size_t i = 0; i < connections.size(); i++) {
+                connections[i]->flush();
+                if (descriptors[2 * i].revents == 0) continue;
+                lines.clear();
+                connections[i]->reader.readLines(lines);
+                for (const std::string& line : lines) {
+                    const std::vector<std::string> tokens = QueryServer::tokenize(line);
+                    if (tokens.empty()) continue;
+                    if (tokens.size() == 1 && tokens[0] == "quit") {
+                        running = false;
+                        break;
+                    }
+                    connections[i]->addRequest();
+                    pending.emplace_back(QueryServer::parseRequest(line, connections[i], network));
+                }
+            }
+            if (listenDescriptor != -1 && descriptors.back().revents != 0) {
+                const int clientDescriptor = ::accept(listenDescriptor, nullptr, nullptr);
+                if (clientDescriptor != -1) connections.emplace_back(std::make_shared<QueryServer::Connection>(clientDescriptor, clientDescriptor, true));
+            }
+            for (size_t i = 0; i < connections.size(); i++) {
+                if (!connections[i]->isFinished()) continue;
+                connections[i] = connections.back();
+                connections.pop_back();
+                i--;
+            }
+            if (useStandardInput && connections.empty()) running = false;
+
+            for (size_t begin = 0; begin < pending.size(); begin += batchSize) {
+                const size_t end = std::min(begin + batchSize, pending.size());
+                queue.push(std::vector<QueryServer::Request>(std::make_move_iterator(pending.begin() + begin), std::make_move_iterator(pending.begin() + end)));
+                numberOfBatches++;
+            }
+            pending.clear();
+        }
+
+        queue.close();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        flushConnections(connections);
+        const double wallTime = timer.elapsedMilliseconds();
+        if (listenDescriptor != -1) {
+            ::close(listenDescriptor);
+            ::unlink(socketPath.c_str());
+        }
+        connections.clear();
+
+        size_t totalQueries = 0;
+        std::cout << std::endl;
+        for (size_t algorithm = 0; algorithm < QueryServer::NumberOfAlgorithms; algorithm++) {
+            size_t count = 0;
+            for (const std::vector<size_t>& workerCount : numberOfQueries) {
+                count += workerCount[algorithm];
+            }
+            if (count == 0) continue;
+            std::cout << "Answered " << String::prettyInt(count) << " " << QueryServer::AlgorithmNames[algorithm] << " queries" << std::endl;
+            totalQueries += count;
+        }
+        std::cout << "Answered " << String::prettyInt(totalQueries) << " queries in " << String::prettyInt(numberOfBatches) << " batches within " << String::msToString(wallTime) << std::endl;
+        // The server has consumed stdin, so no further shell commands can be read.
+        if (useStandardInput) shell.stop();
+    }
+
+private:
+    // Writes the remaining responses, giving up on clients that do not read for ShutdownTimeout milliseconds.
+    inline static void flushConnections(const std::vector<std::shared_ptr<QueryServer::Connection>>& connections) noexcept {
+        std::vector<pollfd> descriptors;
+        while (true) {
+            descriptors.clear();
+            for (const std::shared_ptr<QueryServer::Connection>& connection : connections) {
+                connection->flush();
+                if (connection->bufferedOutput() == 0) continue;
+                descriptors.push_back(pollfd{connection->getOutputDescriptor(), POLLOUT, 0});
+            }
+            if (descriptors.empty() || ::poll(descriptors.data(), descriptors.size(), ShutdownTimeout) == 0) return;
+        }
+    }
+
+    inline size_t getNumberOfThreads() const noexcept {
+        if (getParameter("Number of threads") == "max") {
+            return numberOfCores();
+        } else {
+            return getParameter<int>("Number of threads");
+        }
+    }
+
+    inline void loadNetwork(QueryServer::Network& network) const noexcept {
+        network.ch = std::make_unique<CH::CH>(getParameter("CH data"));
+        if (getParameter("RAPTOR input file") != "-") {
+            network.raptorData = std::make_unique<RAPTOR::Data>(RAPTOR::Data::FromBinary(getParameter("RAPTOR input file")));
+            network.raptorData->useImplicitDepartureBufferTimes();
+            network.raptorData->printInfo();
+        }
+        if (getParameter("CSA input file") != "-") {
+            network.csaData = std::make_unique<CSA::Data>(CSA::Data::FromBinary(getParameter("CSA input file")));
+            network.csaData->sortConnectionsAscending();
+            network.csaData->printInfo();
+        }
+        if (getParameter("Trip-Based input file") != "-") {
+            network.tripBasedData = std::make_unique<TripBased::Data>(getParameter("Trip-Based input file"));
+            network.tripBasedData->printInfo();
+        }
+    }
+
+private:
+    inline static constexpr size_t MaxOpenRequests = 4096;
+    inline static constexpr size_t MaxBufferedOutput = 1 << 20;
+    inline static constexpr int ShutdownTimeout = 1000;
+};
+
+class GenerateServerQueries : public ParameterizedCommand {
+
+public:
+    GenerateServerQueries(BasicShell& shell) :
+        ParameterizedCommand(shell, "generateServerQueries", "Writes random vertex-to-vertex queries in the request format of runQueryServer (without ids).") {
+        addParameter("CH data");
+        addParameter("Output file");
+        addParameter("Number of queries");
+        addParameter("Algorithms", "raptor");
+    }
+
+    virtual void execute() noexcept {
+        const CH::CH ch(getParameter("CH data"));
+        const std::vector<std::string> algorithms = String::split(getParameter("Algorithms"), ',');
+        for (const std::string& name : algorithms) {
+            QueryServer::Algorithm algorithm;
+            if (!QueryServer::parseAlgorithm(name, algorithm)) {
+                shell.error("Unknown algorithm: ", name);
+                return;
+            }
+        }
+        const size_t n = getParameter<size_t>("Number of queries");
+        const std::vector<VertexQuery> queries = generateRandomVertexQueries(ch.numVertices(), n);
+        IO::OFStream file(getParameter("Output file"));
+        for (size_t i = 0; i < queries.size(); i++) {
+            file << algorithms[i % algorithms.size()] << " " << queries[i].source << " " << queries[i].target << " " << queries[i].departureTime << "\n";
+        }
+        std::cout << "Wrote " << String::prettyInt(queries.size()) << " queries" << std::endl;
+    }
+};
+
+class RunQueryLoadGenerator : public ParameterizedCommand {
+
+public:
+    RunQueryLoadGenerator(BasicShell& shell) :
+        ParameterizedCommand(shell, "runQueryLoadGenerator", "Replays a query file against runQueryServer and reports throughput and latency.") {
+        addParameter("Socket");
+        addParameter("Query file");
+        addParameter("Number of connections", "1");
+        addParameter("Requests in flight per connection", "16");
+        addParameter("Repetitions", "1");
+    }
+
+    virtual void execute() noexcept {
+        const std::vector<std::string> queries = readQueries(getParameter("Query file"));
+        if (queries.empty()) {
+            shell.error("The query file contains no queries!");
+            return;
+        }
+        const std::string socketPath = getParameter("Socket");
+        const size_t numberOfConnections = std::max<size_t>(getParameter<size_t>("Number of connections"), 1);
+        const size_t window = std::max<size_t>(getParameter<size_t>("Requests in flight per connection"), 1);
+        const size_t numberOfRequests = queries.size() * std::max<size_t>(getParameter<size_t>("Repetitions"), 1);
+
+        std::vector<Histogram> latencies(numberOfConnections, Histogram(Histogram::TimeResolution));
+        std::vector<size_t> numberOfErrors(numberOfConnections, 0);
+        std::vector<double> numberOfJourneys(numberOfConnections, 0);
+        std::vector<std::thread> clients;
+        Timer timer;
+        for (size_t c = 0; c < numberOfConnections; c++) {
+            clients.emplace_back([&, c]() {
+                const int socketDescriptor = IO::connectUnixSocket(socketPath);
+                IO::SocketLineReader reader(socketDescriptor);
+                std::vector<double> sendTime;
+                std::vector<size_t> requests;
+                for (size_t i = c; i < numberOfRequests; i += numberOfConnections) {
+                    requests.emplace_back(i);
+                }
+                sendTime.resize(requests.size());
+                Timer clientTimer;
+                size_t sent = 0;
+                size_t received = 0;
+                std::string buffer;
+                std::vector<std::string> lines;
+                while (received < requests.size()) {
+                    buffer.clear();
+                    while (sent < requests.size() && sent - received < window) {
+                        buffer += std::to_string(sent) + " " + queries[requests[sent] % queries.size()] + "\n";
+                        sendTime[sent] = clientTimer.elapsedMicroseconds();
+                        sent++;
+                    }
+                    if (!buffer.empty() && !IO::writeAll(socketDescriptor, buffer)) break;
+                    lines.clear();
+                    if (!reader.readLines(lines) && lines.empty()) break;
+                    const double now = clientTimer.elapsedMicroseconds();
+                    for (const std::string& line : lines) {
+                        const std::vector<std::string> tokens = QueryServer::tokenize(line);
+                        if (tokens.size() < 2) continue;
+                        const size_t id = String::lexicalCast<int>(tokens[0]);
+                        if (id >= sendTime.size()) continue;
+                        latencies[c].add(now - sendTime[id]);
+                        if (tokens[1] == "error") {
+                            numberOfErrors[c]++;
+                        } else {
+                            numberOfJourneys[c] += String::lexicalCast<int>(tokens[1]);
+                        }
+                        received++;
+                    }
+                }
+                ::close(socketDescriptor);
+            });
+        }
+        for (std::thread& client : clients) {
+            client.join();
+        }
+        const double wallTime = timer.elapsedMicroseconds();
+
+        Histogram latency(Histogram::TimeResolution);
+        for (const Histogram& histogram : latencies) {
+            latency += histogram;
+        }
+        const size_t errors = Vector::sum(numberOfErrors);
+        std::cout << "Answered requests: " << String::prettyInt(latency.size()) << " of " << String::prettyInt(numberOfRequests) << " (" << String::prettyInt(errors) << " errors)" << std::endl;
+        std::cout << "Avg. journeys: " << String::prettyDouble(Vector::sum(numberOfJourneys) / std::max<double>(latency.size() - errors, 1)) << std::endl;
+        std::cout << "Wall time: " << String::msToString(wallTime / 1000) << std::endl;
+        std::cout << "Throughput: " << String::prettyDouble(latency.size() / (wallTime / 1000000.0), 1) << " queries/s" << std::endl;
+        Histogram::printHeader("Statistic");
+        latency.print("Latency", true);
+    }
+
+private:
+    inline static std::vector<std::string> readQueries(const std::string& fileName) noexcept {
+        std::vector<std::string> queries;
+        IO::IFStream file(fileName);
+        std::string line;
+        while (std::getline(file.getStream(), line)) {
+            const std::vector<std::string> tokens = QueryServer::tokenize(line);
+            if (tokens.empty() || tokens[0][0] == '#') continue;
+            queries.emplace_back(String::join(tokens, " "));
+        }
+        return queries;
+    }
+};
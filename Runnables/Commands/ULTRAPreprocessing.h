@@ -105,6 +105,7 @@ public:
         addParameter("Pin multiplier", "1");
         addParameter("Count optimal candidates?", "false");
         addParameter("Ignore isolated candidates?", "false");
+        addParameter("Profile?", "false");
     }
 
     virtual void execute() noexcept {
@@ -127,13 +128,22 @@ private:
     template<bool COUNT_OPTIMAL_CANDIDATES>
     inline void chooseIgnoreIsolated() const noexcept {
         if (getParameter<bool>("Ignore isolated candidates?")) {
-            run<COUNT_OPTIMAL_CANDIDATES, true>();
+            chooseProfiler<COUNT_OPTIMAL_CANDIDATES, true>();
         } else {
-            run<COUNT_OPTIMAL_CANDIDATES, false>();
+            chooseProfiler<COUNT_OPTIMAL_CANDIDATES, false>();
         }
     }
 
     template<bool COUNT_OPTIMAL_CANDIDATES, bool IGNORE_ISOLATED_CANDIDATES>
+    inline void chooseProfiler() const noexcept {
+        if (getParameter<bool>("Profile?")) {
+            run<COUNT_OPTIMAL_CANDIDATES, IGNORE_ISOLATED_CANDIDATES, RAPTOR::ULTRA::AggregateProfiler>();
+        } else {
+            run<COUNT_OPTIMAL_CANDIDATES, IGNORE_ISOLATED_CANDIDATES, RAPTOR::ULTRA::NoProfiler>();
+        }
+    }
+
+    template<bool COUNT_OPTIMAL_CANDIDATES, bool IGNORE_ISOLATED_CANDIDATES, typename PROFILER>
     inline void run() const noexcept {
         const std::string inputFile = getParameter("Input file");
         const size_t witnessLimit = getParameter<size_t>("Witness limit");
@@ -145,7 +155,7 @@ private:
         data.useImplicitDepartureBufferTimes();
         data.printInfo();
 
-        RAPTOR::ULTRA::Builder<false, COUNT_OPTIMAL_CANDIDATES, IGNORE_ISOLATED_CANDIDATES> shortcutGraphBuilder(data);
+        RAPTOR::ULTRA::Builder<false, COUNT_OPTIMAL_CANDIDATES, IGNORE_ISOLATED_CANDIDATES, PROFILER> shortcutGraphBuilder(data);
         std::cout << "Computing stop-to-stop ULTRA shortcuts (parallel with " << numberOfThreads << " threads)." << std::endl;
         shortcutGraphBuilder.computeShortcuts(ThreadPinning(numberOfThreads, pinMultiplier), witnessLimit);
         Graph::move(std::move(shortcutGraphBuilder.getShortcutGraph()), data.transferGraph);
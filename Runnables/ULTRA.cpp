@@ -4,6 +4,7 @@
 #include "Commands/BenchmarkULTRA.h"
 #include "Commands/BenchmarkMcULTRA.h"
 #include "Commands/BenchmarkMultimodal.h"
+#include "Commands/QueryServer.h"
 
 #include "../Helpers/Console/CommandLineParser.h"
 #include "../Helpers/MultiThreading.h"
@@ -18,6 +19,11 @@ int main(int argc, char** argv) {
     ::Shell::Shell shell;
     new BuildCH(shell);
     new BuildCoreCH(shell);
+    new BuildHubLabels(shell);
+    new CompareCHs(shell);
+    new BuildNestedDissectionOrder(shell);
+    new CustomizeCCH(shell);
+    new CustomizeCoreCCH(shell);
 
     //Preprocessing
     new BuildFreeTransferGraph(shell);
@@ -38,10 +44,16 @@ int main(int argc, char** argv) {
     new RunDijkstraCSAQueries(shell);
     new RunHLCSAQueries(shell);
     new RunULTRACSAQueries(shell);
+    new BenchmarkCSAQueryReset(shell);
+    new RunULTRAProfileCSAQueries(shell);
     new RunTransitiveRAPTORQueries(shell);
+    new ValidateTransitiveRAPTORQueries(shell);
+    new BenchmarkRouteScans(shell);
     new RunDijkstraRAPTORQueries(shell);
     new RunHLRAPTORQueries(shell);
     new RunULTRARAPTORQueries(shell);
+    new RunULTRARAPTORProfileQueries(shell);
+    new ValidateRAPTORProfileQueries(shell);
     new RunTransitiveTBQueries(shell);
     new RunULTRATBQueries(shell);
 
@@ -55,6 +67,7 @@ int main(int argc, char** argv) {
     new RunUBMTBQueries(shell);
     new RunUBMHydRAQueries(shell);
     new ComputeTransferTimeSavings(shell);
+    new BenchmarkParetoBags(shell);
 
     //Multiple transfer modes
     new RunMultimodalMCRQueries(shell);
@@ -62,6 +75,11 @@ int main(int argc, char** argv) {
     new RunMultimodalUBMRAPTORQueries(shell);
     new RunMultimodalUBMHydRAQueries(shell);
 
+    //Query server
+    new RunQueryServer(shell);
+    new GenerateServerQueries(shell);
+    new RunQueryLoadGenerator(shell);
+
     shell.run();
     return 0;
 }
@@ -15,6 +15,7 @@ int main(int argc, char** argv) {
     new RunOneToAllDijkstraCSAQueriesToVertices(shell);
     new RunOneToManyDijkstraCSAQueriesToStops(shell);
     new RunUPCSAQueries(shell);
+    new RunUPCSABatchQueries(shell);
     new RunOneToAllDijkstraRAPTORQueriesToVertices(shell);
     new RunOneToManyDijkstraRAPTORQueriesToStops(shell);
     new RunUPRAPTORQueries(shell);